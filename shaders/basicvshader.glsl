@@ -3,10 +3,14 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec3 aOffset;
 
-layout (std140) uniform Matrices
+layout (std140) uniform Frame
 {
-    mat4 projection;
     mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 frustumPlanes[6];
+    vec4 cameraPosition;
+    vec4 timeResolution;
 };
 
 uniform mat4 model;
@@ -14,5 +18,5 @@ uniform mat4 model;
 void main()
 {
     vec3 pos = aPos * (gl_InstanceID/100.0);
-    gl_Position = projection * view * model * vec4(pos + aOffset, 1.0);
+    gl_Position = viewProjection * model * vec4(pos + aOffset, 1.0);
 }
\ No newline at end of file
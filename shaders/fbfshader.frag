@@ -5,9 +5,14 @@ in vec2 TexCoords;
 
 uniform sampler2D screenTexture;
 
+// Effects are picked with defines (see ShaderFeature), so a variant only
+// samples and computes what it shows. One kernel per pass: POST_BLUR wins over
+// POST_SHARPEN, which wins over POST_EDGE. Grayscale and inversion apply after
+// the kernel, in that order.
+#if defined(POST_BLUR) || defined(POST_SHARPEN) || defined(POST_EDGE)
 const float offset = 1.0/ 300.0;
 
-vec2 offsets[9] = vec2[](
+const vec2 offsets[9] = vec2[](
     vec2(-offset,  offset),     // top-left
     vec2( 0.0f,    offset),     // top-center
     vec2( offset,  offset),     // top-right
@@ -19,46 +24,48 @@ vec2 offsets[9] = vec2[](
     vec2( offset, -offset)      // bottom-right
 );
 
-float kernel[9] = float[]
-(
-    -1, -1, -1,
-    -1,  9, -1,
-    -1, -1, -1
-);
-
-float blurKernel[9] = float[]
+#if defined(POST_BLUR)
+const float kernel[9] = float[]
 (
     1.0 / 16, 2.0 / 16, 1.0 / 16,
     2.0 / 16, 4.0 / 16, 2.0 / 16,
     1.0 / 16, 2.0 / 16, 1.0 / 16
 );
-
-float edgeKernel[9] = float[]
+#elif defined(POST_SHARPEN)
+const float kernel[9] = float[]
+(
+    -1, -1, -1,
+    -1,  9, -1,
+    -1, -1, -1
+);
+#else
+const float kernel[9] = float[]
 (
     1,  1,  1,
     1, -8,  1,
     1,  1,  1
 );
+#endif
+#endif
 
 void main()
 {
-    //inversion:
-    vec4 inversion = vec4(vec3(1.0 - texture(screenTexture, TexCoords)), 1.0);
-    //grayscale:
-    vec4 texColor = texture(screenTexture, TexCoords);
-    float average = 0.2126 * texColor.r + 0.7152 * texColor.g + 0.0722 * texColor.b;
-    vec4 grayscale = vec4(average, average, average, 1.0);
-
-    //sharpen kernel
-    vec3 sampleTex[9];
+#if defined(POST_BLUR) || defined(POST_SHARPEN) || defined(POST_EDGE)
+    vec3 color = vec3(0.0);
     for(int i = 0; i < 9; i++)
     {
-        sampleTex[i] = vec3(texture(screenTexture, TexCoords.st + offsets[i]));
+        color += vec3(texture(screenTexture, TexCoords.st + offsets[i])) * kernel[i];
     }
-    vec3 col = vec3(0.0);
-    for(int i = 0; i < 9; i++)
-    {
-        col += sampleTex[i] * blurKernel[i];
-    }
-    FragColor = texColor;
-}
\ No newline at end of file
+#else
+    vec3 color = vec3(texture(screenTexture, TexCoords));
+#endif
+
+#ifdef POST_GRAYSCALE
+    float average = 0.2126 * color.r + 0.7152 * color.g + 0.0722 * color.b;
+    color = vec3(average);
+#endif
+#ifdef POST_INVERT
+    color = 1.0 - color;
+#endif
+    FragColor = vec4(color, 1.0);
+}
@@ -13,7 +13,15 @@ out vec3 Normal;
 out vec2 TexCoords;
 
 
-uniform float time;
+layout (std140) uniform Frame
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 frustumPlanes[6];
+    vec4 cameraPosition;
+    vec4 timeResolution;
+};
 
 vec3 GetNormal()
 {
@@ -24,7 +32,7 @@ vec3 GetNormal()
 
 vec4 explode(vec4 position, vec3 normal){
     float magnitude = 2.0;
-    vec3 direction = normal * ((sin(time) + 1.0) / 2.0) * magnitude;
+    vec3 direction = normal * ((sin(timeResolution.x) + 1.0) / 2.0) * magnitude;
     return position + vec4(direction, 0.0);
 }
 
@@ -2,10 +2,28 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+#ifdef INSTANCED
+layout (location = 3) in mat4 instanceMatrix;
+#endif
 
+layout (std140) uniform Frame
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 frustumPlanes[6];
+    vec4 cameraPosition;
+    vec4 timeResolution;
+};
+
+#ifndef INSTANCED
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#endif
+#ifdef QUANTIZED_VERTEX
+// positions arrive as normalized shorts in [-1, 1] over the mesh bounds
+uniform vec3 positionScale;
+uniform vec3 positionBias;
+#endif
 
 out VS_OUT {
     vec2 texCoords;
@@ -14,6 +32,16 @@ out VS_OUT {
 
 void main()
 {
+#ifdef QUANTIZED_VERTEX
+    vec3 position = aPos * positionScale + positionBias;
+#else
+    vec3 position = aPos;
+#endif
+#ifdef INSTANCED
+    mat4 world = instanceMatrix;
+#else
+    mat4 world = model;
+#endif
     vs_out.texCoords = aTexCoords;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    gl_Position = viewProjection * world * vec4(position, 1.0);
+}
@@ -0,0 +1,90 @@
+#include "asset_archive.h"
+#include "mapped_io.h"
+
+#include <iostream>
+#include <memory>
+#include <cstring>
+
+// set once by mount before any loader thread starts and only read afterwards
+static std::shared_ptr<MappedFile> archiveFile;
+static const ArchiveHeader *archiveHeader = nullptr;
+static const ArchiveEntry *archiveTable = nullptr;
+static const char *archiveNames = nullptr;
+
+bool AssetArchive::mount(const std::string &path)
+{
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if(!file)
+        return false;
+
+    const unsigned char *data = file -> data();
+    size_t size = file -> size();
+    const ArchiveHeader *header = (const ArchiveHeader*)data;
+    if(size < sizeof(ArchiveHeader) || memcmp(header -> magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header -> version != ARCHIVE_VERSION)
+    {
+        std::cout << "ERROR::ASSET_ARCHIVE::Not an asset archive: " << path << std::endl;
+        return false;
+    }
+    if(header -> tableSize == 0 || (header -> tableSize & (header -> tableSize - 1)) != 0 ||
+       header -> tableOffset + (uint64_t)header -> tableSize * sizeof(ArchiveEntry) > size || header -> namesOffset > size)
+    {
+        std::cout << "ERROR::ASSET_ARCHIVE::Corrupt table of contents: " << path << std::endl;
+        return false;
+    }
+
+    const ArchiveEntry *table = (const ArchiveEntry*)(data + header -> tableOffset);
+    for(uint32_t i = 0; i < header -> tableSize; i++)
+    {
+        if(table[i].hash && (table[i].offset + table[i].size > size || header -> namesOffset + table[i].nameOffset + table[i].nameLength > size))
+        {
+            std::cout << "ERROR::ASSET_ARCHIVE::Entry out of bounds: " << path << std::endl;
+            return false;
+        }
+    }
+
+    archiveFile = file;
+    archiveHeader = header;
+    archiveTable = table;
+    archiveNames = (const char*)(data + header -> namesOffset);
+    return true;
+}
+
+bool AssetArchive::mounted()
+{
+    return archiveHeader != nullptr;
+}
+
+size_t AssetArchive::entryCount()
+{
+    return archiveHeader ? archiveHeader -> entryCount : 0;
+}
+
+bool AssetArchive::find(const std::string &path, const unsigned char *&data, size_t &size)
+{
+    if(!archiveHeader)
+        return false;
+
+    std::string key = archiveKey(path);
+    uint64_t hash = archiveHash(key);
+    uint32_t mask = archiveHeader -> tableSize - 1;
+    for(uint32_t probe = 0; probe <= mask; probe++)
+    {
+        const ArchiveEntry &entry = archiveTable[(hash + probe) & mask];
+        if(entry.hash == 0)
+            return false;
+        if(entry.hash == hash && entry.nameLength == key.size() && memcmp(archiveNames + entry.nameOffset, key.data(), key.size()) == 0)
+        {
+            data = archiveFile -> data() + entry.offset;
+            size = (size_t)entry.size;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetArchive::contains(const std::string &path)
+{
+    const unsigned char *data;
+    size_t size;
+    return find(path, data, size);
+}
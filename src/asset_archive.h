@@ -0,0 +1,83 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include <string>
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+
+// Packed asset archive ("assets.pak", written by tools/assetpack.cpp). All
+// shaders, models and textures live in one file that is memory mapped once
+// at startup; lookups go through a hashed table of contents and return a
+// pointer straight into the mapping. File layout:
+//
+//   ArchiveHeader
+//   ArchiveEntry[tableSize]   open-addressed by archiveHash, hash 0 = empty
+//   entry names               referenced by nameOffset/nameLength
+//   entry data                each entry starts on an ARCHIVE_ALIGNMENT boundary
+//
+// Entries are keyed by archiveKey: the path relative to the working
+// directory the archive was packed from, with '/' separators.
+
+const char ARCHIVE_MAGIC[8] = { 'A', 'S', 'T', 'P', 'A', 'K', '1', '\0' };
+const uint32_t ARCHIVE_VERSION = 1;
+const uint64_t ARCHIVE_ALIGNMENT = 4096;
+
+struct ArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t tableSize;
+    uint32_t reserved;
+    uint64_t tableOffset;
+    uint64_t namesOffset;
+};
+
+struct ArchiveEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
+inline std::string archiveKey(const std::string &path)
+{
+    std::filesystem::path key(path);
+    if(key.is_absolute())
+    {
+        std::error_code error;
+        std::filesystem::path base = std::filesystem::current_path(error);
+        if(!error)
+            key = key.lexically_relative(base);
+    }
+    return key.lexically_normal().generic_string();
+}
+
+inline uint64_t archiveHash(const std::string &key)
+{
+    // FNV-1a, 64 bit; 0 marks an empty table slot
+    uint64_t hash = 14695981039346656037ull;
+    for(size_t i = 0; i < key.size(); i++)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ull;
+    }
+    return hash ? hash : 1;
+}
+
+class AssetArchive
+{
+    public:
+        // maps the archive; returns false and leaves loose files in use if it
+        // is missing or malformed
+        static bool mount(const std::string &path);
+        static bool mounted();
+        static size_t entryCount();
+
+        // data points into the mapping and stays valid for the process lifetime
+        static bool find(const std::string &path, const unsigned char *&data, size_t &size);
+        static bool contains(const std::string &path);
+};
+
+#endif
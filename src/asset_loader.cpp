@@ -0,0 +1,222 @@
+#include "asset_loader.h"
+#include "gl_state.h"
+
+#include <iostream>
+#include <chrono>
+
+AssetLoader::AssetLoader(GLFWwindow *mainWindow) : outstanding(0)
+{
+    // same context version as the main window, but never shown; without a
+    // main window (headless backend) there is no context to share
+    uploadWindow = NULL;
+    if(mainWindow)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        uploadWindow = glfwCreateWindow(1, 1, "AssetLoader", NULL, mainWindow);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    }
+    if(mainWindow && uploadWindow == NULL)
+        std::cout << "ERROR::ASSET_LOADER::Failed to create shared upload context, loading on the render thread" << std::endl;
+
+    workers.reset(new ThreadPool());
+    if(uploadWindow)
+        uploadThread = std::thread(&AssetLoader::uploadLoop, this);
+}
+
+AssetLoader::~AssetLoader()
+{
+    // workers hand loads on to the upload thread, so drain them first
+    workers.reset();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    uploadCondition.notify_all();
+    if(uploadThread.joinable())
+        uploadThread.join();
+    if(uploadWindow)
+        glfwDestroyWindow(uploadWindow);
+
+    // loads still suspended here would never resume, leaking their frames and
+    // the models they hold; they are run to the end on this thread instead,
+    // which also lets a task that is still referenced see them finish. The
+    // upload thread finished its GL work, so every upload fence has signaled.
+    uploadWindow = NULL;
+    while(true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            renderQueue.insert(renderQueue.end(), uploadQueue.begin(), uploadQueue.end());
+            uploadQueue.clear();
+            if(renderQueue.empty() && textureWaits.empty() && modelWaits.empty())
+                break;
+        }
+        TextureCache::instance().finishUploads();
+        poll();
+    }
+}
+
+AssetTask<std::shared_ptr<Model>> AssetLoader::model(std::string path)
+{
+    outstanding++;
+    std::shared_ptr<Model> model = std::make_shared<Model>();
+
+    co_await worker();
+    model -> importMeshes(path);
+    // read the textures here so the upload thread only talks to GL
+    TextureCache::instance().prefetch(model -> texturePaths());
+
+    co_await uploadContext();
+    model -> uploadMeshes();
+    // the fence has to cover the textures too, or the first frames sample empty images
+    co_await texturesResident(model -> textureIds());
+    model -> fenceUploads();
+
+    co_await modelReady(*model);
+    outstanding--;
+    co_return model;
+}
+
+void AssetLoader::poll()
+{
+    std::vector<std::coroutine_handle<>> ready;
+    std::vector<ModelWait> waits;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ready.swap(renderQueue);
+        waits.swap(modelWaits);
+    }
+    if(!uploadWindow)
+        resumeResidentTextures();
+    for(size_t i = 0; i < ready.size(); i++)
+        ready[i].resume();
+
+    std::vector<ModelWait> notReady;
+    for(size_t i = 0; i < waits.size(); i++)
+    {
+        if(waits[i].model -> isReady())
+            waits[i].handle.resume();
+        else
+            notReady.push_back(waits[i]);
+    }
+    if(!notReady.empty())
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        modelWaits.insert(modelWaits.end(), notReady.begin(), notReady.end());
+    }
+}
+
+size_t AssetLoader::pending() const
+{
+    return outstanding;
+}
+
+void AssetLoader::schedule(Queue queue, std::coroutine_handle<> handle)
+{
+    if(queue == QUEUE_WORKER)
+    {
+        if(workers)
+            workers -> enqueue([handle]() { handle.resume(); });
+        else
+            handle.resume();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if(queue == QUEUE_UPLOAD && uploadWindow)
+            uploadQueue.push_back(handle);
+        else
+            renderQueue.push_back(handle);
+    }
+    uploadCondition.notify_all();
+}
+
+bool AssetLoader::TexturesResident::await_ready() const
+{
+    for(size_t i = 0; i < ids.size(); i++)
+    {
+        if(!TextureCache::instance().isResident(ids[i]))
+            return false;
+    }
+    return true;
+}
+
+void AssetLoader::TexturesResident::await_suspend(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> lock(loader -> queueMutex);
+    TextureWait wait;
+    wait.ids = ids;
+    wait.handle = handle;
+    loader -> textureWaits.push_back(wait);
+}
+
+void AssetLoader::ModelReady::await_suspend(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> lock(loader -> queueMutex);
+    ModelWait wait;
+    wait.model = model;
+    wait.handle = handle;
+    loader -> modelWaits.push_back(wait);
+}
+
+void AssetLoader::resumeResidentTextures()
+{
+    std::vector<std::coroutine_handle<>> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for(size_t i = 0; i < textureWaits.size(); )
+        {
+            bool resident = true;
+            for(size_t j = 0; j < textureWaits[i].ids.size() && resident; j++)
+                resident = TextureCache::instance().isResident(textureWaits[i].ids[j]);
+            if(resident)
+            {
+                ready.push_back(textureWaits[i].handle);
+                textureWaits.erase(textureWaits.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+    for(size_t i = 0; i < ready.size(); i++)
+        ready[i].resume();
+}
+
+void AssetLoader::uploadLoop()
+{
+    glfwMakeContextCurrent(uploadWindow);
+
+    while(true)
+    {
+        std::vector<std::coroutine_handle<>> ready;
+        bool stop;
+        {
+            // wake up regularly to push decoded textures even when nothing is queued
+            std::unique_lock<std::mutex> lock(queueMutex);
+            uploadCondition.wait_for(lock, std::chrono::milliseconds(2), [this]() { return stopping || !uploadQueue.empty(); });
+            ready.swap(uploadQueue);
+            stop = stopping;
+        }
+
+        // the render thread deletes textures and vertex arrays in its own
+        // context, which can leave names bound here that GL may hand out again
+        GLState::instance().invalidate();
+        for(size_t i = 0; i < ready.size(); i++)
+            ready[i].resume();
+        TextureCache::instance().processUploads(0);
+        resumeResidentTextures();
+
+        if(stop)
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if(uploadQueue.empty() && textureWaits.empty())
+                break;
+        }
+    }
+
+    glFinish();
+    glfwMakeContextCurrent(NULL);
+}
@@ -0,0 +1,116 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <coroutine>
+
+#include "model.h"
+#include "thread_pool.h"
+#include "asset_task.h"
+
+// Loads assets in the background so the render loop can start right away.
+// Loads are coroutines that hop between three places:
+//
+//   co_await loader.worker()         CPU work on the worker pool
+//   co_await loader.uploadContext()  GL uploads on the upload thread, which
+//                                    owns a hidden window whose context
+//                                    shares objects with the main window
+//   co_await loader.renderThread()   GL work that cannot be shared (VAOs),
+//                                    resumed from poll()
+//
+// plus waits for decoded textures and for a model's upload fence, so a model,
+// its materials and its textures pipeline without blocking any thread:
+//
+//   std::shared_ptr<Model> rock = co_await loader.model("models/rock/rock.obj");
+//
+// The render loop calls poll() once per frame. Without a shared context the
+// upload steps run on the render thread as well.
+//
+// Must be constructed and destroyed on the main thread (GLFW window rules).
+// Destroying it finishes the loads still in flight on that thread.
+class AssetLoader
+{
+    public:
+        AssetLoader(GLFWwindow *mainWindow);
+        ~AssetLoader();
+
+        AssetTask<std::shared_ptr<Model>> model(std::string path);
+        void poll();
+        size_t pending() const;
+
+        enum Queue {
+            QUEUE_WORKER,
+            QUEUE_UPLOAD,
+            QUEUE_RENDER
+        };
+
+        struct Schedule {
+            AssetLoader *loader;
+            Queue queue;
+            bool await_ready() const { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { loader -> schedule(queue, handle); }
+            void await_resume() const {}
+        };
+
+        // resumes on the upload thread once none of the textures waits for decode
+        struct TexturesResident {
+            AssetLoader *loader;
+            std::vector<GLuint> ids;
+            bool await_ready() const;
+            void await_suspend(std::coroutine_handle<> handle);
+            void await_resume() const {}
+        };
+
+        // resumes on the render thread once Model::isReady holds
+        struct ModelReady {
+            AssetLoader *loader;
+            Model *model;
+            bool await_ready() const { return false; }
+            void await_suspend(std::coroutine_handle<> handle);
+            void await_resume() const {}
+        };
+
+        Schedule worker() { return Schedule{this, QUEUE_WORKER}; }
+        Schedule uploadContext() { return Schedule{this, QUEUE_UPLOAD}; }
+        Schedule renderThread() { return Schedule{this, QUEUE_RENDER}; }
+        TexturesResident texturesResident(std::vector<GLuint> ids) { return TexturesResident{this, std::move(ids)}; }
+        ModelReady modelReady(Model &model) { return ModelReady{this, &model}; }
+
+    private:
+        struct TextureWait {
+            std::vector<GLuint> ids;
+            std::coroutine_handle<> handle;
+        };
+
+        struct ModelWait {
+            Model *model;
+            std::coroutine_handle<> handle;
+        };
+
+        std::unique_ptr<ThreadPool> workers;
+        GLFWwindow *uploadWindow;
+        std::thread uploadThread;
+        std::mutex queueMutex;
+        std::condition_variable uploadCondition;
+        std::vector<std::coroutine_handle<>> uploadQueue;
+        std::vector<std::coroutine_handle<>> renderQueue;
+        std::vector<TextureWait> textureWaits;
+        std::vector<ModelWait> modelWaits;
+        bool stopping = false;
+        std::atomic<size_t> outstanding;
+
+        void schedule(Queue queue, std::coroutine_handle<> handle);
+        void resumeResidentTextures();
+        void uploadLoop();
+};
+
+#endif
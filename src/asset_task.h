@@ -0,0 +1,124 @@
+#ifndef ASSET_TASK_H
+#define ASSET_TASK_H
+
+#include <coroutine>
+#include <atomic>
+#include <optional>
+#include <exception>
+#include <utility>
+
+// Coroutine return type for asynchronous asset loads (see AssetLoader). A
+// task starts running as soon as it is created and hops between threads with
+// the loader's awaitables; whoever co_awaits it resumes on the thread that
+// finished it. The render loop can instead poll done() and read result().
+// A task may be awaited at most once.
+
+template<typename T>
+class AssetTask;
+
+template<typename T>
+struct AssetPromiseBase {
+    // 0 while running, 1 once an awaiter is parked, 2 when finished, 3 when
+    // the task object went away first; the side that moves second resumes
+    // the awaiter or frees the frame
+    std::atomic<int> state{0};
+    std::coroutine_handle<> continuation;
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self) noexcept
+        {
+            AssetPromiseBase &promise = self.promise();
+            int previous = promise.state.exchange(2);
+            if(previous == 1)
+                return promise.continuation;
+            if(previous == 3)
+                self.destroy();
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { std::terminate(); }
+};
+
+template<typename T>
+struct AssetPromise : AssetPromiseBase<T> {
+    std::optional<T> value;
+
+    AssetTask<T> get_return_object();
+    void return_value(T result) { value = std::move(result); }
+    T& result() { return *value; }
+};
+
+template<>
+struct AssetPromise<void> : AssetPromiseBase<void> {
+    AssetTask<void> get_return_object();
+    void return_void() {}
+    void result() {}
+};
+
+template<typename T>
+class AssetTask
+{
+    public:
+        using promise_type = AssetPromise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        AssetTask() = default;
+        explicit AssetTask(Handle handle) : handle(handle) {}
+        AssetTask(AssetTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        AssetTask& operator=(AssetTask &&other) noexcept
+        {
+            if(this != &other)
+            {
+                reset();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+        AssetTask(const AssetTask&) = delete;
+        AssetTask& operator=(const AssetTask&) = delete;
+        ~AssetTask() { reset(); }
+
+        bool valid() const { return (bool)handle; }
+        bool done() const { return handle && handle.promise().state.load() == 2; }
+        decltype(auto) result() { return handle.promise().result(); }
+
+        bool await_ready() const { return done(); }
+        bool await_suspend(std::coroutine_handle<> awaiting)
+        {
+            handle.promise().continuation = awaiting;
+            int expected = 0;
+            return handle.promise().state.compare_exchange_strong(expected, 1);
+        }
+        decltype(auto) await_resume() { return handle.promise().result(); }
+
+    private:
+        Handle handle = nullptr;
+
+        // a task still in flight is detached and frees itself when it finishes
+        void reset()
+        {
+            if(handle && handle.promise().state.exchange(3) == 2)
+                handle.destroy();
+            handle = nullptr;
+        }
+};
+
+template<typename T>
+AssetTask<T> AssetPromise<T>::get_return_object()
+{
+    return AssetTask<T>(std::coroutine_handle<AssetPromise<T>>::from_promise(*this));
+}
+
+inline AssetTask<void> AssetPromise<void>::get_return_object()
+{
+    return AssetTask<void>(std::coroutine_handle<AssetPromise<void>>::from_promise(*this));
+}
+
+#endif
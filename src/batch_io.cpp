@@ -0,0 +1,409 @@
+#include "batch_io.h"
+#include "asset_archive.h"
+#include "thread_pool.h"
+#include "texture_cache.h"
+#include "profiler.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// reads larger than this are split, the kernel caps a single read anyway
+static const size_t MAX_READ_SIZE = 1u << 30;
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+#define BATCH_IO_URING
+
+static const unsigned URING_QUEUE_DEPTH = 64;
+
+struct Ring {
+    int fd = -1;
+    unsigned entries = 0;
+    bool singleMap = false;
+    void *sqMap = MAP_FAILED;
+    void *cqMap = MAP_FAILED;
+    size_t sqMapSize = 0;
+    size_t cqMapSize = 0;
+    io_uring_sqe *sqes = (io_uring_sqe*)MAP_FAILED;
+    size_t sqesSize = 0;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    io_uring_cqe *cqes;
+};
+
+static void closeRing(Ring &ring)
+{
+    if(ring.sqes != MAP_FAILED)
+        munmap(ring.sqes, ring.sqesSize);
+    if(ring.cqMap != MAP_FAILED && !ring.singleMap)
+        munmap(ring.cqMap, ring.cqMapSize);
+    if(ring.sqMap != MAP_FAILED)
+        munmap(ring.sqMap, ring.sqMapSize);
+    if(ring.fd >= 0)
+        close(ring.fd);
+    ring.fd = -1;
+}
+
+static bool setupRing(Ring &ring, unsigned entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring.fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if(ring.fd < 0)
+        return false;
+
+    ring.entries = params.sq_entries;
+    ring.sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring.singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if(ring.singleMap)
+        ring.sqMapSize = ring.cqMapSize = std::max(ring.sqMapSize, ring.cqMapSize);
+
+    ring.sqMap = mmap(NULL, ring.sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+    if(ring.sqMap == MAP_FAILED)
+    {
+        closeRing(ring);
+        return false;
+    }
+    ring.cqMap = ring.singleMap ? ring.sqMap : mmap(NULL, ring.cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+    ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring.sqes = (io_uring_sqe*)mmap(NULL, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if(ring.cqMap == MAP_FAILED || ring.sqes == MAP_FAILED)
+    {
+        closeRing(ring);
+        return false;
+    }
+
+    char *sq = (char*)ring.sqMap;
+    char *cq = (char*)ring.cqMap;
+    ring.sqHead = (unsigned*)(sq + params.sq_off.head);
+    ring.sqTail = (unsigned*)(sq + params.sq_off.tail);
+    ring.sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring.sqArray = (unsigned*)(sq + params.sq_off.array);
+    ring.cqHead = (unsigned*)(cq + params.cq_off.head);
+    ring.cqTail = (unsigned*)(cq + params.cq_off.tail);
+    ring.cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring.cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+}
+
+static bool uringAvailable()
+{
+    static const bool available = []() {
+        const char *backend = std::getenv("ASTEROID_IO");
+        if(backend && std::strcmp(backend, "pread") == 0)
+            return false;
+        Ring ring;
+        if(!setupRing(ring, 1))
+            return false;
+        closeRing(ring);
+        return true;
+    }();
+    return available;
+}
+
+// returns false if the ring could not be set up; otherwise indices is left
+// holding the requests it could not finish, with no completion reported
+static bool readBatchUring(std::vector<ReadRequest> &requests, std::vector<size_t> &indices, const std::function<void(size_t)> &onComplete)
+{
+    Ring ring;
+    if(!setupRing(ring, (unsigned)std::min<size_t>(std::max<size_t>(indices.size(), 1), URING_QUEUE_DEPTH)))
+        return false;
+
+    std::vector<int> descriptors(requests.size(), -1);
+    std::vector<size_t> progress(requests.size(), 0);
+    std::vector<int> bufferIndex(requests.size(), -1);
+    std::vector<iovec> buffers;
+    std::deque<size_t> queue;
+    for(size_t i = 0; i < indices.size(); i++)
+    {
+        size_t index = indices[i];
+        ReadRequest &request = requests[index];
+        struct stat status;
+        int descriptor = open(request.path.c_str(), O_RDONLY);
+        if(descriptor < 0 || fstat(descriptor, &status) != 0)
+        {
+            if(descriptor >= 0)
+                close(descriptor);
+            if(onComplete)
+                onComplete(index);
+            continue;
+        }
+        request.bytes.resize((size_t)status.st_size);
+        if(request.bytes.empty())
+        {
+            close(descriptor);
+            request.ok = true;
+            if(onComplete)
+                onComplete(index);
+            continue;
+        }
+        descriptors[index] = descriptor;
+        bufferIndex[index] = (int)buffers.size();
+        iovec buffer;
+        buffer.iov_base = request.bytes.data();
+        buffer.iov_len = request.bytes.size();
+        buffers.push_back(buffer);
+        queue.push_back(index);
+    }
+
+    // registered buffers are pinned once for the whole batch instead of on
+    // every read; RLIMIT_MEMLOCK can refuse that, plain reads still work
+    bool registered = !buffers.empty() && buffers.size() <= 1024 &&
+                      syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, buffers.data(), (unsigned)buffers.size()) == 0;
+
+    // set once an index's read is put in the submission queue, cleared on its completion
+    std::vector<char> inRing(requests.size(), 0);
+    unsigned inFlight = 0;
+    unsigned toSubmit = 0;
+    // io_uring_enter failed for good: completions still arriving finish or
+    // stay unfinished, nothing is queued again
+    bool broken = false;
+
+    auto reap = [&]() {
+        unsigned head = *ring.cqHead;
+        while(head != __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE))
+        {
+            io_uring_cqe &cqe = ring.cqes[head & *ring.cqMask];
+            size_t index = (size_t)cqe.user_data;
+            int result = cqe.res;
+            head++;
+            inFlight--;
+            inRing[index] = 0;
+
+            ReadRequest &request = requests[index];
+            if(result > 0)
+                progress[index] += (size_t)result;
+            // interrupted, or a short read with the rest still to come
+            if(result == -EAGAIN || result == -EINTR || (result > 0 && progress[index] < request.bytes.size()))
+            {
+                if(!broken)
+                    queue.push_back(index);
+                continue;
+            }
+
+            close(descriptors[index]);
+            descriptors[index] = -1;
+            request.ok = result > 0;
+            if(onComplete)
+                onComplete(index);
+        }
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    };
+
+    while(!queue.empty() || inFlight > 0)
+    {
+        unsigned tail = *ring.sqTail;
+        while(!queue.empty() && inFlight + toSubmit < ring.entries)
+        {
+            size_t index = queue.front();
+            queue.pop_front();
+            ReadRequest &request = requests[index];
+            size_t length = std::min(request.bytes.size() - progress[index], MAX_READ_SIZE);
+
+            unsigned slot = tail & *ring.sqMask;
+            io_uring_sqe &sqe = ring.sqes[slot];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = registered ? IORING_OP_READ_FIXED : IORING_OP_READV;
+            sqe.fd = descriptors[index];
+            sqe.off = progress[index];
+            sqe.user_data = index;
+            if(registered)
+            {
+                sqe.addr = (unsigned long long)(request.bytes.data() + progress[index]);
+                sqe.len = (unsigned)length;
+                sqe.buf_index = (unsigned short)bufferIndex[index];
+            }
+            else
+            {
+                iovec &buffer = buffers[bufferIndex[index]];
+                buffer.iov_base = request.bytes.data() + progress[index];
+                buffer.iov_len = length;
+                sqe.addr = (unsigned long long)&buffer;
+                sqe.len = 1;
+            }
+            ring.sqArray[slot] = slot;
+            inRing[index] = 1;
+            tail++;
+            toSubmit++;
+        }
+        __atomic_store_n(ring.sqTail, tail, __ATOMIC_RELEASE);
+
+        int submitted = (int)syscall(__NR_io_uring_enter, ring.fd, toSubmit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if(submitted < 0)
+        {
+            if(errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                continue;
+            broken = true;
+            break;
+        }
+        toSubmit -= (unsigned)submitted;
+        inFlight += (unsigned)submitted;
+        reap();
+    }
+
+    // the kernel keeps writing into the buffers of reads in flight until they
+    // complete, so a broken batch waits for all of them before any buffer is
+    // handed back to the pread fallback
+    bool drained = true;
+    while(broken && inFlight > 0)
+    {
+        if(syscall(__NR_io_uring_enter, ring.fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+           errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            drained = false;
+            break;
+        }
+        reap();
+    }
+
+    if(registered)
+        syscall(__NR_io_uring_register, ring.fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+    closeRing(ring);
+
+    // if the ring broke down mid-batch, hand whatever is left back unfinished
+    indices.clear();
+    for(size_t i = 0; i < descriptors.size(); i++)
+    {
+        if(descriptors[i] < 0)
+            continue;
+        close(descriptors[i]);
+        // could not even wait for it: the read may still land, so its buffer
+        // is leaked rather than freed, and the fallback reads into a new one
+        if(!drained && inRing[i])
+            new std::vector<unsigned char>(std::move(requests[i].bytes));
+        requests[i].bytes.clear();
+        indices.push_back(i);
+    }
+    return true;
+}
+#endif
+
+static bool readWholeFile(ReadRequest &request)
+{
+#ifdef _WIN32
+    return readFileBytes(request.path, request.bytes);
+#else
+    int descriptor = open(request.path.c_str(), O_RDONLY);
+    if(descriptor < 0)
+        return false;
+    struct stat status;
+    if(fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        return false;
+    }
+    request.bytes.resize((size_t)status.st_size);
+    size_t done = 0;
+    while(done < request.bytes.size())
+    {
+        ssize_t result = pread(descriptor, request.bytes.data() + done, std::min(request.bytes.size() - done, MAX_READ_SIZE), (off_t)done);
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result <= 0)
+            break;
+        done += (size_t)result;
+    }
+    close(descriptor);
+    if(done < request.bytes.size())
+    {
+        request.bytes.clear();
+        return false;
+    }
+    return true;
+#endif
+}
+
+static void readBatchThreads(std::vector<ReadRequest> &requests, const std::vector<size_t> &indices, const std::function<void(size_t)> &onComplete)
+{
+    static ThreadPool ioPool;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<size_t> completed;
+    for(size_t i = 0; i < indices.size(); i++)
+    {
+        size_t index = indices[i];
+        ioPool.enqueue([&requests, &mutex, &condition, &completed, index]() {
+            requests[index].ok = readWholeFile(requests[index]);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back(index);
+            }
+            condition.notify_one();
+        });
+    }
+
+    for(size_t done = 0; done < indices.size(); done++)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&completed]() { return !completed.empty(); });
+            index = completed.front();
+            completed.pop_front();
+        }
+        if(onComplete)
+            onComplete(index);
+    }
+}
+
+void readFilesBatch(std::vector<ReadRequest> &requests, const std::function<void(size_t index)> &onComplete)
+{
+    ProfileScope scope("BatchIO::read", std::to_string(requests.size()) + " files via " + batchIOBackend());
+    // counted before the caller gets to move the bytes out
+    std::function<void(size_t)> complete = [&scope, &requests, &onComplete](size_t index) {
+        scope.bytesRead(requests[index].bytes.size());
+        if(onComplete)
+            onComplete(index);
+    };
+    std::vector<size_t> indices;
+    for(size_t i = 0; i < requests.size(); i++)
+    {
+        ReadRequest &request = requests[i];
+        const unsigned char *data;
+        size_t size;
+        if(AssetArchive::find(request.path, data, size))
+        {
+            request.bytes.assign(data, data + size);
+            request.ok = true;
+            complete(i);
+            continue;
+        }
+        request.ok = false;
+        indices.push_back(i);
+    }
+    if(indices.empty())
+        return;
+
+#ifdef BATCH_IO_URING
+    if(uringAvailable() && readBatchUring(requests, indices, complete) && indices.empty())
+        return;
+#endif
+    readBatchThreads(requests, indices, complete);
+}
+
+const char* batchIOBackend()
+{
+#ifdef BATCH_IO_URING
+    if(uringAvailable())
+        return "io_uring";
+#endif
+    return "pread";
+}
@@ -0,0 +1,31 @@
+#ifndef BATCH_IO_H
+#define BATCH_IO_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+// Batched whole-file reads for a load phase. Every request of a batch is in
+// flight at the same time, so cold-cache latency is paid once per batch
+// instead of once per file.
+//
+// On Linux the batch goes through io_uring with the destination buffers
+// registered up front (IORING_OP_READ_FIXED); elsewhere, when the kernel
+// refuses io_uring or ASTEROID_IO=pread is set, a small thread pool issues
+// pread calls instead. Entries of the asset archive are served from its
+// mapping without any I/O.
+struct ReadRequest {
+    std::string path;
+    std::vector<unsigned char> bytes;
+    bool ok = false;
+};
+
+// onComplete runs on the calling thread as each read finishes, in completion
+// order, so decode work can start before the whole batch is in
+void readFilesBatch(std::vector<ReadRequest> &requests, const std::function<void(size_t index)> &onComplete = nullptr);
+
+// "io_uring" or "pread"
+const char* batchIOBackend();
+
+#endif
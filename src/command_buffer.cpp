@@ -0,0 +1,110 @@
+#include "command_buffer.h"
+#include "gl_state.h"
+
+Command& CommandBuffer::push(CommandType type)
+{
+    commands.emplace_back();
+    Command &command = commands.back();
+    command.type = type;
+    command.shader = NULL;
+    command.mesh = NULL;
+    command.target = 0;
+    command.value = 0;
+    return command;
+}
+
+void CommandBuffer::useShader(Shader &shader)
+{
+    push(COMMAND_USE_SHADER).shader = &shader;
+}
+
+void CommandBuffer::setModelMatrix(Shader &shader, const glm::mat4 &matrix)
+{
+    Command &command = push(COMMAND_SET_MODEL);
+    command.shader = &shader;
+    command.matrix = matrix;
+}
+
+void CommandBuffer::drawMesh(Mesh &mesh, GLuint instances)
+{
+    Command &command = push(COMMAND_DRAW_MESH);
+    command.mesh = &mesh;
+    command.value = instances;
+}
+
+void CommandBuffer::enable(GLenum capability)
+{
+    push(COMMAND_ENABLE).target = capability;
+}
+
+void CommandBuffer::disable(GLenum capability)
+{
+    push(COMMAND_DISABLE).target = capability;
+}
+
+void CommandBuffer::bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    Command &command = push(COMMAND_BIND_FRAMEBUFFER);
+    command.target = target;
+    command.value = framebuffer;
+}
+
+void CommandBuffer::clear(GLbitfield mask, const glm::vec4 &color)
+{
+    Command &command = push(COMMAND_CLEAR);
+    command.value = mask;
+    command.color = color;
+}
+
+void CommandExecutor::execute(const CommandBuffer &buffer)
+{
+    GLState &gl = GLState::instance();
+    Shader *shader = NULL;
+    for(size_t i = 0; i < buffer.size(); i++)
+    {
+        const Command &command = buffer[i];
+        switch(command.type)
+        {
+            case COMMAND_USE_SHADER:
+                shader = command.shader;
+                shader -> use();
+                break;
+            case COMMAND_SET_MODEL:
+            {
+                auto uniform = modelUniforms.find(command.shader);
+                if(uniform == modelUniforms.end())
+                    uniform = modelUniforms.emplace(command.shader, command.shader -> uniform<glm::mat4>("model")).first;
+                if(uniform -> second.valid())
+                    command.shader -> set(uniform -> second, command.matrix);
+                break;
+            }
+            case COMMAND_DRAW_MESH:
+                if(!shader)
+                    break;
+                if(command.value)
+                    command.mesh -> DrawInstances(*shader, command.value);
+                else
+                    command.mesh -> Draw(*shader);
+                break;
+            case COMMAND_ENABLE:
+                gl.enable(command.target);
+                break;
+            case COMMAND_DISABLE:
+                gl.disable(command.target);
+                break;
+            case COMMAND_BIND_FRAMEBUFFER:
+                gl.bindFramebuffer(command.target, command.value);
+                break;
+            case COMMAND_CLEAR:
+                glClearColor(command.color.r, command.color.g, command.color.b, command.color.a);
+                glClear(command.value);
+                break;
+        }
+    }
+}
+
+void CommandExecutor::execute(const std::vector<const CommandBuffer*> &buffers)
+{
+    for(size_t i = 0; i < buffers.size(); i++)
+        execute(*buffers[i]);
+}
@@ -0,0 +1,82 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <unordered_map>
+
+#include "shader.h"
+#include "mesh.h"
+
+enum CommandType {
+    COMMAND_USE_SHADER,
+    COMMAND_SET_MODEL,
+    COMMAND_DRAW_MESH,
+    COMMAND_ENABLE,
+    COMMAND_DISABLE,
+    COMMAND_BIND_FRAMEBUFFER,
+    COMMAND_CLEAR
+};
+
+struct Command {
+    CommandType type;
+    Shader *shader;
+    Mesh *mesh;
+    GLenum target;
+    GLuint value;
+    glm::mat4 matrix;
+    glm::vec4 color;
+};
+
+// Draw work recorded as engine-level commands instead of GL calls, so any
+// thread can build a buffer: recording never touches GL, shader uniforms or
+// the GLState cache. One buffer belongs to one recording thread at a time;
+// typically each pass or sector of the scene gets its own buffer on a worker
+// and the render thread replays them in order with a CommandExecutor.
+//
+//   commands.reset();
+//   commands.useShader(shader);
+//   commands.setModelMatrix(shader, transform);
+//   commands.drawMesh(mesh);
+//
+// Recording reuses the buffer's storage, so a warmed-up buffer records a
+// frame without allocating.
+class CommandBuffer
+{
+    public:
+        void reset() { commands.clear(); }
+        size_t size() const { return commands.size(); }
+        const Command& operator[](size_t index) const { return commands[index]; }
+
+        void useShader(Shader &shader);
+        // sets the shader's "model" uniform, when it has one
+        void setModelMatrix(Shader &shader, const glm::mat4 &matrix);
+        // instances == 0 draws once without instancing
+        void drawMesh(Mesh &mesh, GLuint instances = 0);
+        void enable(GLenum capability);
+        void disable(GLenum capability);
+        void bindFramebuffer(GLenum target, GLuint framebuffer);
+        void clear(GLbitfield mask, const glm::vec4 &color);
+
+    private:
+        std::vector<Command> commands;
+
+        Command& push(CommandType type);
+};
+
+// Replays command buffers on the thread owning the GL context, through
+// GLState so binds repeated across commands and buffers are skipped.
+class CommandExecutor
+{
+    public:
+        void execute(const CommandBuffer &buffer);
+        void execute(const std::vector<const CommandBuffer*> &buffers);
+
+    private:
+        // "model" locations, resolved the first time a shader is replayed
+        std::unordered_map<const Shader*, UniformHandle<glm::mat4>> modelUniforms;
+};
+
+#endif
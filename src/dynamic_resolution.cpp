@@ -0,0 +1,109 @@
+#include "dynamic_resolution.h"
+
+#include <iostream>
+#include <cstdlib>
+
+DynamicResolution::DynamicResolution()
+{
+    const char *target = std::getenv("ASTEROID_DYNAMIC_RES");
+    if(target)
+        targetMs = (float)std::atof(target);
+    if(enabled())
+        std::cout << "DYNAMIC_RES:: holding " << targetMs << " ms of GPU time per frame" << std::endl;
+}
+
+GLsizei DynamicResolution::scaled(GLsizei size) const
+{
+    GLsizei result = (GLsizei)((long long)size * level / LEVELS);
+    return result > 0 ? result : 1;
+}
+
+void DynamicResolution::beginFrame()
+{
+    if(!enabled())
+        return;
+    if(!created)
+    {
+        glGenQueries(QUERY_COUNT, queries);
+        created = true;
+    }
+    // every query still in flight: skip timing this frame rather than wait
+    if(issued - collected >= QUERY_COUNT)
+        return;
+    glBeginQuery(GL_TIME_ELAPSED, queries[issued % QUERY_COUNT]);
+    timing = true;
+}
+
+bool DynamicResolution::endFrame()
+{
+    if(!enabled())
+        return false;
+    if(timing)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        issued++;
+        timing = false;
+    }
+
+    bool changed = false;
+    while(collected < issued)
+    {
+        GLuint query = queries[collected % QUERY_COUNT];
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available)
+            break;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        collected++;
+
+        // no frame takes a second of GPU time; such a result is a driver
+        // glitch (llvmpipe answers its first query with a timestamp)
+        float ms = nanoseconds / 1000000.0f;
+        if(ms > 1000.0f)
+            continue;
+        samples++;
+        totalMs += ms;
+        smoothedMs = smoothedMs < 0.0f ? ms : smoothedMs * 0.9f + ms * 0.1f;
+        if(hold > 0)
+        {
+            hold--;
+            continue;
+        }
+        // GPU time follows the pixel count, which one step up raises by up
+        // to (9/8)^2; going up only below 3/4 of the target keeps it from
+        // overshooting and coming straight back down
+        int next = level;
+        if(smoothedMs > targetMs && level > MIN_LEVEL)
+            next--;
+        else if(smoothedMs < targetMs * 0.75f && level < LEVELS)
+            next++;
+        if(next != level)
+        {
+            level = next;
+            hold = HOLD_FRAMES;
+            changes++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void DynamicResolution::deleteQueries()
+{
+    if(created)
+        glDeleteQueries(QUERY_COUNT, queries);
+    created = false;
+    issued = 0;
+    collected = 0;
+    timing = false;
+}
+
+void DynamicResolution::printStats() const
+{
+    if(!enabled())
+        return;
+    std::cout << "DYNAMIC_RES:: " << samples << " frames timed, " << (samples ? totalMs / samples : 0.0)
+              << " ms GPU time on average, " << changes << " scale changes, ending at "
+              << scale() * 100.0f << "%" << std::endl;
+}
@@ -0,0 +1,62 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// Scales the internal render resolution to hold a GPU frame time.
+// ASTEROID_DYNAMIC_RES=<milliseconds> sets the target, e.g.
+// ASTEROID_DYNAMIC_RES=8.3; without it the scale stays at 1.
+//
+// The GPU time of the frame's work between beginFrame() and endFrame() is
+// measured with GL_TIME_ELAPSED queries. Results are read a few frames late,
+// from a small ring, so the render thread never waits for them. The scale
+// moves in steps of 1/16 between MIN_LEVEL/16 and 1 of the framebuffer size:
+// one step down while the smoothed time is over the target, one step up once
+// it is comfortably under it, then it holds for a while so the new size shows
+// up in the measurements before the next step. Every step reallocates the
+// render targets, which is why it does not follow each frame.
+class DynamicResolution
+{
+    public:
+        static const int LEVELS = 16;
+        static const int MIN_LEVEL = 8;
+
+        DynamicResolution();
+
+        bool enabled() const { return targetMs > 0.0f; }
+        void beginFrame();
+        // true when the scale changed
+        bool endFrame();
+
+        float scale() const { return (float)level / LEVELS; }
+        // size at the current scale, at least 1
+        GLsizei scaled(GLsizei size) const;
+        float gpuMs() const { return smoothedMs; }
+
+        void deleteQueries();
+        void printStats() const;
+
+    private:
+        static const size_t QUERY_COUNT = 4;
+        // frames to hold a new scale
+        static const int HOLD_FRAMES = 30;
+
+        float targetMs = 0.0f;
+        int level = LEVELS;
+        int hold = 0;
+        float smoothedMs = -1.0f;
+
+        GLuint queries[QUERY_COUNT];
+        bool created = false;
+        // queries begun and read so far; the difference is in flight
+        size_t issued = 0;
+        size_t collected = 0;
+        bool timing = false;
+
+        size_t samples = 0;
+        size_t changes = 0;
+        double totalMs = 0.0;
+};
+
+#endif
@@ -0,0 +1,502 @@
+#include "frame_graph.h"
+#include "gl_state.h"
+
+#include <iostream>
+#include <algorithm>
+
+const uint32_t FrameGraph::NONE;
+
+static bool isDepthFormat(GLenum format)
+{
+    return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32
+        || format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+static bool hasStencil(GLenum format)
+{
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+// what the driver allocates per sample, near enough for the stats
+static size_t formatBytes(GLenum format)
+{
+    switch(format)
+    {
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGBA16F:
+        case GL_RGB16F:
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGBA32F:
+        case GL_RGB32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+static size_t targetBytes(const FrameTextureDesc &desc)
+{
+    return formatBytes(desc.format) * desc.width * desc.height * std::max(desc.samples, 1);
+}
+
+static bool sameTarget(const FrameTextureDesc &a, const FrameTextureDesc &b)
+{
+    return a.width == b.width && a.height == b.height && a.format == b.format && a.samples == b.samples;
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::read(FrameResource resource)
+{
+    graph->passes[pass].reads.push_back(resource);
+    return *this;
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::write(FrameResource resource)
+{
+    graph->passes[pass].writes.push_back(resource);
+    return *this;
+}
+
+FrameResource FrameGraph::addResource(const std::string &name, const FrameTextureDesc &desc, bool isBackbuffer)
+{
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.backbuffer = isBackbuffer;
+    resource.sampled = false;
+    resource.resolved = NONE;
+    resource.physical = NONE;
+    resource.first = NONE;
+    resource.last = 0;
+    resources.push_back(resource);
+    return (FrameResource)(resources.size() - 1);
+}
+
+FrameResource FrameGraph::createTexture(const std::string &name, const FrameTextureDesc &desc)
+{
+    FrameResource resource = addResource(name, desc, false);
+    declaredResources = resources.size();
+    return resource;
+}
+
+FrameResource FrameGraph::importBackbuffer(GLsizei width, GLsizei height)
+{
+    FrameTextureDesc desc = {width, height, GL_RGBA8, 1};
+    backbuffer = addResource("backbuffer", desc, true);
+    declaredResources = resources.size();
+    return backbuffer;
+}
+
+FrameGraph::PassBuilder FrameGraph::addPass(const std::string &name, Execute execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.execute = execute;
+    pass.culled = false;
+    passes.push_back(pass);
+    return PassBuilder(this, passes.size() - 1);
+}
+
+void FrameGraph::present(FrameResource resource)
+{
+    output = resource;
+}
+
+FrameResource FrameGraph::resolveTarget(FrameResource resource)
+{
+    if(resources[resource].resolved == NONE)
+    {
+        FrameTextureDesc desc = resources[resource].desc;
+        desc.samples = 1;
+        FrameResource target = addResource(resources[resource].name + ".resolved", desc, false);
+        resources[resource].resolved = target;
+    }
+    return resources[resource].resolved;
+}
+
+void FrameGraph::addBlit(FrameResource source, FrameResource destination)
+{
+    Step step;
+    step.pass = NONE;
+    step.source = source;
+    step.destination = destination;
+    step.readFramebuffer = 0;
+    step.drawFramebuffer = 0;
+    steps.push_back(step);
+    if(resources[source].desc.samples > 1)
+        resolves++;
+}
+
+void FrameGraph::touch(FrameResource resource, uint32_t step)
+{
+    Resource &target = resources[resource];
+    if(target.first == NONE || step < target.first)
+        target.first = step;
+    target.last = std::max(target.last, step);
+}
+
+void FrameGraph::compile()
+{
+    releaseFramebuffers();
+    resources.resize(declaredResources);
+    steps.clear();
+    culledPasses = 0;
+    resolves = 0;
+    for(size_t i = 0; i < resources.size(); i++)
+    {
+        resources[i].sampled = false;
+        resources[i].resolved = NONE;
+        resources[i].physical = NONE;
+        resources[i].first = NONE;
+        resources[i].last = 0;
+    }
+    if(output == NONE || backbuffer == NONE)
+    {
+        std::cout << "ERROR::FRAME_GRAPH:: Nothing is presented to a backbuffer" << std::endl;
+        return;
+    }
+
+    // a pass survives if something after it, or the presented resource,
+    // needs what it writes; what it reads and writes is then needed in turn
+    std::vector<bool> needed(resources.size(), false);
+    needed[output] = true;
+    for(size_t p = passes.size(); p-- > 0;)
+    {
+        Pass &pass = passes[p];
+        pass.culled = true;
+        for(size_t i = 0; i < pass.writes.size(); i++)
+        {
+            if(needed[pass.writes[i]])
+                pass.culled = false;
+        }
+        if(pass.culled)
+        {
+            culledPasses++;
+            continue;
+        }
+        for(size_t i = 0; i < pass.reads.size(); i++)
+            needed[pass.reads[i]] = true;
+        for(size_t i = 0; i < pass.writes.size(); i++)
+            needed[pass.writes[i]] = true;
+    }
+
+    // multisampled targets are resolved when sampled after a write
+    std::vector<bool> unresolved(declaredResources, true);
+    for(size_t p = 0; p < passes.size(); p++)
+    {
+        Pass &pass = passes[p];
+        if(pass.culled)
+            continue;
+        for(size_t i = 0; i < pass.reads.size(); i++)
+        {
+            FrameResource read = pass.reads[i];
+            if(resources[read].backbuffer)
+            {
+                std::cout << "ERROR::FRAME_GRAPH:: Pass " << pass.name << " reads the backbuffer" << std::endl;
+                continue;
+            }
+            if(resources[read].desc.samples > 1)
+            {
+                FrameResource target = resolveTarget(read);
+                if(unresolved[read])
+                    addBlit(read, target);
+                unresolved[read] = false;
+                read = target;
+            }
+            resources[read].sampled = true;
+        }
+        Step step;
+        step.pass = (uint32_t)p;
+        step.source = NONE;
+        step.destination = NONE;
+        step.readFramebuffer = 0;
+        step.drawFramebuffer = 0;
+        steps.push_back(step);
+        for(size_t i = 0; i < pass.writes.size(); i++)
+        {
+            if(pass.writes[i] < unresolved.size())
+                unresolved[pass.writes[i]] = true;
+        }
+    }
+    if(output != backbuffer)
+    {
+        // a multisampled blit cannot scale, so that goes through a resolve first
+        FrameResource source = output;
+        const FrameTextureDesc &from = resources[output].desc;
+        const FrameTextureDesc &to = resources[backbuffer].desc;
+        if(from.samples > 1 && (from.width != to.width || from.height != to.height))
+        {
+            source = resolveTarget(output);
+            if(unresolved[output])
+                addBlit(output, source);
+        }
+        addBlit(source, backbuffer);
+    }
+
+    for(uint32_t s = 0; s < steps.size(); s++)
+    {
+        const Step &step = steps[s];
+        if(step.pass == NONE)
+        {
+            touch(step.source, s);
+            touch(step.destination, s);
+            continue;
+        }
+        const Pass &pass = passes[step.pass];
+        for(size_t i = 0; i < pass.reads.size(); i++)
+        {
+            FrameResource read = pass.reads[i];
+            touch(resources[read].resolved != NONE ? resources[read].resolved : read, s);
+        }
+        for(size_t i = 0; i < pass.writes.size(); i++)
+            touch(pass.writes[i], s);
+    }
+    allocate();
+
+    for(size_t s = 0; s < steps.size(); s++)
+    {
+        Step &step = steps[s];
+        if(step.pass == NONE)
+        {
+            step.readFramebuffer = createFramebuffer(std::vector<FrameResource>(1, step.source), resources[step.source].name);
+            if(!resources[step.destination].backbuffer)
+                step.drawFramebuffer = createFramebuffer(std::vector<FrameResource>(1, step.destination), resources[step.destination].name);
+            continue;
+        }
+        const Pass &pass = passes[step.pass];
+        bool writesBackbuffer = false;
+        for(size_t i = 0; i < pass.writes.size(); i++)
+            writesBackbuffer = writesBackbuffer || resources[pass.writes[i]].backbuffer;
+        if(writesBackbuffer && pass.writes.size() > 1)
+            std::cout << "ERROR::FRAME_GRAPH:: Pass " << pass.name << " writes the backbuffer together with other targets" << std::endl;
+        if(!writesBackbuffer && !pass.writes.empty())
+            step.drawFramebuffer = createFramebuffer(pass.writes, pass.name);
+    }
+}
+
+void FrameGraph::allocate()
+{
+    for(size_t i = 0; i < physicals.size(); i++)
+    {
+        physicals[i].busyUntil = NONE;
+        physicals[i].used = false;
+    }
+
+    std::vector<FrameResource> order;
+    for(size_t i = 0; i < resources.size(); i++)
+    {
+        if(!resources[i].backbuffer && resources[i].first != NONE)
+            order.push_back((FrameResource)i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](FrameResource a, FrameResource b) { return resources[a].first < resources[b].first; });
+
+    transientTargets = order.size();
+    transientBytes = 0;
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        Resource &resource = resources[order[i]];
+        // sampled targets have to be textures; the rest only render and blit
+        bool renderbuffer = !resource.sampled;
+        transientBytes += targetBytes(resource.desc);
+
+        uint32_t chosen = NONE;
+        for(uint32_t p = 0; p < physicals.size() && chosen == NONE; p++)
+        {
+            const Physical &physical = physicals[p];
+            if(physical.renderbuffer == renderbuffer && sameTarget(physical.desc, resource.desc)
+               && (physical.busyUntil == NONE || physical.busyUntil < resource.first))
+                chosen = p;
+        }
+        if(chosen == NONE)
+        {
+            Physical physical;
+            physical.desc = resource.desc;
+            physical.renderbuffer = renderbuffer;
+            physical.busyUntil = NONE;
+            physical.used = false;
+            const FrameTextureDesc &desc = resource.desc;
+            if(renderbuffer)
+            {
+                glGenRenderbuffers(1, &physical.name);
+                glBindRenderbuffer(GL_RENDERBUFFER, physical.name);
+                if(desc.samples > 1)
+                    glRenderbufferStorageMultisample(GL_RENDERBUFFER, desc.samples, desc.format, desc.width, desc.height);
+                else
+                    glRenderbufferStorage(GL_RENDERBUFFER, desc.format, desc.width, desc.height);
+                glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            }
+            else
+            {
+                GLenum pixelFormat = GL_RGBA;
+                GLenum type = GL_UNSIGNED_BYTE;
+                if(isDepthFormat(desc.format))
+                {
+                    pixelFormat = hasStencil(desc.format) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+                    type = desc.format == GL_DEPTH32F_STENCIL8 ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV
+                         : hasStencil(desc.format) ? GL_UNSIGNED_INT_24_8 : GL_FLOAT;
+                }
+                GLState &gl = GLState::instance();
+                glGenTextures(1, &physical.name);
+                gl.bindTexture(GL_TEXTURE_2D, physical.name);
+                glTexImage2D(GL_TEXTURE_2D, 0, desc.format, desc.width, desc.height, 0, pixelFormat, type, NULL);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                gl.bindTexture(GL_TEXTURE_2D, 0);
+            }
+            physicals.push_back(physical);
+            chosen = (uint32_t)(physicals.size() - 1);
+        }
+        physicals[chosen].busyUntil = resource.last;
+        physicals[chosen].used = true;
+        resource.physical = chosen;
+    }
+
+    // targets the frame no longer has a use for go back to the driver
+    std::vector<uint32_t> remap(physicals.size(), NONE);
+    size_t kept = 0;
+    allocatedBytes = 0;
+    for(size_t p = 0; p < physicals.size(); p++)
+    {
+        if(!physicals[p].used)
+        {
+            if(physicals[p].renderbuffer)
+                glDeleteRenderbuffers(1, &physicals[p].name);
+            else
+                GLState::instance().deleteTexture(physicals[p].name);
+            continue;
+        }
+        allocatedBytes += targetBytes(physicals[p].desc);
+        remap[p] = (uint32_t)kept;
+        physicals[kept++] = physicals[p];
+    }
+    physicals.resize(kept);
+    for(size_t i = 0; i < resources.size(); i++)
+    {
+        if(resources[i].physical != NONE)
+            resources[i].physical = remap[resources[i].physical];
+    }
+}
+
+GLuint FrameGraph::createFramebuffer(const std::vector<FrameResource> &attachments, const std::string &name)
+{
+    GLState &gl = GLState::instance();
+    GLuint framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    gl.bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    std::vector<GLenum> drawBuffers;
+    for(size_t i = 0; i < attachments.size(); i++)
+    {
+        const Resource &resource = resources[attachments[i]];
+        const Physical &physical = physicals[resource.physical];
+        GLenum attachment;
+        if(isDepthFormat(resource.desc.format))
+            attachment = hasStencil(resource.desc.format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        else
+        {
+            attachment = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+            drawBuffers.push_back(attachment);
+        }
+        if(physical.renderbuffer)
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, physical.name);
+        else
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, physical.name, 0);
+    }
+    if(drawBuffers.empty())
+    {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    else
+        glDrawBuffers((GLsizei)drawBuffers.size(), &drawBuffers[0]);
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAME_GRAPH:: Framebuffer of " << name << " is not complete!" << std::endl;
+    gl.bindFramebuffer(GL_FRAMEBUFFER, 0);
+    framebuffers.push_back(framebuffer);
+    return framebuffer;
+}
+
+void FrameGraph::execute()
+{
+    GLState &gl = GLState::instance();
+    for(size_t s = 0; s < steps.size(); s++)
+    {
+        const Step &step = steps[s];
+        if(step.pass != NONE)
+        {
+            const Pass &pass = passes[step.pass];
+            gl.bindFramebuffer(GL_FRAMEBUFFER, step.drawFramebuffer);
+            if(!pass.writes.empty())
+            {
+                const FrameTextureDesc &target = resources[pass.writes[0]].desc;
+                glViewport(0, 0, target.width, target.height);
+            }
+            pass.execute(*this);
+            continue;
+        }
+        const FrameTextureDesc &from = resources[step.source].desc;
+        const FrameTextureDesc &to = resources[step.destination].desc;
+        GLbitfield mask = GL_COLOR_BUFFER_BIT;
+        if(isDepthFormat(from.format))
+            mask = hasStencil(from.format) ? GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT : GL_DEPTH_BUFFER_BIT;
+        bool scaled = from.width != to.width || from.height != to.height;
+        gl.bindFramebuffer(GL_READ_FRAMEBUFFER, step.readFramebuffer);
+        gl.bindFramebuffer(GL_DRAW_FRAMEBUFFER, step.drawFramebuffer);
+        glBlitFramebuffer(0, 0, from.width, from.height, 0, 0, to.width, to.height, mask,
+                          scaled && mask == GL_COLOR_BUFFER_BIT ? GL_LINEAR : GL_NEAREST);
+    }
+    gl.bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GLuint FrameGraph::texture(FrameResource resource) const
+{
+    const Resource &target = resources[resources[resource].resolved != NONE ? resources[resource].resolved : resource];
+    return target.physical != NONE ? physicals[target.physical].name : 0;
+}
+
+void FrameGraph::reset()
+{
+    releaseFramebuffers();
+    resources.clear();
+    declaredResources = 0;
+    passes.clear();
+    steps.clear();
+    output = NONE;
+    backbuffer = NONE;
+}
+
+void FrameGraph::releaseFramebuffers()
+{
+    GLState &gl = GLState::instance();
+    for(size_t i = 0; i < framebuffers.size(); i++)
+        gl.deleteFramebuffer(framebuffers[i]);
+    framebuffers.clear();
+}
+
+void FrameGraph::deleteObjects()
+{
+    releaseFramebuffers();
+    for(size_t p = 0; p < physicals.size(); p++)
+    {
+        if(physicals[p].renderbuffer)
+            glDeleteRenderbuffers(1, &physicals[p].name);
+        else
+            GLState::instance().deleteTexture(physicals[p].name);
+    }
+    physicals.clear();
+    for(size_t i = 0; i < resources.size(); i++)
+        resources[i].physical = NONE;
+    steps.clear();
+}
+
+void FrameGraph::printStats() const
+{
+    size_t kept = passes.size() - culledPasses;
+    std::cout << "FRAME_GRAPH:: " << kept << " of " << passes.size() << " passes (" << culledPasses << " culled), "
+              << resolves << " resolves, " << steps.size() - kept << " blits; "
+              << transientTargets << " transient targets in " << physicals.size() << " allocations, "
+              << allocatedBytes / 1024 << " KiB (" << transientBytes / 1024 << " KiB without aliasing)" << std::endl;
+}
@@ -0,0 +1,150 @@
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+typedef uint32_t FrameResource;
+
+struct FrameTextureDesc {
+    GLsizei width;
+    GLsizei height;
+    // sized internal format, e.g. GL_RGBA8 or GL_DEPTH24_STENCIL8
+    GLenum format;
+    GLsizei samples;
+};
+
+// The render targets of a frame and the passes that draw into them. Passes
+// declare what they sample (read) and what they render to (write); the GL
+// objects behind the targets belong to the graph. compile() works out the
+// frame from the resource that is presented:
+//
+//   - passes whose writes nothing downstream reads are culled
+//   - a multisampled target that a pass samples is resolved into a plain
+//     texture right before that pass, and only if it was written since the
+//     last resolve; presenting a multisampled target resolves it straight
+//     into the default framebuffer
+//   - transient targets with the same size, format and sample count share
+//     one GL object when their lifetimes (first to last step using them) do
+//     not overlap. Multisampled targets are only ever blitted from, so they
+//     are renderbuffers; everything a pass samples is a texture
+//
+// Declare once and compile, then execute() every frame; reset() and declare
+// again when the frame changes shape or size. The contents of a transient
+// target are undefined until its first writer in the frame draws, so that
+// pass clears or covers all of it. Compile and execute on the GL thread.
+//
+//   FrameResource color = graph.createTexture("sceneColor", {width, height, GL_RGBA8, 4});
+//   FrameGraph::PassBuilder scene = graph.addPass("scene", [&](const FrameGraph &graph) { ... });
+//   scene.write(color);
+//   graph.present(color);
+//   graph.compile();
+class FrameGraph
+{
+    public:
+        typedef std::function<void(const FrameGraph &graph)> Execute;
+
+        class PassBuilder
+        {
+            public:
+                // sampled as a texture in the pass, see texture()
+                PassBuilder& read(FrameResource resource);
+                // rendered to: color formats attach in call order, depth and
+                // depth/stencil formats to the depth attachment
+                PassBuilder& write(FrameResource resource);
+
+            private:
+                friend class FrameGraph;
+                FrameGraph *graph;
+                size_t pass;
+                PassBuilder(FrameGraph *graph, size_t pass) : graph(graph), pass(pass) {}
+        };
+
+        FrameResource createTexture(const std::string &name, const FrameTextureDesc &desc);
+        // the default framebuffer; a pass that writes it writes nothing else
+        FrameResource importBackbuffer(GLsizei width, GLsizei height);
+        // passes execute in the order they are added
+        PassBuilder addPass(const std::string &name, Execute execute);
+        // the frame's result; copied (or resolved) into the backbuffer unless it is the backbuffer
+        void present(FrameResource resource);
+
+        void compile();
+        void execute();
+        // forgets passes and resources; GL objects are kept for the next compile to reuse
+        void reset();
+        // frees the GL objects; before the context goes away
+        void deleteObjects();
+
+        // GL name of the texture a pass reads for resource, the resolved copy for multisampled targets
+        GLuint texture(FrameResource resource) const;
+        const FrameTextureDesc& desc(FrameResource resource) const { return resources[resource].desc; }
+        void printStats() const;
+
+    private:
+        static const uint32_t NONE = 0xFFFFFFFFu;
+
+        struct Resource {
+            std::string name;
+            FrameTextureDesc desc;
+            bool backbuffer;
+            // set by compile()
+            bool sampled;
+            uint32_t resolved;
+            uint32_t physical;
+            uint32_t first;
+            uint32_t last;
+        };
+        struct Pass {
+            std::string name;
+            Execute execute;
+            std::vector<FrameResource> reads;
+            std::vector<FrameResource> writes;
+            bool culled;
+        };
+        // a pass, or a blit from source to destination when pass is NONE
+        struct Step {
+            uint32_t pass;
+            FrameResource source;
+            FrameResource destination;
+            GLuint readFramebuffer;
+            GLuint drawFramebuffer;
+        };
+        struct Physical {
+            FrameTextureDesc desc;
+            bool renderbuffer;
+            GLuint name;
+            // last step of the resource holding it in this compile, NONE while free
+            uint32_t busyUntil;
+            bool used;
+        };
+
+        std::vector<Resource> resources;
+        // resources past this are resolve targets added by compile()
+        size_t declaredResources = 0;
+        std::vector<Pass> passes;
+        std::vector<Step> steps;
+        std::vector<Physical> physicals;
+        std::vector<GLuint> framebuffers;
+        FrameResource output = NONE;
+        FrameResource backbuffer = NONE;
+
+        size_t culledPasses = 0;
+        size_t resolves = 0;
+        size_t transientTargets = 0;
+        size_t transientBytes = 0;
+        size_t allocatedBytes = 0;
+
+        FrameResource addResource(const std::string &name, const FrameTextureDesc &desc, bool backbuffer);
+        FrameResource resolveTarget(FrameResource resource);
+        void addBlit(FrameResource source, FrameResource destination);
+        void touch(FrameResource resource, uint32_t step);
+        void allocate();
+        GLuint createFramebuffer(const std::vector<FrameResource> &attachments, const std::string &name);
+        void releaseFramebuffers();
+};
+
+#endif
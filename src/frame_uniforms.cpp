@@ -0,0 +1,50 @@
+#include "frame_uniforms.h"
+
+FrameUniforms::FrameUniforms() : frame()
+{
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, buffer);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    glDeleteBuffers(1, &buffer);
+}
+
+// planes of the clip volume taken from the rows of the view-projection matrix
+static void extractFrustumPlanes(const glm::mat4 &m, glm::vec4 planes[6])
+{
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    planes[4] = row3 + row2;
+    planes[5] = row3 - row2;
+    for(int i = 0; i < 6; i++)
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+void FrameUniforms::update(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPosition,
+                           float time, float deltaTime, float width, float height)
+{
+    frame.view = view;
+    frame.projection = projection;
+    frame.viewProjection = projection * view;
+    extractFrustumPlanes(frame.viewProjection, frame.frustumPlanes);
+    frame.cameraPosition = glm::vec4(cameraPosition, 1.0f);
+    frame.timeResolution = glm::vec4(time, deltaTime, width, height);
+
+    // orphan last frame's storage so the driver does not wait for draws still reading it
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameConstants), &frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,54 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Uniform buffer binding point of the per-frame constants. Shaders pick the
+// block up by declaring it; Shader binds any block named "Frame" here after
+// linking:
+//
+//   layout (std140) uniform Frame
+//   {
+//       mat4 view;
+//       mat4 projection;
+//       mat4 viewProjection;
+//       vec4 frustumPlanes[6];
+//       vec4 cameraPosition;
+//       vec4 timeResolution;   // time, delta time, framebuffer width, height
+//   };
+const GLuint FRAME_UNIFORM_BINDING = 0;
+const char* const FRAME_UNIFORM_BLOCK = "Frame";
+
+// std140 layout of the Frame block; every member is a multiple of vec4
+struct FrameConstants {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    // left, right, bottom, top, near, far; xyz normal pointing inwards, w distance
+    glm::vec4 frustumPlanes[6];
+    glm::vec4 cameraPosition;
+    glm::vec4 timeResolution;
+};
+
+// Camera and timing constants shared by all shaders. update() is called once
+// per frame and is the only upload, no matter how many programs read it.
+class FrameUniforms
+{
+    public:
+        FrameUniforms();
+        ~FrameUniforms();
+
+        void update(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPosition,
+                    float time, float deltaTime, float width, float height);
+        const FrameConstants& constants() const { return frame; }
+
+    private:
+        GLuint buffer;
+        FrameConstants frame;
+
+        FrameUniforms(const FrameUniforms&) = delete;
+        FrameUniforms& operator=(const FrameUniforms&) = delete;
+};
+
+#endif
@@ -0,0 +1,864 @@
+#include "gl_capture.h"
+#include "null_gl.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+enum GLCaptureEntry {
+#define GL_FUNCTION(ret, name, params, args) GL_CAPTURE_##name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+    GL_CAPTURE_ENTRY_COUNT
+};
+
+static const char* const GL_CAPTURE_NAMES[GL_CAPTURE_ENTRY_COUNT] = {
+#define GL_FUNCTION(ret, name, params, args) #name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+};
+
+// pointers these take are buffer offsets, never client memory
+static const char* const OFFSET_POINTER_FUNCTIONS[] = {
+    "glVertexAttribPointer", "glVertexAttribIPointer", "glDrawElements", "glDrawElementsInstanced",
+    "glDrawElementsBaseVertex", "glDrawElementsInstancedBaseVertex", "glDrawRangeElements",
+    "glDrawRangeElementsBaseVertex"
+};
+
+static bool captureInstalled = false;
+static std::atomic<bool> capturing(false);
+static std::mutex captureMutex;
+static std::ofstream captureFile;
+static std::string capturePath;
+static std::unordered_set<uint64_t> writtenBlobs;
+static bool offsetPointers[GL_CAPTURE_ENTRY_COUNT];
+static std::atomic<bool> unsupportedReported[GL_CAPTURE_ENTRY_COUNT];
+static size_t frameLimit = 60;
+static size_t capturedFrames = 0;
+static uint64_t capturedCalls = 0;
+static uint64_t blobBytes = 0;
+static uint64_t dedupedBytes = 0;
+static uint16_t nextThread = 0;
+static thread_local int captureThread = -1;
+
+// client-side state that decides how much memory a call reads, per thread
+// like the contexts it mirrors
+struct CaptureMapping {
+    GLenum target;
+    char *data;
+    GLsizeiptr length;
+    GLbitfield access;
+};
+static thread_local GLuint unpackBuffer = 0;
+static thread_local GLint unpackAlignment = 4;
+static thread_local GLint unpackRowLength = 0;
+static thread_local GLint unpackImageHeight = 0;
+static thread_local std::vector<CaptureMapping> mappings;
+
+// holds the capture lock for the whole call while recording, so the file
+// order is the order the driver saw
+struct CaptureLock {
+    std::unique_lock<std::mutex> lock;
+    bool active;
+
+    CaptureLock() : active(capturing.load(std::memory_order_relaxed))
+    {
+        if(active)
+        {
+            lock = std::unique_lock<std::mutex>(captureMutex);
+            active = capturing.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+static uint64_t blobHash(const void *data, size_t size)
+{
+    // FNV-1a, 64 bit
+    const unsigned char *bytes = (const unsigned char*)data;
+    uint64_t hash = 14695981039346656037ull;
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void writePacket(uint16_t entry, uint16_t blobs, const uint64_t *slots, uint16_t slotCount)
+{
+    if(captureThread < 0)
+        captureThread = nextThread++;
+    GLCapturePacket packet;
+    packet.entry = entry;
+    packet.thread = (uint16_t)captureThread;
+    packet.blobs = blobs;
+    packet.slotCount = slotCount;
+    captureFile.write((const char*)&packet, sizeof(packet));
+    captureFile.write((const char*)slots, slotCount * sizeof(uint64_t));
+}
+
+// caller holds the capture lock
+static uint64_t writeBlob(const void *data, size_t size)
+{
+    uint64_t hash = blobHash(data, size);
+    if(!writtenBlobs.insert(hash).second)
+    {
+        dedupedBytes += size;
+        return hash;
+    }
+    uint64_t slots[2] = { hash, size };
+    writePacket(GL_CAPTURE_BLOB, 0, slots, 2);
+    captureFile.write((const char*)data, size);
+    static const char padding[8] = {};
+    captureFile.write(padding, (8 - size % 8) % 8);
+    blobBytes += size;
+    return hash;
+}
+
+struct CaptureCall {
+    uint16_t entry;
+    uint16_t blobs = 0;
+    uint16_t slotCount = 0;
+    uint64_t slots[16];
+
+    CaptureCall(uint16_t entry) : entry(entry) {}
+
+    template<typename T>
+    void value(T value)
+    {
+        slots[slotCount++] = toCaptureSlot(value);
+    }
+
+    void blob(const void *data, size_t size)
+    {
+        if(!data)
+        {
+            value(data);
+            return;
+        }
+        blobs |= 1 << slotCount;
+        slots[slotCount++] = writeBlob(data, size);
+    }
+
+    // with a pixel unpack buffer bound the pointer is an offset into it
+    void pixels(const void *data, size_t size)
+    {
+        if(unpackBuffer)
+            value(data);
+        else
+            blob(data, size);
+    }
+
+    void write()
+    {
+        writePacket(entry, blobs, slots, slotCount);
+        capturedCalls++;
+    }
+};
+
+template<typename T>
+static constexpr bool isClientPointer()
+{
+    return std::is_pointer_v<T> && !std::is_same_v<T, GLsync>;
+}
+
+template<typename R, typename... A>
+static R captureCall(GLCaptureEntry entry, R (APIENTRY *real)(A...), std::type_identity_t<A>... values)
+{
+    CaptureLock lock;
+    if constexpr((isClientPointer<A>() || ...))
+    {
+        if(lock.active && !offsetPointers[entry] && !unsupportedReported[entry].exchange(true))
+            std::cout << "ERROR::GL_CAPTURE::" << GL_CAPTURE_NAMES[entry] << " reads client memory, left out of the capture" << std::endl;
+        if(!offsetPointers[entry])
+            lock.active = false;
+    }
+    if constexpr(std::is_void_v<R>)
+    {
+        real(values...);
+        if(lock.active)
+        {
+            CaptureCall call(entry);
+            (call.value(values), ...);
+            call.write();
+        }
+    }
+    else
+    {
+        R result = real(values...);
+        if(lock.active)
+        {
+            CaptureCall call(entry);
+            (call.value(values), ...);
+            call.value(result);
+            call.write();
+        }
+        return result;
+    }
+}
+
+// the pointers glad handed out, called by the wrappers
+#define GL_FUNCTION(ret, name, params, args) \
+    static decltype(glad_##name) real_##name = NULL;
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+// wrappers for calls whose arguments are all values: record them as passed
+#define CAPTURE_ARGUMENTS(...) __VA_OPT__(,) __VA_ARGS__
+#define GL_FUNCTION(ret, name, params, args) \
+    static ret APIENTRY capture_##name params { return captureCall(GL_CAPTURE_##name, real_##name CAPTURE_ARGUMENTS args); }
+#include "gl_functions.h"
+#undef GL_FUNCTION
+#undef CAPTURE_ARGUMENTS
+
+// bytes an image upload reads from client memory under the unpack state
+static size_t imageBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type)
+{
+    size_t pixel = pixelBytes(format, type);
+    size_t rowPixels = unpackRowLength > 0 ? (size_t)unpackRowLength : (size_t)width;
+    size_t row = (rowPixels * pixel + unpackAlignment - 1) / unpackAlignment * unpackAlignment;
+    size_t imageRows = unpackImageHeight > 0 ? (size_t)unpackImageHeight : (size_t)height;
+    if(width <= 0 || height <= 0 || depth <= 0)
+        return 0;
+    // the last row of the last image is not padded
+    return row * imageRows * (depth - 1) + row * (height - 1) + (size_t)width * pixel;
+}
+
+static CaptureMapping* findMapping(GLenum target)
+{
+    for(size_t i = 0; i < mappings.size(); i++)
+    {
+        if(mappings[i].target == target)
+            return &mappings[i];
+    }
+    return NULL;
+}
+
+static void recordMappedWrite(GLenum target, GLintptr offset, const char *data, GLsizeiptr length)
+{
+    CaptureCall call(GL_CAPTURE_MAPPED_WRITE);
+    call.value(target);
+    call.value(offset);
+    call.blob(data, (size_t)length);
+    call.write();
+}
+
+static void APIENTRY captureBindBuffer(GLenum target, GLuint buffer)
+{
+    if(target == GL_PIXEL_UNPACK_BUFFER)
+        unpackBuffer = buffer;
+    captureCall(GL_CAPTURE_glBindBuffer, real_glBindBuffer, target, buffer);
+}
+
+static void APIENTRY capturePixelStorei(GLenum pname, GLint param)
+{
+    switch(pname)
+    {
+        case GL_UNPACK_ALIGNMENT:    unpackAlignment = param; break;
+        case GL_UNPACK_ROW_LENGTH:   unpackRowLength = param; break;
+        case GL_UNPACK_IMAGE_HEIGHT: unpackImageHeight = param; break;
+        default: break;
+    }
+    captureCall(GL_CAPTURE_glPixelStorei, real_glPixelStorei, pname, param);
+}
+
+static void APIENTRY captureBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    CaptureLock lock;
+    real_glBufferData(target, size, data, usage);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glBufferData);
+    call.value(target);
+    call.value(size);
+    call.blob(data, (size_t)size);
+    call.value(usage);
+    call.write();
+}
+
+static void APIENTRY captureBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    CaptureLock lock;
+    real_glBufferSubData(target, offset, size, data);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glBufferSubData);
+    call.value(target);
+    call.value(offset);
+    call.value(size);
+    call.blob(data, (size_t)size);
+    call.write();
+}
+
+static void APIENTRY captureTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                       GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    CaptureLock lock;
+    real_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glTexImage2D);
+    call.value(target);
+    call.value(level);
+    call.value(internalformat);
+    call.value(width);
+    call.value(height);
+    call.value(border);
+    call.value(format);
+    call.value(type);
+    call.pixels(pixels, imageBytes(width, height, 1, format, type));
+    call.write();
+}
+
+static void APIENTRY captureTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                                          GLenum format, GLenum type, const void *pixels)
+{
+    CaptureLock lock;
+    real_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glTexSubImage2D);
+    call.value(target);
+    call.value(level);
+    call.value(xoffset);
+    call.value(yoffset);
+    call.value(width);
+    call.value(height);
+    call.value(format);
+    call.value(type);
+    call.pixels(pixels, imageBytes(width, height, 1, format, type));
+    call.write();
+}
+
+static void APIENTRY captureTexImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth,
+                                       GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    CaptureLock lock;
+    real_glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, pixels);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glTexImage3D);
+    call.value(target);
+    call.value(level);
+    call.value(internalformat);
+    call.value(width);
+    call.value(height);
+    call.value(depth);
+    call.value(border);
+    call.value(format);
+    call.value(type);
+    call.pixels(pixels, imageBytes(width, height, depth, format, type));
+    call.write();
+}
+
+static void APIENTRY captureTexSubImage3D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+                                          GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+{
+    CaptureLock lock;
+    real_glTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glTexSubImage3D);
+    call.value(target);
+    call.value(level);
+    call.value(xoffset);
+    call.value(yoffset);
+    call.value(zoffset);
+    call.value(width);
+    call.value(height);
+    call.value(depth);
+    call.value(format);
+    call.value(type);
+    call.pixels(pixels, imageBytes(width, height, depth, format, type));
+    call.write();
+}
+
+static void APIENTRY captureCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+                                                 GLint border, GLsizei imageSize, const void *data)
+{
+    CaptureLock lock;
+    real_glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glCompressedTexImage2D);
+    call.value(target);
+    call.value(level);
+    call.value(internalformat);
+    call.value(width);
+    call.value(height);
+    call.value(border);
+    call.value(imageSize);
+    call.pixels(data, (size_t)imageSize);
+    call.write();
+}
+
+static void APIENTRY captureCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                                                    GLenum format, GLsizei imageSize, const void *data)
+{
+    CaptureLock lock;
+    real_glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glCompressedTexSubImage2D);
+    call.value(target);
+    call.value(level);
+    call.value(xoffset);
+    call.value(yoffset);
+    call.value(width);
+    call.value(height);
+    call.value(format);
+    call.value(imageSize);
+    call.pixels(data, (size_t)imageSize);
+    call.write();
+}
+
+// recorded as one NUL-terminated string with count 1, which compiles the same
+static void APIENTRY captureShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    CaptureLock lock;
+    real_glShaderSource(shader, count, string, length);
+    if(!lock.active)
+        return;
+    std::string source;
+    for(GLsizei i = 0; i < count; i++)
+    {
+        if(length && length[i] >= 0)
+            source.append(string[i], (size_t)length[i]);
+        else
+            source.append(string[i]);
+    }
+    CaptureCall call(GL_CAPTURE_glShaderSource);
+    call.value(shader);
+    call.value((GLsizei)1);
+    call.blob(source.c_str(), source.size() + 1);
+    call.value((const GLint*)NULL);
+    call.write();
+}
+
+// generated names are recorded after the call so the replayer can map
+// them, deleted ones so it can drop the mapping
+#define CAPTURE_NAMES(function, type) \
+    static void APIENTRY capture_##function##Names(GLsizei n, type *names) \
+    { \
+        CaptureLock lock; \
+        real_##function(n, names); \
+        if(!lock.active) \
+            return; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(n); \
+        call.blob(names, (size_t)n * sizeof(GLuint)); \
+        call.write(); \
+    }
+CAPTURE_NAMES(glGenBuffers, GLuint)
+CAPTURE_NAMES(glGenTextures, GLuint)
+CAPTURE_NAMES(glGenVertexArrays, GLuint)
+CAPTURE_NAMES(glGenFramebuffers, GLuint)
+CAPTURE_NAMES(glGenRenderbuffers, GLuint)
+CAPTURE_NAMES(glGenQueries, GLuint)
+CAPTURE_NAMES(glGenSamplers, GLuint)
+CAPTURE_NAMES(glDeleteBuffers, const GLuint)
+CAPTURE_NAMES(glDeleteTextures, const GLuint)
+CAPTURE_NAMES(glDeleteVertexArrays, const GLuint)
+CAPTURE_NAMES(glDeleteFramebuffers, const GLuint)
+CAPTURE_NAMES(glDeleteRenderbuffers, const GLuint)
+CAPTURE_NAMES(glDeleteQueries, const GLuint)
+CAPTURE_NAMES(glDeleteSamplers, const GLuint)
+#undef CAPTURE_NAMES
+
+static void APIENTRY captureDrawBuffers(GLsizei n, const GLenum *bufs)
+{
+    CaptureLock lock;
+    real_glDrawBuffers(n, bufs);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glDrawBuffers);
+    call.value(n);
+    call.blob(bufs, (size_t)n * sizeof(GLenum));
+    call.write();
+}
+
+#define CAPTURE_UNIFORM_VECTOR(function, type, components) \
+    static void APIENTRY capture_##function##Vector(GLint location, GLsizei count, const type *value) \
+    { \
+        CaptureLock lock; \
+        real_##function(location, count, value); \
+        if(!lock.active) \
+            return; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(location); \
+        call.value(count); \
+        call.blob(value, (size_t)count * components * sizeof(type)); \
+        call.write(); \
+    }
+CAPTURE_UNIFORM_VECTOR(glUniform1fv, GLfloat, 1)
+CAPTURE_UNIFORM_VECTOR(glUniform2fv, GLfloat, 2)
+CAPTURE_UNIFORM_VECTOR(glUniform3fv, GLfloat, 3)
+CAPTURE_UNIFORM_VECTOR(glUniform4fv, GLfloat, 4)
+CAPTURE_UNIFORM_VECTOR(glUniform1iv, GLint, 1)
+CAPTURE_UNIFORM_VECTOR(glUniform2iv, GLint, 2)
+CAPTURE_UNIFORM_VECTOR(glUniform3iv, GLint, 3)
+CAPTURE_UNIFORM_VECTOR(glUniform4iv, GLint, 4)
+CAPTURE_UNIFORM_VECTOR(glUniform1uiv, GLuint, 1)
+CAPTURE_UNIFORM_VECTOR(glUniform2uiv, GLuint, 2)
+CAPTURE_UNIFORM_VECTOR(glUniform3uiv, GLuint, 3)
+CAPTURE_UNIFORM_VECTOR(glUniform4uiv, GLuint, 4)
+#undef CAPTURE_UNIFORM_VECTOR
+
+#define CAPTURE_UNIFORM_MATRIX(function, components) \
+    static void APIENTRY capture_##function##Matrix(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) \
+    { \
+        CaptureLock lock; \
+        real_##function(location, count, transpose, value); \
+        if(!lock.active) \
+            return; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(location); \
+        call.value(count); \
+        call.value(transpose); \
+        call.blob(value, (size_t)count * components * sizeof(GLfloat)); \
+        call.write(); \
+    }
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix2fv, 4)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix3fv, 9)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix4fv, 16)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix2x3fv, 6)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix3x2fv, 6)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix2x4fv, 8)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix4x2fv, 8)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix3x4fv, 12)
+CAPTURE_UNIFORM_MATRIX(glUniformMatrix4x3fv, 12)
+#undef CAPTURE_UNIFORM_MATRIX
+
+// locations are driver specific; the replayer looks them up again and maps
+#define CAPTURE_LOCATION(function, ret) \
+    static ret APIENTRY capture_##function##Location(GLuint program, const GLchar *name) \
+    { \
+        CaptureLock lock; \
+        ret result = real_##function(program, name); \
+        if(!lock.active) \
+            return result; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(program); \
+        call.blob(name, std::strlen(name) + 1); \
+        call.value(result); \
+        call.write(); \
+        return result; \
+    }
+CAPTURE_LOCATION(glGetUniformLocation, GLint)
+CAPTURE_LOCATION(glGetAttribLocation, GLint)
+CAPTURE_LOCATION(glGetFragDataLocation, GLint)
+CAPTURE_LOCATION(glGetUniformBlockIndex, GLuint)
+#undef CAPTURE_LOCATION
+
+#define CAPTURE_BIND_LOCATION(function) \
+    static void APIENTRY capture_##function##Name(GLuint program, GLuint index, const GLchar *name) \
+    { \
+        CaptureLock lock; \
+        real_##function(program, index, name); \
+        if(!lock.active) \
+            return; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(program); \
+        call.value(index); \
+        call.blob(name, std::strlen(name) + 1); \
+        call.write(); \
+    }
+CAPTURE_BIND_LOCATION(glBindAttribLocation)
+CAPTURE_BIND_LOCATION(glBindFragDataLocation)
+#undef CAPTURE_BIND_LOCATION
+
+// depth and stencil clear one value, colour buffers four
+#define CAPTURE_CLEAR_BUFFER(function, type) \
+    static void APIENTRY capture_##function##Values(GLenum buffer, GLint drawbuffer, const type *value) \
+    { \
+        CaptureLock lock; \
+        real_##function(buffer, drawbuffer, value); \
+        if(!lock.active) \
+            return; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(buffer); \
+        call.value(drawbuffer); \
+        call.blob(value, (buffer == GL_COLOR ? 4 : 1) * sizeof(type)); \
+        call.write(); \
+    }
+CAPTURE_CLEAR_BUFFER(glClearBufferiv, GLint)
+CAPTURE_CLEAR_BUFFER(glClearBufferuiv, GLuint)
+CAPTURE_CLEAR_BUFFER(glClearBufferfv, GLfloat)
+#undef CAPTURE_CLEAR_BUFFER
+
+// vector parameters hold four values for the border colour and swizzle
+#define CAPTURE_PARAMETER_VECTOR(function, object, type) \
+    static void APIENTRY capture_##function##Values(object target, GLenum pname, const type *params) \
+    { \
+        CaptureLock lock; \
+        real_##function(target, pname, params); \
+        if(!lock.active) \
+            return; \
+        CaptureCall call(GL_CAPTURE_##function); \
+        call.value(target); \
+        call.value(pname); \
+        call.blob(params, (pname == GL_TEXTURE_BORDER_COLOR || pname == GL_TEXTURE_SWIZZLE_RGBA ? 4 : 1) * sizeof(type)); \
+        call.write(); \
+    }
+CAPTURE_PARAMETER_VECTOR(glTexParameterfv, GLenum, GLfloat)
+CAPTURE_PARAMETER_VECTOR(glTexParameteriv, GLenum, GLint)
+CAPTURE_PARAMETER_VECTOR(glTexParameterIiv, GLenum, GLint)
+CAPTURE_PARAMETER_VECTOR(glTexParameterIuiv, GLenum, GLuint)
+CAPTURE_PARAMETER_VECTOR(glSamplerParameterfv, GLuint, GLfloat)
+CAPTURE_PARAMETER_VECTOR(glSamplerParameteriv, GLuint, GLint)
+CAPTURE_PARAMETER_VECTOR(glSamplerParameterIiv, GLuint, GLint)
+CAPTURE_PARAMETER_VECTOR(glSamplerParameterIuiv, GLuint, GLuint)
+#undef CAPTURE_PARAMETER_VECTOR
+
+static void* APIENTRY captureMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    void *data = captureCall(GL_CAPTURE_glMapBufferRange, real_glMapBufferRange, target, offset, length, access);
+    if(data)
+        mappings.push_back(CaptureMapping{target, (char*)data, length, access});
+    return data;
+}
+
+static void* APIENTRY captureMapBuffer(GLenum target, GLenum access)
+{
+    void *data = captureCall(GL_CAPTURE_glMapBuffer, real_glMapBuffer, target, access);
+    if(data)
+    {
+        GLint size = 0;
+        real_glGetBufferParameteriv(target, GL_BUFFER_SIZE, &size);
+        GLbitfield bits = access == GL_READ_ONLY ? GL_MAP_READ_BIT : GL_MAP_WRITE_BIT;
+        mappings.push_back(CaptureMapping{target, (char*)data, size, bits});
+    }
+    return data;
+}
+
+static void APIENTRY captureFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+    CaptureLock lock;
+    CaptureMapping *mapping = findMapping(target);
+    if(lock.active && mapping && (mapping -> access & GL_MAP_WRITE_BIT))
+        recordMappedWrite(target, offset, mapping -> data + offset, length);
+    real_glFlushMappedBufferRange(target, offset, length);
+    if(!lock.active)
+        return;
+    CaptureCall call(GL_CAPTURE_glFlushMappedBufferRange);
+    call.value(target);
+    call.value(offset);
+    call.value(length);
+    call.write();
+}
+
+// without explicit flushes everything mapped for writing counts as written
+static GLboolean APIENTRY captureUnmapBuffer(GLenum target)
+{
+    CaptureLock lock;
+    CaptureMapping *mapping = findMapping(target);
+    if(lock.active && mapping && (mapping -> access & GL_MAP_WRITE_BIT) && !(mapping -> access & GL_MAP_FLUSH_EXPLICIT_BIT))
+        recordMappedWrite(target, 0, mapping -> data, mapping -> length);
+    if(mapping)
+        mappings.erase(mappings.begin() + (mapping - mappings.data()));
+    GLboolean result = real_glUnmapBuffer(target);
+    if(!lock.active)
+        return result;
+    CaptureCall call(GL_CAPTURE_glUnmapBuffer);
+    call.value(target);
+    call.value(result);
+    call.write();
+    return result;
+}
+
+static bool startsWith(const char *name, const char *prefix)
+{
+    return std::strncmp(name, prefix, std::strlen(prefix)) == 0;
+}
+
+// queries change no state and are left out, apart from the location
+// lookups the replayer needs, which get their own wrappers below
+static bool isQuery(const char *name)
+{
+    return startsWith(name, "glGet") || startsWith(name, "glIs") || std::strcmp(name, "glCheckFramebufferStatus") == 0;
+}
+
+static const char* captureOption()
+{
+    const char *option = std::getenv("ASTEROID_GL_CAPTURE");
+    return option ? option : "";
+}
+
+bool GLCapture::requested()
+{
+    const char *option = captureOption();
+    return *option && std::strcmp(option, "off") != 0;
+}
+
+void GLCapture::install(int width, int height)
+{
+    if(captureInstalled)
+        return;
+    captureInstalled = true;
+
+    const char *frames = std::getenv("ASTEROID_CAPTURE_FRAMES");
+    if(frames && std::atoi(frames) > 0)
+        frameLimit = (size_t)std::atoi(frames);
+
+    capturePath = captureOption();
+    captureFile.open(capturePath, std::ios::binary | std::ios::trunc);
+    if(!captureFile)
+    {
+        std::cout << "ERROR::GL_CAPTURE::Cannot write " << capturePath << std::endl;
+        return;
+    }
+    GLCaptureHeader header;
+    std::memcpy(header.magic, GL_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = GL_CAPTURE_VERSION;
+    header.entryCount = GL_CAPTURE_ENTRY_COUNT;
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    captureFile.write((const char*)&header, sizeof(header));
+    size_t written = sizeof(header);
+    for(int i = 0; i < GL_CAPTURE_ENTRY_COUNT; i++)
+    {
+        captureFile.write(GL_CAPTURE_NAMES[i], std::strlen(GL_CAPTURE_NAMES[i]) + 1);
+        written += std::strlen(GL_CAPTURE_NAMES[i]) + 1;
+    }
+    static const char padding[8] = {};
+    captureFile.write(padding, (8 - written % 8) % 8);
+
+    for(int i = 0; i < GL_CAPTURE_ENTRY_COUNT; i++)
+    {
+        for(size_t f = 0; f < sizeof(OFFSET_POINTER_FUNCTIONS) / sizeof(OFFSET_POINTER_FUNCTIONS[0]); f++)
+        {
+            if(std::strcmp(GL_CAPTURE_NAMES[i], OFFSET_POINTER_FUNCTIONS[f]) == 0)
+                offsetPointers[i] = true;
+        }
+    }
+
+#define GL_FUNCTION(ret, name, params, args) \
+    real_##name = glad_##name; \
+    if(real_##name && !isQuery(#name)) \
+        glad_##name = capture_##name;
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+#define GL_CAPTURE_OVERRIDE(name, wrapper) \
+    if(real_##name) \
+        glad_##name = wrapper;
+    GL_CAPTURE_OVERRIDE(glBindBuffer, captureBindBuffer)
+    GL_CAPTURE_OVERRIDE(glPixelStorei, capturePixelStorei)
+    GL_CAPTURE_OVERRIDE(glBufferData, captureBufferData)
+    GL_CAPTURE_OVERRIDE(glBufferSubData, captureBufferSubData)
+    GL_CAPTURE_OVERRIDE(glTexImage2D, captureTexImage2D)
+    GL_CAPTURE_OVERRIDE(glTexSubImage2D, captureTexSubImage2D)
+    GL_CAPTURE_OVERRIDE(glTexImage3D, captureTexImage3D)
+    GL_CAPTURE_OVERRIDE(glTexSubImage3D, captureTexSubImage3D)
+    GL_CAPTURE_OVERRIDE(glCompressedTexImage2D, captureCompressedTexImage2D)
+    GL_CAPTURE_OVERRIDE(glCompressedTexSubImage2D, captureCompressedTexSubImage2D)
+    GL_CAPTURE_OVERRIDE(glShaderSource, captureShaderSource)
+    GL_CAPTURE_OVERRIDE(glGenBuffers, capture_glGenBuffersNames)
+    GL_CAPTURE_OVERRIDE(glGenTextures, capture_glGenTexturesNames)
+    GL_CAPTURE_OVERRIDE(glGenVertexArrays, capture_glGenVertexArraysNames)
+    GL_CAPTURE_OVERRIDE(glGenFramebuffers, capture_glGenFramebuffersNames)
+    GL_CAPTURE_OVERRIDE(glGenRenderbuffers, capture_glGenRenderbuffersNames)
+    GL_CAPTURE_OVERRIDE(glGenQueries, capture_glGenQueriesNames)
+    GL_CAPTURE_OVERRIDE(glGenSamplers, capture_glGenSamplersNames)
+    GL_CAPTURE_OVERRIDE(glDeleteBuffers, capture_glDeleteBuffersNames)
+    GL_CAPTURE_OVERRIDE(glDeleteTextures, capture_glDeleteTexturesNames)
+    GL_CAPTURE_OVERRIDE(glDeleteVertexArrays, capture_glDeleteVertexArraysNames)
+    GL_CAPTURE_OVERRIDE(glDeleteFramebuffers, capture_glDeleteFramebuffersNames)
+    GL_CAPTURE_OVERRIDE(glDeleteRenderbuffers, capture_glDeleteRenderbuffersNames)
+    GL_CAPTURE_OVERRIDE(glDeleteQueries, capture_glDeleteQueriesNames)
+    GL_CAPTURE_OVERRIDE(glDeleteSamplers, capture_glDeleteSamplersNames)
+    GL_CAPTURE_OVERRIDE(glDrawBuffers, captureDrawBuffers)
+    GL_CAPTURE_OVERRIDE(glUniform1fv, capture_glUniform1fvVector)
+    GL_CAPTURE_OVERRIDE(glUniform2fv, capture_glUniform2fvVector)
+    GL_CAPTURE_OVERRIDE(glUniform3fv, capture_glUniform3fvVector)
+    GL_CAPTURE_OVERRIDE(glUniform4fv, capture_glUniform4fvVector)
+    GL_CAPTURE_OVERRIDE(glUniform1iv, capture_glUniform1ivVector)
+    GL_CAPTURE_OVERRIDE(glUniform2iv, capture_glUniform2ivVector)
+    GL_CAPTURE_OVERRIDE(glUniform3iv, capture_glUniform3ivVector)
+    GL_CAPTURE_OVERRIDE(glUniform4iv, capture_glUniform4ivVector)
+    GL_CAPTURE_OVERRIDE(glUniform1uiv, capture_glUniform1uivVector)
+    GL_CAPTURE_OVERRIDE(glUniform2uiv, capture_glUniform2uivVector)
+    GL_CAPTURE_OVERRIDE(glUniform3uiv, capture_glUniform3uivVector)
+    GL_CAPTURE_OVERRIDE(glUniform4uiv, capture_glUniform4uivVector)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix2fv, capture_glUniformMatrix2fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix3fv, capture_glUniformMatrix3fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix4fv, capture_glUniformMatrix4fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix2x3fv, capture_glUniformMatrix2x3fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix3x2fv, capture_glUniformMatrix3x2fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix2x4fv, capture_glUniformMatrix2x4fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix4x2fv, capture_glUniformMatrix4x2fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix3x4fv, capture_glUniformMatrix3x4fvMatrix)
+    GL_CAPTURE_OVERRIDE(glUniformMatrix4x3fv, capture_glUniformMatrix4x3fvMatrix)
+    GL_CAPTURE_OVERRIDE(glGetUniformLocation, capture_glGetUniformLocationLocation)
+    GL_CAPTURE_OVERRIDE(glGetAttribLocation, capture_glGetAttribLocationLocation)
+    GL_CAPTURE_OVERRIDE(glGetFragDataLocation, capture_glGetFragDataLocationLocation)
+    GL_CAPTURE_OVERRIDE(glGetUniformBlockIndex, capture_glGetUniformBlockIndexLocation)
+    GL_CAPTURE_OVERRIDE(glBindAttribLocation, capture_glBindAttribLocationName)
+    GL_CAPTURE_OVERRIDE(glBindFragDataLocation, capture_glBindFragDataLocationName)
+    GL_CAPTURE_OVERRIDE(glClearBufferiv, capture_glClearBufferivValues)
+    GL_CAPTURE_OVERRIDE(glClearBufferuiv, capture_glClearBufferuivValues)
+    GL_CAPTURE_OVERRIDE(glClearBufferfv, capture_glClearBufferfvValues)
+    GL_CAPTURE_OVERRIDE(glTexParameterfv, capture_glTexParameterfvValues)
+    GL_CAPTURE_OVERRIDE(glTexParameteriv, capture_glTexParameterivValues)
+    GL_CAPTURE_OVERRIDE(glTexParameterIiv, capture_glTexParameterIivValues)
+    GL_CAPTURE_OVERRIDE(glTexParameterIuiv, capture_glTexParameterIuivValues)
+    GL_CAPTURE_OVERRIDE(glSamplerParameterfv, capture_glSamplerParameterfvValues)
+    GL_CAPTURE_OVERRIDE(glSamplerParameteriv, capture_glSamplerParameterivValues)
+    GL_CAPTURE_OVERRIDE(glSamplerParameterIiv, capture_glSamplerParameterIivValues)
+    GL_CAPTURE_OVERRIDE(glSamplerParameterIuiv, capture_glSamplerParameterIuivValues)
+    GL_CAPTURE_OVERRIDE(glMapBufferRange, captureMapBufferRange)
+    GL_CAPTURE_OVERRIDE(glMapBuffer, captureMapBuffer)
+    GL_CAPTURE_OVERRIDE(glFlushMappedBufferRange, captureFlushMappedBufferRange)
+    GL_CAPTURE_OVERRIDE(glUnmapBuffer, captureUnmapBuffer)
+#undef GL_CAPTURE_OVERRIDE
+
+    capturing = true;
+    std::cout << "GL_CAPTURE:: recording startup and " << frameLimit << " frames to " << capturePath << std::endl;
+}
+
+bool GLCapture::recording()
+{
+    return capturing.load(std::memory_order_relaxed);
+}
+
+void GLCapture::beginFrames()
+{
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if(capturing)
+        writePacket(GL_CAPTURE_STARTUP, 0, NULL, 0);
+}
+
+void GLCapture::endFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        if(!capturing)
+            return;
+        writePacket(GL_CAPTURE_FRAME, 0, NULL, 0);
+        capturedFrames++;
+    }
+    if(capturedFrames >= frameLimit)
+        finish();
+}
+
+void GLCapture::finish()
+{
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if(!capturing)
+        return;
+    capturing = false;
+    captureFile.close();
+
+    char line[256];
+    snprintf(line, sizeof(line), "GL_CAPTURE:: %zu frames, %llu calls, %zu payloads (%llu KiB), %llu KiB deduplicated in %s",
+             capturedFrames, (unsigned long long)capturedCalls, writtenBlobs.size(), (unsigned long long)(blobBytes / 1024),
+             (unsigned long long)(dedupedBytes / 1024), capturePath.c_str());
+    std::cout << line << std::endl;
+}
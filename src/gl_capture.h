@@ -0,0 +1,120 @@
+#ifndef GL_CAPTURE_H
+#define GL_CAPTURE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Records the GL command stream so it can be re-executed without the
+// application by tools/glreplay. ASTEROID_GL_CAPTURE names the file;
+// install() runs right after gladLoadGLLoader (and after GLTrace, if both
+// are on) and wraps the glad pointers like GLTrace does. Everything from
+// startup to the end of frame ASTEROID_CAPTURE_FRAMES (default 60) is
+// recorded, since the frames need the objects created at startup; then the
+// file is closed and the application carries on.
+//
+// Calls from all threads are serialized while recording so the file holds
+// them in the order the driver saw them; each packet names the thread, and
+// the replayer gives every thread its own shared context. Payloads that live
+// in client memory (buffer and texture data, mapped ranges, shader sources,
+// uniform arrays) are stored once per content hash and referenced from the
+// calls that use them, so re-uploading the same data costs 8 bytes. Queries
+// (glGet*, glIs*) are not recorded, except the ones that return locations
+// the replayer must translate. Program binaries bypass glad, so
+// ProgramCache is off while capturing.
+//
+// File layout: GLCaptureHeader, entryCount NUL-terminated entry point names
+// padded to 8 bytes, then packets until the end. Packets and blob bytes are
+// multiples of 8 bytes, so a file loaded at an aligned address can be used
+// in place.
+static const char GL_CAPTURE_MAGIC[8] = {'G', 'L', 'C', 'A', 'P', 'T', '1', '\0'};
+static const uint32_t GL_CAPTURE_VERSION = 1;
+// no slots; ends the startup calls or a frame
+static const uint16_t GL_CAPTURE_FRAME = 0xFFFF;
+static const uint16_t GL_CAPTURE_STARTUP = 0xFFFE;
+// slots hash and length, followed by the bytes padded to 8
+static const uint16_t GL_CAPTURE_BLOB = 0xFFFD;
+// slots target, offset and blob: bytes the thread wrote into its mapping of
+// target, to copy into the replayer's mapping before unmap or flush
+static const uint16_t GL_CAPTURE_MAPPED_WRITE = 0xFFFC;
+
+struct GLCaptureHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    // default framebuffer size, which the replayer emulates with a framebuffer
+    uint32_t width;
+    uint32_t height;
+};
+
+// slotCount 8-byte slots follow. Calls carry one per parameter, plus the
+// result for functions that return one. Bit i of blobs marks slot i as the
+// hash of a blob packet written earlier.
+struct GLCapturePacket {
+    uint16_t entry;
+    uint16_t thread;
+    uint16_t blobs;
+    uint16_t slotCount;
+};
+
+// integers widen, floats keep their bits, pointers travel as addresses
+// (buffer offsets, sync objects) unless they are carried as a blob
+template<typename T>
+inline uint64_t toCaptureSlot(T value)
+{
+    if constexpr(std::is_pointer_v<T>)
+        return (uint64_t)(uintptr_t)value;
+    else if constexpr(std::is_same_v<T, float>)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    else if constexpr(std::is_same_v<T, double>)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    else
+        return (uint64_t)value;
+}
+
+template<typename T>
+inline T fromCaptureSlot(uint64_t slot)
+{
+    if constexpr(std::is_pointer_v<T>)
+        return (T)(uintptr_t)slot;
+    else if constexpr(std::is_same_v<T, float>)
+    {
+        uint32_t bits = (uint32_t)slot;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    else if constexpr(std::is_same_v<T, double>)
+    {
+        double value;
+        std::memcpy(&value, &slot, sizeof(value));
+        return value;
+    }
+    else
+        return (T)slot;
+}
+
+class GLCapture
+{
+    public:
+        static bool requested();
+        // width and height of the default framebuffer
+        static void install(int width, int height);
+        static bool recording();
+
+        static void beginFrames();
+        // closes the file after the last captured frame
+        static void endFrame();
+        static void finish();
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "gl_extensions.h"
+
+#include <string>
+#include <unordered_set>
+
+// whatever gladLoadGLLoader was given: GLFW in the application, NullGL
+// headless, nothing in the offline tools
+static GLADloadproc loader = NULL;
+
+// filled by setGLLoader on the GL thread before any other thread starts and
+// only read afterwards; the extension list cannot change for the lifetime of
+// the context
+static std::unordered_set<std::string> extensions;
+static bool s3tcSupported = false;
+static bool bptcSupported = false;
+
+void setGLLoader(GLADloadproc proc)
+{
+    loader = proc;
+
+    extensions.clear();
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for(GLint i = 0; i < count; i++)
+    {
+        const GLubyte *extension = glGetStringi(GL_EXTENSIONS, i);
+        if(extension)
+            extensions.insert((const char*)extension);
+    }
+    s3tcSupported = hasGLExtension("GL_EXT_texture_compression_s3tc");
+    bptcSupported = hasGLExtension("GL_ARB_texture_compression_bptc") || GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 2);
+}
+
+bool hasGLExtension(const char *name)
+{
+    return extensions.count(name) > 0;
+}
+
+bool supportsCompressedFormat(GLenum internalFormat)
+{
+    switch(internalFormat)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            return s3tcSupported;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+            return bptcSupported;
+        default:
+            return false;
+    }
+}
+
+const ProgramBinaryFunctions* programBinaryFunctions()
+{
+    static ProgramBinaryFunctions functions;
+    static bool queried = false;
+    static bool supported = false;
+    if(!queried)
+    {
+        queried = true;
+        bool core = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1);
+        if(!loader || (!core && !hasGLExtension("GL_ARB_get_program_binary")))
+            return NULL;
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        functions.getProgramBinary = (void (APIENTRYP)(GLuint, GLsizei, GLsizei*, GLenum*, void*))loader("glGetProgramBinary");
+        functions.programBinary = (void (APIENTRYP)(GLuint, GLenum, const void*, GLsizei))loader("glProgramBinary");
+        functions.programParameteri = (void (APIENTRYP)(GLuint, GLenum, GLint))loader("glProgramParameteri");
+        supported = formats > 0 && functions.getProgramBinary && functions.programBinary && functions.programParameteri;
+    }
+    return supported ? &functions : NULL;
+}
+
+bool parallelShaderCompile()
+{
+    static bool queried = false;
+    static bool supported = false;
+    if(!queried)
+    {
+        queried = true;
+        const char *name = NULL;
+        if(hasGLExtension("GL_KHR_parallel_shader_compile"))
+            name = "glMaxShaderCompilerThreadsKHR";
+        else if(hasGLExtension("GL_ARB_parallel_shader_compile"))
+            name = "glMaxShaderCompilerThreadsARB";
+        if(!name || !loader)
+            return false;
+
+        void (APIENTRYP maxShaderCompilerThreads)(GLuint count) = (void (APIENTRYP)(GLuint))loader(name);
+        if(maxShaderCompilerThreads)
+        {
+            maxShaderCompilerThreads(0xFFFFFFFFu);
+            supported = true;
+        }
+    }
+    return supported;
+}
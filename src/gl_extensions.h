@@ -0,0 +1,52 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+
+// glad is generated for plain 3.3 core, so the few extension enums we rely on
+// are declared here and checked for at runtime with hasGLExtension.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// ARB_get_program_binary (core in 4.1), loaded by hand for the same reason
+struct ProgramBinaryFunctions {
+    void (APIENTRYP getProgramBinary)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+    void (APIENTRYP programBinary)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+    void (APIENTRYP programParameteri)(GLuint program, GLenum pname, GLint value);
+};
+
+// the loader passed to gladLoadGLLoader; the entry points below are loaded
+// through it, and without one they report no support. Call it on the GL
+// thread right after gladLoadGLLoader: it also reads the extension list and
+// resolves the compressed formats once, so the two queries below make no GL
+// calls and are safe from any thread (texture reads run on worker threads)
+void setGLLoader(GLADloadproc loader);
+bool hasGLExtension(const char *name);
+bool supportsCompressedFormat(GLenum internalFormat);
+// NULL when the driver has no program binary support or no binary formats
+const ProgramBinaryFunctions* programBinaryFunctions();
+// KHR/ARB_parallel_shader_compile; the first call lets the driver use as
+// many compiler threads as it likes, after which GL_COMPLETION_STATUS_KHR can
+// be polled without blocking
+bool parallelShaderCompile();
+
+#endif
@@ -0,0 +1,382 @@
+#ifndef GL_FUNCTION
+#error "define GL_FUNCTION(ret, name, params, args) before including gl_functions.h"
+#endif
+
+// Every entry point glad loads for GL 3.3 core, in glad.h order; generated
+// from include/glad/glad.h. Included as an X-macro by null_gl.cpp and
+// gl_trace.cpp; args repeats the parameter names for forwarding calls.
+
+GL_FUNCTION(void, glCullFace, (GLenum mode), (mode))
+GL_FUNCTION(void, glFrontFace, (GLenum mode), (mode))
+GL_FUNCTION(void, glHint, (GLenum target, GLenum mode), (target, mode))
+GL_FUNCTION(void, glLineWidth, (GLfloat width), (width))
+GL_FUNCTION(void, glPointSize, (GLfloat size), (size))
+GL_FUNCTION(void, glPolygonMode, (GLenum face, GLenum mode), (face, mode))
+GL_FUNCTION(void, glScissor, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+GL_FUNCTION(void, glTexParameterf, (GLenum target, GLenum pname, GLfloat param), (target, pname, param))
+GL_FUNCTION(void, glTexParameterfv, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params))
+GL_FUNCTION(void, glTexParameteri, (GLenum target, GLenum pname, GLint param), (target, pname, param))
+GL_FUNCTION(void, glTexParameteriv, (GLenum target, GLenum pname, const GLint *params), (target, pname, params))
+GL_FUNCTION(void, glTexImage1D, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, border, format, type, pixels))
+GL_FUNCTION(void, glTexImage2D, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, border, format, type, pixels))
+GL_FUNCTION(void, glDrawBuffer, (GLenum buf), (buf))
+GL_FUNCTION(void, glClear, (GLbitfield mask), (mask))
+GL_FUNCTION(void, glClearColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha))
+GL_FUNCTION(void, glClearStencil, (GLint s), (s))
+GL_FUNCTION(void, glClearDepth, (GLdouble depth), (depth))
+GL_FUNCTION(void, glStencilMask, (GLuint mask), (mask))
+GL_FUNCTION(void, glColorMask, (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha), (red, green, blue, alpha))
+GL_FUNCTION(void, glDepthMask, (GLboolean flag), (flag))
+GL_FUNCTION(void, glDisable, (GLenum cap), (cap))
+GL_FUNCTION(void, glEnable, (GLenum cap), (cap))
+GL_FUNCTION(void, glFinish, (void), ())
+GL_FUNCTION(void, glFlush, (void), ())
+GL_FUNCTION(void, glBlendFunc, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor))
+GL_FUNCTION(void, glLogicOp, (GLenum opcode), (opcode))
+GL_FUNCTION(void, glStencilFunc, (GLenum func, GLint ref, GLuint mask), (func, ref, mask))
+GL_FUNCTION(void, glStencilOp, (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass))
+GL_FUNCTION(void, glDepthFunc, (GLenum func), (func))
+GL_FUNCTION(void, glPixelStoref, (GLenum pname, GLfloat param), (pname, param))
+GL_FUNCTION(void, glPixelStorei, (GLenum pname, GLint param), (pname, param))
+GL_FUNCTION(void, glReadBuffer, (GLenum src), (src))
+GL_FUNCTION(void, glReadPixels, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels), (x, y, width, height, format, type, pixels))
+GL_FUNCTION(void, glGetBooleanv, (GLenum pname, GLboolean *data), (pname, data))
+GL_FUNCTION(void, glGetDoublev, (GLenum pname, GLdouble *data), (pname, data))
+GL_FUNCTION(GLenum, glGetError, (void), ())
+GL_FUNCTION(void, glGetFloatv, (GLenum pname, GLfloat *data), (pname, data))
+GL_FUNCTION(void, glGetIntegerv, (GLenum pname, GLint *data), (pname, data))
+GL_FUNCTION(const GLubyte *, glGetString, (GLenum name), (name))
+GL_FUNCTION(void, glGetTexImage, (GLenum target, GLint level, GLenum format, GLenum type, void *pixels), (target, level, format, type, pixels))
+GL_FUNCTION(void, glGetTexParameterfv, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params))
+GL_FUNCTION(void, glGetTexParameteriv, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GL_FUNCTION(void, glGetTexLevelParameterfv, (GLenum target, GLint level, GLenum pname, GLfloat *params), (target, level, pname, params))
+GL_FUNCTION(void, glGetTexLevelParameteriv, (GLenum target, GLint level, GLenum pname, GLint *params), (target, level, pname, params))
+GL_FUNCTION(GLboolean, glIsEnabled, (GLenum cap), (cap))
+GL_FUNCTION(void, glDepthRange, (GLdouble n, GLdouble f), (n, f))
+GL_FUNCTION(void, glViewport, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+GL_FUNCTION(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count), (mode, first, count))
+GL_FUNCTION(void, glDrawElements, (GLenum mode, GLsizei count, GLenum type, const void *indices), (mode, count, type, indices))
+GL_FUNCTION(void, glPolygonOffset, (GLfloat factor, GLfloat units), (factor, units))
+GL_FUNCTION(void, glCopyTexImage1D, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border), (target, level, internalformat, x, y, width, border))
+GL_FUNCTION(void, glCopyTexImage2D, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border), (target, level, internalformat, x, y, width, height, border))
+GL_FUNCTION(void, glCopyTexSubImage1D, (GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width), (target, level, xoffset, x, y, width))
+GL_FUNCTION(void, glCopyTexSubImage2D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, x, y, width, height))
+GL_FUNCTION(void, glTexSubImage1D, (GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, width, format, type, pixels))
+GL_FUNCTION(void, glTexSubImage2D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels))
+GL_FUNCTION(void, glBindTexture, (GLenum target, GLuint texture), (target, texture))
+GL_FUNCTION(void, glDeleteTextures, (GLsizei n, const GLuint *textures), (n, textures))
+GL_FUNCTION(void, glGenTextures, (GLsizei n, GLuint *textures), (n, textures))
+GL_FUNCTION(GLboolean, glIsTexture, (GLuint texture), (texture))
+GL_FUNCTION(void, glDrawRangeElements, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices), (mode, start, end, count, type, indices))
+GL_FUNCTION(void, glTexImage3D, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, depth, border, format, type, pixels))
+GL_FUNCTION(void, glTexSubImage3D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels))
+GL_FUNCTION(void, glCopyTexSubImage3D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, zoffset, x, y, width, height))
+GL_FUNCTION(void, glActiveTexture, (GLenum texture), (texture))
+GL_FUNCTION(void, glSampleCoverage, (GLfloat value, GLboolean invert), (value, invert))
+GL_FUNCTION(void, glCompressedTexImage3D, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, depth, border, imageSize, data))
+GL_FUNCTION(void, glCompressedTexImage2D, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, border, imageSize, data))
+GL_FUNCTION(void, glCompressedTexImage1D, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, border, imageSize, data))
+GL_FUNCTION(void, glCompressedTexSubImage3D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data))
+GL_FUNCTION(void, glCompressedTexSubImage2D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, width, height, format, imageSize, data))
+GL_FUNCTION(void, glCompressedTexSubImage1D, (GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, width, format, imageSize, data))
+GL_FUNCTION(void, glGetCompressedTexImage, (GLenum target, GLint level, void *img), (target, level, img))
+GL_FUNCTION(void, glBlendFuncSeparate, (GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha), (sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha))
+GL_FUNCTION(void, glMultiDrawArrays, (GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount), (mode, first, count, drawcount))
+GL_FUNCTION(void, glMultiDrawElements, (GLenum mode, const GLsizei *count, GLenum type, const void *const*indices, GLsizei drawcount), (mode, count, type, indices, drawcount))
+GL_FUNCTION(void, glPointParameterf, (GLenum pname, GLfloat param), (pname, param))
+GL_FUNCTION(void, glPointParameterfv, (GLenum pname, const GLfloat *params), (pname, params))
+GL_FUNCTION(void, glPointParameteri, (GLenum pname, GLint param), (pname, param))
+GL_FUNCTION(void, glPointParameteriv, (GLenum pname, const GLint *params), (pname, params))
+GL_FUNCTION(void, glBlendColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha))
+GL_FUNCTION(void, glBlendEquation, (GLenum mode), (mode))
+GL_FUNCTION(void, glGenQueries, (GLsizei n, GLuint *ids), (n, ids))
+GL_FUNCTION(void, glDeleteQueries, (GLsizei n, const GLuint *ids), (n, ids))
+GL_FUNCTION(GLboolean, glIsQuery, (GLuint id), (id))
+GL_FUNCTION(void, glBeginQuery, (GLenum target, GLuint id), (target, id))
+GL_FUNCTION(void, glEndQuery, (GLenum target), (target))
+GL_FUNCTION(void, glGetQueryiv, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GL_FUNCTION(void, glGetQueryObjectiv, (GLuint id, GLenum pname, GLint *params), (id, pname, params))
+GL_FUNCTION(void, glGetQueryObjectuiv, (GLuint id, GLenum pname, GLuint *params), (id, pname, params))
+GL_FUNCTION(void, glBindBuffer, (GLenum target, GLuint buffer), (target, buffer))
+GL_FUNCTION(void, glDeleteBuffers, (GLsizei n, const GLuint *buffers), (n, buffers))
+GL_FUNCTION(void, glGenBuffers, (GLsizei n, GLuint *buffers), (n, buffers))
+GL_FUNCTION(GLboolean, glIsBuffer, (GLuint buffer), (buffer))
+GL_FUNCTION(void, glBufferData, (GLenum target, GLsizeiptr size, const void *data, GLenum usage), (target, size, data, usage))
+GL_FUNCTION(void, glBufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, const void *data), (target, offset, size, data))
+GL_FUNCTION(void, glGetBufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, void *data), (target, offset, size, data))
+GL_FUNCTION(void *, glMapBuffer, (GLenum target, GLenum access), (target, access))
+GL_FUNCTION(GLboolean, glUnmapBuffer, (GLenum target), (target))
+GL_FUNCTION(void, glGetBufferParameteriv, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GL_FUNCTION(void, glGetBufferPointerv, (GLenum target, GLenum pname, void **params), (target, pname, params))
+GL_FUNCTION(void, glBlendEquationSeparate, (GLenum modeRGB, GLenum modeAlpha), (modeRGB, modeAlpha))
+GL_FUNCTION(void, glDrawBuffers, (GLsizei n, const GLenum *bufs), (n, bufs))
+GL_FUNCTION(void, glStencilOpSeparate, (GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass), (face, sfail, dpfail, dppass))
+GL_FUNCTION(void, glStencilFuncSeparate, (GLenum face, GLenum func, GLint ref, GLuint mask), (face, func, ref, mask))
+GL_FUNCTION(void, glStencilMaskSeparate, (GLenum face, GLuint mask), (face, mask))
+GL_FUNCTION(void, glAttachShader, (GLuint program, GLuint shader), (program, shader))
+GL_FUNCTION(void, glBindAttribLocation, (GLuint program, GLuint index, const GLchar *name), (program, index, name))
+GL_FUNCTION(void, glCompileShader, (GLuint shader), (shader))
+GL_FUNCTION(GLuint, glCreateProgram, (void), ())
+GL_FUNCTION(GLuint, glCreateShader, (GLenum type), (type))
+GL_FUNCTION(void, glDeleteProgram, (GLuint program), (program))
+GL_FUNCTION(void, glDeleteShader, (GLuint shader), (shader))
+GL_FUNCTION(void, glDetachShader, (GLuint program, GLuint shader), (program, shader))
+GL_FUNCTION(void, glDisableVertexAttribArray, (GLuint index), (index))
+GL_FUNCTION(void, glEnableVertexAttribArray, (GLuint index), (index))
+GL_FUNCTION(void, glGetActiveAttrib, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name))
+GL_FUNCTION(void, glGetActiveUniform, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name))
+GL_FUNCTION(void, glGetAttachedShaders, (GLuint program, GLsizei maxCount, GLsizei *count, GLuint *shaders), (program, maxCount, count, shaders))
+GL_FUNCTION(GLint, glGetAttribLocation, (GLuint program, const GLchar *name), (program, name))
+GL_FUNCTION(void, glGetProgramiv, (GLuint program, GLenum pname, GLint *params), (program, pname, params))
+GL_FUNCTION(void, glGetProgramInfoLog, (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (program, bufSize, length, infoLog))
+GL_FUNCTION(void, glGetShaderiv, (GLuint shader, GLenum pname, GLint *params), (shader, pname, params))
+GL_FUNCTION(void, glGetShaderInfoLog, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (shader, bufSize, length, infoLog))
+GL_FUNCTION(void, glGetShaderSource, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *source), (shader, bufSize, length, source))
+GL_FUNCTION(GLint, glGetUniformLocation, (GLuint program, const GLchar *name), (program, name))
+GL_FUNCTION(void, glGetUniformfv, (GLuint program, GLint location, GLfloat *params), (program, location, params))
+GL_FUNCTION(void, glGetUniformiv, (GLuint program, GLint location, GLint *params), (program, location, params))
+GL_FUNCTION(void, glGetVertexAttribdv, (GLuint index, GLenum pname, GLdouble *params), (index, pname, params))
+GL_FUNCTION(void, glGetVertexAttribfv, (GLuint index, GLenum pname, GLfloat *params), (index, pname, params))
+GL_FUNCTION(void, glGetVertexAttribiv, (GLuint index, GLenum pname, GLint *params), (index, pname, params))
+GL_FUNCTION(void, glGetVertexAttribPointerv, (GLuint index, GLenum pname, void **pointer), (index, pname, pointer))
+GL_FUNCTION(GLboolean, glIsProgram, (GLuint program), (program))
+GL_FUNCTION(GLboolean, glIsShader, (GLuint shader), (shader))
+GL_FUNCTION(void, glLinkProgram, (GLuint program), (program))
+GL_FUNCTION(void, glShaderSource, (GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length), (shader, count, string, length))
+GL_FUNCTION(void, glUseProgram, (GLuint program), (program))
+GL_FUNCTION(void, glUniform1f, (GLint location, GLfloat v0), (location, v0))
+GL_FUNCTION(void, glUniform2f, (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1))
+GL_FUNCTION(void, glUniform3f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2))
+GL_FUNCTION(void, glUniform4f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3))
+GL_FUNCTION(void, glUniform1i, (GLint location, GLint v0), (location, v0))
+GL_FUNCTION(void, glUniform2i, (GLint location, GLint v0, GLint v1), (location, v0, v1))
+GL_FUNCTION(void, glUniform3i, (GLint location, GLint v0, GLint v1, GLint v2), (location, v0, v1, v2))
+GL_FUNCTION(void, glUniform4i, (GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (location, v0, v1, v2, v3))
+GL_FUNCTION(void, glUniform1fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniform2fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniform3fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniform4fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniform1iv, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GL_FUNCTION(void, glUniform2iv, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GL_FUNCTION(void, glUniform3iv, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GL_FUNCTION(void, glUniform4iv, (GLint location, GLsizei count, const GLint *value), (location, count, value))
+GL_FUNCTION(void, glUniformMatrix2fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix3fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glValidateProgram, (GLuint program), (program))
+GL_FUNCTION(void, glVertexAttrib1d, (GLuint index, GLdouble x), (index, x))
+GL_FUNCTION(void, glVertexAttrib1dv, (GLuint index, const GLdouble *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib1f, (GLuint index, GLfloat x), (index, x))
+GL_FUNCTION(void, glVertexAttrib1fv, (GLuint index, const GLfloat *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib1s, (GLuint index, GLshort x), (index, x))
+GL_FUNCTION(void, glVertexAttrib1sv, (GLuint index, const GLshort *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib2d, (GLuint index, GLdouble x, GLdouble y), (index, x, y))
+GL_FUNCTION(void, glVertexAttrib2dv, (GLuint index, const GLdouble *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib2f, (GLuint index, GLfloat x, GLfloat y), (index, x, y))
+GL_FUNCTION(void, glVertexAttrib2fv, (GLuint index, const GLfloat *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib2s, (GLuint index, GLshort x, GLshort y), (index, x, y))
+GL_FUNCTION(void, glVertexAttrib2sv, (GLuint index, const GLshort *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib3d, (GLuint index, GLdouble x, GLdouble y, GLdouble z), (index, x, y, z))
+GL_FUNCTION(void, glVertexAttrib3dv, (GLuint index, const GLdouble *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib3f, (GLuint index, GLfloat x, GLfloat y, GLfloat z), (index, x, y, z))
+GL_FUNCTION(void, glVertexAttrib3fv, (GLuint index, const GLfloat *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib3s, (GLuint index, GLshort x, GLshort y, GLshort z), (index, x, y, z))
+GL_FUNCTION(void, glVertexAttrib3sv, (GLuint index, const GLshort *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4Nbv, (GLuint index, const GLbyte *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4Niv, (GLuint index, const GLint *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4Nsv, (GLuint index, const GLshort *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4Nub, (GLuint index, GLubyte x, GLubyte y, GLubyte z, GLubyte w), (index, x, y, z, w))
+GL_FUNCTION(void, glVertexAttrib4Nubv, (GLuint index, const GLubyte *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4Nuiv, (GLuint index, const GLuint *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4Nusv, (GLuint index, const GLushort *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4bv, (GLuint index, const GLbyte *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4d, (GLuint index, GLdouble x, GLdouble y, GLdouble z, GLdouble w), (index, x, y, z, w))
+GL_FUNCTION(void, glVertexAttrib4dv, (GLuint index, const GLdouble *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4f, (GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (index, x, y, z, w))
+GL_FUNCTION(void, glVertexAttrib4fv, (GLuint index, const GLfloat *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4iv, (GLuint index, const GLint *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4s, (GLuint index, GLshort x, GLshort y, GLshort z, GLshort w), (index, x, y, z, w))
+GL_FUNCTION(void, glVertexAttrib4sv, (GLuint index, const GLshort *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4ubv, (GLuint index, const GLubyte *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4uiv, (GLuint index, const GLuint *v), (index, v))
+GL_FUNCTION(void, glVertexAttrib4usv, (GLuint index, const GLushort *v), (index, v))
+GL_FUNCTION(void, glVertexAttribPointer, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer), (index, size, type, normalized, stride, pointer))
+GL_FUNCTION(void, glUniformMatrix2x3fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix3x2fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix2x4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix4x2fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix3x4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glUniformMatrix4x3fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(void, glColorMaski, (GLuint index, GLboolean r, GLboolean g, GLboolean b, GLboolean a), (index, r, g, b, a))
+GL_FUNCTION(void, glGetBooleani_v, (GLenum target, GLuint index, GLboolean *data), (target, index, data))
+GL_FUNCTION(void, glGetIntegeri_v, (GLenum target, GLuint index, GLint *data), (target, index, data))
+GL_FUNCTION(void, glEnablei, (GLenum target, GLuint index), (target, index))
+GL_FUNCTION(void, glDisablei, (GLenum target, GLuint index), (target, index))
+GL_FUNCTION(GLboolean, glIsEnabledi, (GLenum target, GLuint index), (target, index))
+GL_FUNCTION(void, glBeginTransformFeedback, (GLenum primitiveMode), (primitiveMode))
+GL_FUNCTION(void, glEndTransformFeedback, (void), ())
+GL_FUNCTION(void, glBindBufferRange, (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size), (target, index, buffer, offset, size))
+GL_FUNCTION(void, glBindBufferBase, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer))
+GL_FUNCTION(void, glTransformFeedbackVaryings, (GLuint program, GLsizei count, const GLchar *const*varyings, GLenum bufferMode), (program, count, varyings, bufferMode))
+GL_FUNCTION(void, glGetTransformFeedbackVarying, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLsizei *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name))
+GL_FUNCTION(void, glClampColor, (GLenum target, GLenum clamp), (target, clamp))
+GL_FUNCTION(void, glBeginConditionalRender, (GLuint id, GLenum mode), (id, mode))
+GL_FUNCTION(void, glEndConditionalRender, (void), ())
+GL_FUNCTION(void, glVertexAttribIPointer, (GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer), (index, size, type, stride, pointer))
+GL_FUNCTION(void, glGetVertexAttribIiv, (GLuint index, GLenum pname, GLint *params), (index, pname, params))
+GL_FUNCTION(void, glGetVertexAttribIuiv, (GLuint index, GLenum pname, GLuint *params), (index, pname, params))
+GL_FUNCTION(void, glVertexAttribI1i, (GLuint index, GLint x), (index, x))
+GL_FUNCTION(void, glVertexAttribI2i, (GLuint index, GLint x, GLint y), (index, x, y))
+GL_FUNCTION(void, glVertexAttribI3i, (GLuint index, GLint x, GLint y, GLint z), (index, x, y, z))
+GL_FUNCTION(void, glVertexAttribI4i, (GLuint index, GLint x, GLint y, GLint z, GLint w), (index, x, y, z, w))
+GL_FUNCTION(void, glVertexAttribI1ui, (GLuint index, GLuint x), (index, x))
+GL_FUNCTION(void, glVertexAttribI2ui, (GLuint index, GLuint x, GLuint y), (index, x, y))
+GL_FUNCTION(void, glVertexAttribI3ui, (GLuint index, GLuint x, GLuint y, GLuint z), (index, x, y, z))
+GL_FUNCTION(void, glVertexAttribI4ui, (GLuint index, GLuint x, GLuint y, GLuint z, GLuint w), (index, x, y, z, w))
+GL_FUNCTION(void, glVertexAttribI1iv, (GLuint index, const GLint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI2iv, (GLuint index, const GLint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI3iv, (GLuint index, const GLint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI4iv, (GLuint index, const GLint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI1uiv, (GLuint index, const GLuint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI2uiv, (GLuint index, const GLuint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI3uiv, (GLuint index, const GLuint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI4uiv, (GLuint index, const GLuint *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI4bv, (GLuint index, const GLbyte *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI4sv, (GLuint index, const GLshort *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI4ubv, (GLuint index, const GLubyte *v), (index, v))
+GL_FUNCTION(void, glVertexAttribI4usv, (GLuint index, const GLushort *v), (index, v))
+GL_FUNCTION(void, glGetUniformuiv, (GLuint program, GLint location, GLuint *params), (program, location, params))
+GL_FUNCTION(void, glBindFragDataLocation, (GLuint program, GLuint color, const GLchar *name), (program, color, name))
+GL_FUNCTION(GLint, glGetFragDataLocation, (GLuint program, const GLchar *name), (program, name))
+GL_FUNCTION(void, glUniform1ui, (GLint location, GLuint v0), (location, v0))
+GL_FUNCTION(void, glUniform2ui, (GLint location, GLuint v0, GLuint v1), (location, v0, v1))
+GL_FUNCTION(void, glUniform3ui, (GLint location, GLuint v0, GLuint v1, GLuint v2), (location, v0, v1, v2))
+GL_FUNCTION(void, glUniform4ui, (GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3), (location, v0, v1, v2, v3))
+GL_FUNCTION(void, glUniform1uiv, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GL_FUNCTION(void, glUniform2uiv, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GL_FUNCTION(void, glUniform3uiv, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GL_FUNCTION(void, glUniform4uiv, (GLint location, GLsizei count, const GLuint *value), (location, count, value))
+GL_FUNCTION(void, glTexParameterIiv, (GLenum target, GLenum pname, const GLint *params), (target, pname, params))
+GL_FUNCTION(void, glTexParameterIuiv, (GLenum target, GLenum pname, const GLuint *params), (target, pname, params))
+GL_FUNCTION(void, glGetTexParameterIiv, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GL_FUNCTION(void, glGetTexParameterIuiv, (GLenum target, GLenum pname, GLuint *params), (target, pname, params))
+GL_FUNCTION(void, glClearBufferiv, (GLenum buffer, GLint drawbuffer, const GLint *value), (buffer, drawbuffer, value))
+GL_FUNCTION(void, glClearBufferuiv, (GLenum buffer, GLint drawbuffer, const GLuint *value), (buffer, drawbuffer, value))
+GL_FUNCTION(void, glClearBufferfv, (GLenum buffer, GLint drawbuffer, const GLfloat *value), (buffer, drawbuffer, value))
+GL_FUNCTION(void, glClearBufferfi, (GLenum buffer, GLint drawbuffer, GLfloat depth, GLint stencil), (buffer, drawbuffer, depth, stencil))
+GL_FUNCTION(const GLubyte *, glGetStringi, (GLenum name, GLuint index), (name, index))
+GL_FUNCTION(GLboolean, glIsRenderbuffer, (GLuint renderbuffer), (renderbuffer))
+GL_FUNCTION(void, glBindRenderbuffer, (GLenum target, GLuint renderbuffer), (target, renderbuffer))
+GL_FUNCTION(void, glDeleteRenderbuffers, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers))
+GL_FUNCTION(void, glGenRenderbuffers, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers))
+GL_FUNCTION(void, glRenderbufferStorage, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height))
+GL_FUNCTION(void, glGetRenderbufferParameteriv, (GLenum target, GLenum pname, GLint *params), (target, pname, params))
+GL_FUNCTION(GLboolean, glIsFramebuffer, (GLuint framebuffer), (framebuffer))
+GL_FUNCTION(void, glBindFramebuffer, (GLenum target, GLuint framebuffer), (target, framebuffer))
+GL_FUNCTION(void, glDeleteFramebuffers, (GLsizei n, const GLuint *framebuffers), (n, framebuffers))
+GL_FUNCTION(void, glGenFramebuffers, (GLsizei n, GLuint *framebuffers), (n, framebuffers))
+GL_FUNCTION(GLenum, glCheckFramebufferStatus, (GLenum target), (target))
+GL_FUNCTION(void, glFramebufferTexture1D, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level))
+GL_FUNCTION(void, glFramebufferTexture2D, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level))
+GL_FUNCTION(void, glFramebufferTexture3D, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset), (target, attachment, textarget, texture, level, zoffset))
+GL_FUNCTION(void, glFramebufferRenderbuffer, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer))
+GL_FUNCTION(void, glGetFramebufferAttachmentParameteriv, (GLenum target, GLenum attachment, GLenum pname, GLint *params), (target, attachment, pname, params))
+GL_FUNCTION(void, glGenerateMipmap, (GLenum target), (target))
+GL_FUNCTION(void, glBlitFramebuffer, (GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter), (srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter))
+GL_FUNCTION(void, glRenderbufferStorageMultisample, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height), (target, samples, internalformat, width, height))
+GL_FUNCTION(void, glFramebufferTextureLayer, (GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer), (target, attachment, texture, level, layer))
+GL_FUNCTION(void *, glMapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access))
+GL_FUNCTION(void, glFlushMappedBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length), (target, offset, length))
+GL_FUNCTION(void, glBindVertexArray, (GLuint array), (array))
+GL_FUNCTION(void, glDeleteVertexArrays, (GLsizei n, const GLuint *arrays), (n, arrays))
+GL_FUNCTION(void, glGenVertexArrays, (GLsizei n, GLuint *arrays), (n, arrays))
+GL_FUNCTION(GLboolean, glIsVertexArray, (GLuint array), (array))
+GL_FUNCTION(void, glDrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount), (mode, first, count, instancecount))
+GL_FUNCTION(void, glDrawElementsInstanced, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount), (mode, count, type, indices, instancecount))
+GL_FUNCTION(void, glTexBuffer, (GLenum target, GLenum internalformat, GLuint buffer), (target, internalformat, buffer))
+GL_FUNCTION(void, glPrimitiveRestartIndex, (GLuint index), (index))
+GL_FUNCTION(void, glCopyBufferSubData, (GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size), (readTarget, writeTarget, readOffset, writeOffset, size))
+GL_FUNCTION(void, glGetUniformIndices, (GLuint program, GLsizei uniformCount, const GLchar *const*uniformNames, GLuint *uniformIndices), (program, uniformCount, uniformNames, uniformIndices))
+GL_FUNCTION(void, glGetActiveUniformsiv, (GLuint program, GLsizei uniformCount, const GLuint *uniformIndices, GLenum pname, GLint *params), (program, uniformCount, uniformIndices, pname, params))
+GL_FUNCTION(void, glGetActiveUniformName, (GLuint program, GLuint uniformIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformName), (program, uniformIndex, bufSize, length, uniformName))
+GL_FUNCTION(GLuint, glGetUniformBlockIndex, (GLuint program, const GLchar *uniformBlockName), (program, uniformBlockName))
+GL_FUNCTION(void, glGetActiveUniformBlockiv, (GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params), (program, uniformBlockIndex, pname, params))
+GL_FUNCTION(void, glGetActiveUniformBlockName, (GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName), (program, uniformBlockIndex, bufSize, length, uniformBlockName))
+GL_FUNCTION(void, glUniformBlockBinding, (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding), (program, uniformBlockIndex, uniformBlockBinding))
+GL_FUNCTION(void, glDrawElementsBaseVertex, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex), (mode, count, type, indices, basevertex))
+GL_FUNCTION(void, glDrawRangeElementsBaseVertex, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices, GLint basevertex), (mode, start, end, count, type, indices, basevertex))
+GL_FUNCTION(void, glDrawElementsInstancedBaseVertex, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex), (mode, count, type, indices, instancecount, basevertex))
+GL_FUNCTION(void, glMultiDrawElementsBaseVertex, (GLenum mode, const GLsizei *count, GLenum type, const void *const*indices, GLsizei drawcount, const GLint *basevertex), (mode, count, type, indices, drawcount, basevertex))
+GL_FUNCTION(void, glProvokingVertex, (GLenum mode), (mode))
+GL_FUNCTION(GLsync, glFenceSync, (GLenum condition, GLbitfield flags), (condition, flags))
+GL_FUNCTION(GLboolean, glIsSync, (GLsync sync), (sync))
+GL_FUNCTION(void, glDeleteSync, (GLsync sync), (sync))
+GL_FUNCTION(GLenum, glClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout))
+GL_FUNCTION(void, glWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout))
+GL_FUNCTION(void, glGetInteger64v, (GLenum pname, GLint64 *data), (pname, data))
+GL_FUNCTION(void, glGetSynciv, (GLsync sync, GLenum pname, GLsizei count, GLsizei *length, GLint *values), (sync, pname, count, length, values))
+GL_FUNCTION(void, glGetInteger64i_v, (GLenum target, GLuint index, GLint64 *data), (target, index, data))
+GL_FUNCTION(void, glGetBufferParameteri64v, (GLenum target, GLenum pname, GLint64 *params), (target, pname, params))
+GL_FUNCTION(void, glFramebufferTexture, (GLenum target, GLenum attachment, GLuint texture, GLint level), (target, attachment, texture, level))
+GL_FUNCTION(void, glTexImage2DMultisample, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, fixedsamplelocations))
+GL_FUNCTION(void, glTexImage3DMultisample, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, depth, fixedsamplelocations))
+GL_FUNCTION(void, glGetMultisamplefv, (GLenum pname, GLuint index, GLfloat *val), (pname, index, val))
+GL_FUNCTION(void, glSampleMaski, (GLuint maskNumber, GLbitfield mask), (maskNumber, mask))
+GL_FUNCTION(void, glBindFragDataLocationIndexed, (GLuint program, GLuint colorNumber, GLuint index, const GLchar *name), (program, colorNumber, index, name))
+GL_FUNCTION(GLint, glGetFragDataIndex, (GLuint program, const GLchar *name), (program, name))
+GL_FUNCTION(void, glGenSamplers, (GLsizei count, GLuint *samplers), (count, samplers))
+GL_FUNCTION(void, glDeleteSamplers, (GLsizei count, const GLuint *samplers), (count, samplers))
+GL_FUNCTION(GLboolean, glIsSampler, (GLuint sampler), (sampler))
+GL_FUNCTION(void, glBindSampler, (GLuint unit, GLuint sampler), (unit, sampler))
+GL_FUNCTION(void, glSamplerParameteri, (GLuint sampler, GLenum pname, GLint param), (sampler, pname, param))
+GL_FUNCTION(void, glSamplerParameteriv, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param))
+GL_FUNCTION(void, glSamplerParameterf, (GLuint sampler, GLenum pname, GLfloat param), (sampler, pname, param))
+GL_FUNCTION(void, glSamplerParameterfv, (GLuint sampler, GLenum pname, const GLfloat *param), (sampler, pname, param))
+GL_FUNCTION(void, glSamplerParameterIiv, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param))
+GL_FUNCTION(void, glSamplerParameterIuiv, (GLuint sampler, GLenum pname, const GLuint *param), (sampler, pname, param))
+GL_FUNCTION(void, glGetSamplerParameteriv, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params))
+GL_FUNCTION(void, glGetSamplerParameterIiv, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params))
+GL_FUNCTION(void, glGetSamplerParameterfv, (GLuint sampler, GLenum pname, GLfloat *params), (sampler, pname, params))
+GL_FUNCTION(void, glGetSamplerParameterIuiv, (GLuint sampler, GLenum pname, GLuint *params), (sampler, pname, params))
+GL_FUNCTION(void, glQueryCounter, (GLuint id, GLenum target), (id, target))
+GL_FUNCTION(void, glGetQueryObjecti64v, (GLuint id, GLenum pname, GLint64 *params), (id, pname, params))
+GL_FUNCTION(void, glGetQueryObjectui64v, (GLuint id, GLenum pname, GLuint64 *params), (id, pname, params))
+GL_FUNCTION(void, glVertexAttribDivisor, (GLuint index, GLuint divisor), (index, divisor))
+GL_FUNCTION(void, glVertexAttribP1ui, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP1uiv, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP2ui, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP2uiv, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP3ui, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP3uiv, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP4ui, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexAttribP4uiv, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value))
+GL_FUNCTION(void, glVertexP2ui, (GLenum type, GLuint value), (type, value))
+GL_FUNCTION(void, glVertexP2uiv, (GLenum type, const GLuint *value), (type, value))
+GL_FUNCTION(void, glVertexP3ui, (GLenum type, GLuint value), (type, value))
+GL_FUNCTION(void, glVertexP3uiv, (GLenum type, const GLuint *value), (type, value))
+GL_FUNCTION(void, glVertexP4ui, (GLenum type, GLuint value), (type, value))
+GL_FUNCTION(void, glVertexP4uiv, (GLenum type, const GLuint *value), (type, value))
+GL_FUNCTION(void, glTexCoordP1ui, (GLenum type, GLuint coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP1uiv, (GLenum type, const GLuint *coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP2ui, (GLenum type, GLuint coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP2uiv, (GLenum type, const GLuint *coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP3ui, (GLenum type, GLuint coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP3uiv, (GLenum type, const GLuint *coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP4ui, (GLenum type, GLuint coords), (type, coords))
+GL_FUNCTION(void, glTexCoordP4uiv, (GLenum type, const GLuint *coords), (type, coords))
+GL_FUNCTION(void, glMultiTexCoordP1ui, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP1uiv, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP2ui, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP2uiv, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP3ui, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP3uiv, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP4ui, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords))
+GL_FUNCTION(void, glMultiTexCoordP4uiv, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords))
+GL_FUNCTION(void, glNormalP3ui, (GLenum type, GLuint coords), (type, coords))
+GL_FUNCTION(void, glNormalP3uiv, (GLenum type, const GLuint *coords), (type, coords))
+GL_FUNCTION(void, glColorP3ui, (GLenum type, GLuint color), (type, color))
+GL_FUNCTION(void, glColorP3uiv, (GLenum type, const GLuint *color), (type, color))
+GL_FUNCTION(void, glColorP4ui, (GLenum type, GLuint color), (type, color))
+GL_FUNCTION(void, glColorP4uiv, (GLenum type, const GLuint *color), (type, color))
+GL_FUNCTION(void, glSecondaryColorP3ui, (GLenum type, GLuint color), (type, color))
+GL_FUNCTION(void, glSecondaryColorP3uiv, (GLenum type, const GLuint *color), (type, color))
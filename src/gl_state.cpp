@@ -0,0 +1,231 @@
+#include "gl_state.h"
+
+#include <iostream>
+
+static const GLenum TRACKED_CAPABILITIES[] = {
+    GL_DEPTH_TEST,
+    GL_BLEND,
+    GL_CULL_FACE,
+    GL_SCISSOR_TEST,
+    GL_STENCIL_TEST,
+    GL_MULTISAMPLE
+};
+
+GLState& GLState::instance()
+{
+    thread_local GLState state;
+    return state;
+}
+
+GLState::GLState()
+{
+    invalidate();
+}
+
+void GLState::invalidate()
+{
+    currentProgram = UNKNOWN;
+    currentVertexArray = UNKNOWN;
+    currentUnit = UNKNOWN;
+    for(GLuint unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+    {
+        for(int target = 0; target < TARGET_COUNT; target++)
+            textures[unit][target] = UNKNOWN;
+    }
+    readFramebuffer = UNKNOWN;
+    drawFramebuffer = UNKNOWN;
+    for(int i = 0; i < CAPABILITY_COUNT; i++)
+        capabilities[i] = -1;
+}
+
+int GLState::targetIndex(GLenum target)
+{
+    switch(target)
+    {
+        case GL_TEXTURE_2D:             return TARGET_2D;
+        case GL_TEXTURE_2D_MULTISAMPLE: return TARGET_2D_MULTISAMPLE;
+        case GL_TEXTURE_CUBE_MAP:       return TARGET_CUBE_MAP;
+        default:                        return -1;
+    }
+}
+
+int GLState::capabilityIndex(GLenum capability)
+{
+    for(int i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        if(TRACKED_CAPABILITIES[i] == capability)
+            return i;
+    }
+    return -1;
+}
+
+void GLState::useProgram(GLuint program)
+{
+    if(currentProgram == program)
+    {
+        elided++;
+        return;
+    }
+    glUseProgram(program);
+    currentProgram = program;
+    issued++;
+}
+
+void GLState::bindVertexArray(GLuint vertexArray)
+{
+    if(currentVertexArray == vertexArray)
+    {
+        elided++;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    currentVertexArray = vertexArray;
+    issued++;
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+    if(currentUnit == unit)
+    {
+        elided++;
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    currentUnit = unit;
+    issued++;
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+    int index = targetIndex(target);
+    if(currentUnit == UNKNOWN || currentUnit >= MAX_TEXTURE_UNITS || index < 0)
+    {
+        glBindTexture(target, texture);
+        issued++;
+        return;
+    }
+    if(textures[currentUnit][index] == texture)
+    {
+        elided++;
+        return;
+    }
+    glBindTexture(target, texture);
+    textures[currentUnit][index] = texture;
+    issued++;
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    int index = targetIndex(target);
+    if(unit < MAX_TEXTURE_UNITS && index >= 0 && textures[unit][index] == texture)
+    {
+        // the unit switch is skipped as well
+        elided += 2;
+        return;
+    }
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void GLState::bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    if((!read || readFramebuffer == framebuffer) && (!draw || drawFramebuffer == framebuffer))
+    {
+        elided++;
+        return;
+    }
+    // a half-matching GL_FRAMEBUFFER bind is narrowed to the side that changes
+    if(target == GL_FRAMEBUFFER && readFramebuffer == framebuffer)
+        target = GL_DRAW_FRAMEBUFFER;
+    else if(target == GL_FRAMEBUFFER && drawFramebuffer == framebuffer)
+        target = GL_READ_FRAMEBUFFER;
+    glBindFramebuffer(target, framebuffer);
+    if(read)
+        readFramebuffer = framebuffer;
+    if(draw)
+        drawFramebuffer = framebuffer;
+    issued++;
+}
+
+void GLState::setCapability(GLenum capability, bool on)
+{
+    int index = capabilityIndex(capability);
+    if(index >= 0 && capabilities[index] == (on ? 1 : 0))
+    {
+        elided++;
+        return;
+    }
+    if(on)
+        glEnable(capability);
+    else
+        glDisable(capability);
+    if(index >= 0)
+        capabilities[index] = on ? 1 : 0;
+    issued++;
+}
+
+void GLState::enable(GLenum capability)
+{
+    setCapability(capability, true);
+}
+
+void GLState::disable(GLenum capability)
+{
+    setCapability(capability, false);
+}
+
+void GLState::deleteTexture(GLuint texture)
+{
+    glDeleteTextures(1, &texture);
+    for(GLuint unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+    {
+        for(int target = 0; target < TARGET_COUNT; target++)
+        {
+            if(textures[unit][target] == texture)
+                textures[unit][target] = 0;
+        }
+    }
+}
+
+void GLState::deleteVertexArray(GLuint vertexArray)
+{
+    glDeleteVertexArrays(1, &vertexArray);
+    if(currentVertexArray == vertexArray)
+        currentVertexArray = 0;
+}
+
+void GLState::deleteFramebuffer(GLuint framebuffer)
+{
+    glDeleteFramebuffers(1, &framebuffer);
+    if(readFramebuffer == framebuffer)
+        readFramebuffer = 0;
+    if(drawFramebuffer == framebuffer)
+        drawFramebuffer = 0;
+}
+
+// a program in use stays alive until it is replaced, so the binding holds
+void GLState::deleteProgram(GLuint program)
+{
+    glDeleteProgram(program);
+}
+
+void GLState::beginFrame()
+{
+    lastIssued = issued;
+    lastElided = elided;
+    totalIssued += issued;
+    totalElided += elided;
+    issued = 0;
+    elided = 0;
+    frames++;
+}
+
+void GLState::printStats() const
+{
+    size_t all = totalIssued + totalElided;
+    std::cout << "GL_STATE:: " << frames << " frames, " << totalIssued << " state calls issued, "
+              << totalElided << " elided (" << (all ? totalElided * 100.0f / all : 0.0f) << "%), last frame "
+              << lastIssued << " issued / " << lastElided << " elided" << std::endl;
+}
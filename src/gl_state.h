@@ -0,0 +1,86 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// Shadow copy of the GL binding state that sits in front of the driver: a
+// call that would not change anything is skipped. Covers the program, the
+// vertex array, per-unit texture bindings, the read/draw framebuffers and
+// the common enable flags; other capabilities pass straight through.
+//
+// Every thread here keeps a single context current, so instance() is per
+// thread and always describes the context current on the calling thread.
+// Code that changes this state behind the cache's back, or a context whose
+// objects are deleted from another context, calls invalidate().
+//
+// beginFrame() closes the counts of the previous frame; printStats() reports
+// how many calls went to the driver and how many were elided.
+class GLState
+{
+    public:
+        static const GLuint MAX_TEXTURE_UNITS = 32;
+
+        static GLState& instance();
+
+        void useProgram(GLuint program);
+        void bindVertexArray(GLuint vertexArray);
+        void activeTexture(GLuint unit);
+        // binds on the active unit
+        void bindTexture(GLenum target, GLuint texture);
+        void bindTexture(GLuint unit, GLenum target, GLuint texture);
+        // GL_FRAMEBUFFER binds both read and draw
+        void bindFramebuffer(GLenum target, GLuint framebuffer);
+        void enable(GLenum capability);
+        void disable(GLenum capability);
+
+        GLuint program() const { return currentProgram; }
+
+        // deleted names fall back to 0 in GL, so the shadow copy follows
+        void deleteTexture(GLuint texture);
+        void deleteVertexArray(GLuint vertexArray);
+        void deleteFramebuffer(GLuint framebuffer);
+        void deleteProgram(GLuint program);
+        void invalidate();
+
+        void beginFrame();
+        size_t frameIssued() const { return lastIssued; }
+        size_t frameElided() const { return lastElided; }
+        void printStats() const;
+
+    private:
+        enum TextureTarget {
+            TARGET_2D,
+            TARGET_2D_MULTISAMPLE,
+            TARGET_CUBE_MAP,
+            TARGET_COUNT
+        };
+        static const int CAPABILITY_COUNT = 6;
+
+        // UNKNOWN marks state that has to be set unconditionally
+        static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+        GLuint currentProgram;
+        GLuint currentVertexArray;
+        GLuint currentUnit;
+        GLuint textures[MAX_TEXTURE_UNITS][TARGET_COUNT];
+        GLuint readFramebuffer;
+        GLuint drawFramebuffer;
+        // 0 disabled, 1 enabled, -1 unknown
+        int capabilities[CAPABILITY_COUNT];
+
+        size_t issued = 0;
+        size_t elided = 0;
+        size_t lastIssued = 0;
+        size_t lastElided = 0;
+        size_t totalIssued = 0;
+        size_t totalElided = 0;
+        size_t frames = 0;
+
+        GLState();
+        static int targetIndex(GLenum target);
+        static int capabilityIndex(GLenum capability);
+        void setCapability(GLenum capability, bool on);
+};
+
+#endif
@@ -0,0 +1,453 @@
+#include "gl_trace.h"
+#include "null_gl.h"
+#include "profiler.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+enum GLTraceEntry {
+#define GL_FUNCTION(ret, name, params, args) GL_TRACE_##name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+    GL_TRACE_ENTRY_COUNT
+};
+
+static const char* const GL_TRACE_NAMES[GL_TRACE_ENTRY_COUNT] = {
+#define GL_FUNCTION(ret, name, params, args) #name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+};
+
+enum GLTraceCategory {
+    CATEGORY_OTHER,
+    CATEGORY_DRAW,
+    CATEGORY_STATE,
+    CATEGORY_FRAMEBUFFER
+};
+
+enum GLTraceCounter {
+    COUNTER_CALLS,
+    COUNTER_DRAWS,
+    COUNTER_INSTANCES,
+    COUNTER_TRIANGLES,
+    COUNTER_STATE_CHANGES,
+    COUNTER_BUFFER_BYTES,
+    COUNTER_TEXTURE_BYTES,
+    COUNTER_FRAMEBUFFER_BINDS,
+    COUNTER_COUNT
+};
+
+static const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+    "calls", "draws", "instances", "triangles", "state changes", "buffer KiB", "texture KiB", "framebuffer binds"
+};
+
+static bool traceInstalled = false;
+static unsigned char entryCategory[GL_TRACE_ENTRY_COUNT];
+static std::atomic<uint64_t> entryCalls[GL_TRACE_ENTRY_COUNT];
+static std::atomic<uint64_t> frameCounters[COUNTER_COUNT];
+
+// render thread only, in endFrame() and printStats()
+static uint64_t startupCounters[COUNTER_COUNT];
+static uint64_t counterTotals[COUNTER_COUNT];
+static uint64_t counterPeaks[COUNTER_COUNT];
+static uint64_t frames = 0;
+static uint64_t frameStart = 0;
+static uint64_t frameTimeTotal = 0;
+static uint64_t frameTimePeak = 0;
+
+// call stream, flushed to the file once per frame
+static std::atomic<bool> streaming(false);
+static std::mutex streamMutex;
+static std::ofstream streamFile;
+static std::string streamPath;
+static std::vector<GLTraceRecord> streamRecords;
+static uint64_t streamRecordCount = 0;
+static std::atomic<uint16_t> nextThread(0);
+static thread_local int streamThread = -1;
+
+static thread_local GLuint unpackBuffer = 0;
+
+static void traceCall(GLTraceEntry entry, uint64_t value)
+{
+    entryCalls[entry].fetch_add(1, std::memory_order_relaxed);
+    frameCounters[COUNTER_CALLS].fetch_add(1, std::memory_order_relaxed);
+    switch(entryCategory[entry])
+    {
+        case CATEGORY_DRAW:        frameCounters[COUNTER_DRAWS].fetch_add(1, std::memory_order_relaxed); break;
+        case CATEGORY_STATE:       frameCounters[COUNTER_STATE_CHANGES].fetch_add(1, std::memory_order_relaxed); break;
+        case CATEGORY_FRAMEBUFFER: frameCounters[COUNTER_FRAMEBUFFER_BINDS].fetch_add(1, std::memory_order_relaxed); break;
+        default: break;
+    }
+
+    if(!streaming.load(std::memory_order_relaxed))
+        return;
+    if(streamThread < 0)
+        streamThread = nextThread++;
+    GLTraceRecord record;
+    record.entry = (uint16_t)entry;
+    record.thread = (uint16_t)streamThread;
+    record.value = (uint32_t)std::min<uint64_t>(value, 0xFFFFFFFFu);
+    std::lock_guard<std::mutex> lock(streamMutex);
+    streamRecords.push_back(record);
+}
+
+// the pointers glad handed out, called by the wrappers
+#define GL_FUNCTION(ret, name, params, args) \
+    static decltype(glad_##name) real_##name = NULL;
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+// wrappers for everything without special accounting: count and forward
+#define GL_FUNCTION(ret, name, params, args) \
+    static ret APIENTRY trace_##name params { traceCall(GL_TRACE_##name, 0); return real_##name args; }
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+static uint64_t triangles(GLenum mode, GLsizei count)
+{
+    switch(mode)
+    {
+        case GL_TRIANGLES:      return (uint64_t)count / 3;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:   return count > 2 ? (uint64_t)count - 2 : 0;
+        default:                return 0;
+    }
+}
+
+static void traceDraw(GLTraceEntry entry, GLenum mode, GLsizei count, GLsizei instances)
+{
+    uint64_t drawn = triangles(mode, count) * (uint64_t)instances;
+    frameCounters[COUNTER_INSTANCES].fetch_add((uint64_t)instances, std::memory_order_relaxed);
+    frameCounters[COUNTER_TRIANGLES].fetch_add(drawn, std::memory_order_relaxed);
+    traceCall(entry, drawn);
+}
+
+static void traceUpload(GLTraceEntry entry, GLTraceCounter counter, uint64_t bytes)
+{
+    frameCounters[counter].fetch_add(bytes, std::memory_order_relaxed);
+    traceCall(entry, bytes);
+}
+
+// with a pixel unpack buffer bound the pointer is an offset, 0 included
+static uint64_t textureBytes(const void *pixels, uint64_t bytes)
+{
+    return pixels || unpackBuffer ? bytes : 0;
+}
+
+static void APIENTRY traceDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    traceDraw(GL_TRACE_glDrawArrays, mode, count, 1);
+    real_glDrawArrays(mode, first, count);
+}
+
+static void APIENTRY traceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+{
+    traceDraw(GL_TRACE_glDrawArraysInstanced, mode, count, instancecount);
+    real_glDrawArraysInstanced(mode, first, count, instancecount);
+}
+
+static void APIENTRY traceDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    traceDraw(GL_TRACE_glDrawElements, mode, count, 1);
+    real_glDrawElements(mode, count, type, indices);
+}
+
+static void APIENTRY traceDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount)
+{
+    traceDraw(GL_TRACE_glDrawElementsInstanced, mode, count, instancecount);
+    real_glDrawElementsInstanced(mode, count, type, indices, instancecount);
+}
+
+static void APIENTRY traceDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex)
+{
+    traceDraw(GL_TRACE_glDrawElementsBaseVertex, mode, count, 1);
+    real_glDrawElementsBaseVertex(mode, count, type, indices, basevertex);
+}
+
+static void APIENTRY traceDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                                          GLsizei instancecount, GLint basevertex)
+{
+    traceDraw(GL_TRACE_glDrawElementsInstancedBaseVertex, mode, count, instancecount);
+    real_glDrawElementsInstancedBaseVertex(mode, count, type, indices, instancecount, basevertex);
+}
+
+static void APIENTRY traceDrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices)
+{
+    traceDraw(GL_TRACE_glDrawRangeElements, mode, count, 1);
+    real_glDrawRangeElements(mode, start, end, count, type, indices);
+}
+
+static void APIENTRY traceBindBuffer(GLenum target, GLuint buffer)
+{
+    if(target == GL_PIXEL_UNPACK_BUFFER)
+        unpackBuffer = buffer;
+    traceCall(GL_TRACE_glBindBuffer, buffer);
+    real_glBindBuffer(target, buffer);
+}
+
+static void APIENTRY traceBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    traceCall(GL_TRACE_glBindFramebuffer, framebuffer);
+    real_glBindFramebuffer(target, framebuffer);
+}
+
+static void APIENTRY traceBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    traceUpload(GL_TRACE_glBufferData, COUNTER_BUFFER_BYTES, data ? (uint64_t)size : 0);
+    real_glBufferData(target, size, data, usage);
+}
+
+static void APIENTRY traceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    traceUpload(GL_TRACE_glBufferSubData, COUNTER_BUFFER_BYTES, (uint64_t)size);
+    real_glBufferSubData(target, offset, size, data);
+}
+
+// a mapping for writing counts as uploading the whole range
+static void* APIENTRY traceMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    traceUpload(GL_TRACE_glMapBufferRange, COUNTER_BUFFER_BYTES, access & GL_MAP_WRITE_BIT ? (uint64_t)length : 0);
+    return real_glMapBufferRange(target, offset, length, access);
+}
+
+static void APIENTRY traceTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                     GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    traceUpload(GL_TRACE_glTexImage2D, COUNTER_TEXTURE_BYTES, textureBytes(pixels, (uint64_t)width * height * pixelBytes(format, type)));
+    real_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+static void APIENTRY traceTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                                        GLenum format, GLenum type, const void *pixels)
+{
+    traceUpload(GL_TRACE_glTexSubImage2D, COUNTER_TEXTURE_BYTES, textureBytes(pixels, (uint64_t)width * height * pixelBytes(format, type)));
+    real_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+static void APIENTRY traceCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+                                               GLint border, GLsizei imageSize, const void *data)
+{
+    traceUpload(GL_TRACE_glCompressedTexImage2D, COUNTER_TEXTURE_BYTES, textureBytes(data, (uint64_t)imageSize));
+    real_glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+}
+
+static void APIENTRY traceCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                                                  GLenum format, GLsizei imageSize, const void *data)
+{
+    traceUpload(GL_TRACE_glCompressedTexSubImage2D, COUNTER_TEXTURE_BYTES, textureBytes(data, (uint64_t)imageSize));
+    real_glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
+}
+
+static bool startsWith(const char *name, const char *prefix)
+{
+    return std::strncmp(name, prefix, std::strlen(prefix)) == 0;
+}
+
+static GLTraceCategory categorize(const char *name)
+{
+    static const char* const STATE_PREFIXES[] = {
+        "glBind", "glUse", "glEnable", "glDisable", "glActiveTexture", "glUniform", "glBlend", "glDepth",
+        "glStencil", "glCullFace", "glFrontFace", "glViewport", "glScissor", "glColorMask", "glPolygon",
+        "glDrawBuffer", "glVertexAttribPointer", "glVertexAttribIPointer", "glVertexAttribDivisor",
+        "glPixelStore", "glTexParameter", "glSamplerParameter"
+    };
+    if(std::strcmp(name, "glBindFramebuffer") == 0)
+        return CATEGORY_FRAMEBUFFER;
+    if((startsWith(name, "glDraw") && !startsWith(name, "glDrawBuffer")) || startsWith(name, "glMultiDraw"))
+        return CATEGORY_DRAW;
+    for(size_t i = 0; i < sizeof(STATE_PREFIXES) / sizeof(STATE_PREFIXES[0]); i++)
+    {
+        if(startsWith(name, STATE_PREFIXES[i]))
+            return CATEGORY_STATE;
+    }
+    return CATEGORY_OTHER;
+}
+
+static const char* traceOption()
+{
+    const char *option = std::getenv("ASTEROID_GL_TRACE");
+    return option ? option : "";
+}
+
+static void writeMarker(uint16_t entry, uint64_t microseconds)
+{
+    GLTraceRecord record;
+    record.entry = entry;
+    record.thread = 0;
+    record.value = (uint32_t)std::min<uint64_t>(microseconds, 0xFFFFFFFFu);
+
+    std::lock_guard<std::mutex> lock(streamMutex);
+    streamRecords.push_back(record);
+    streamFile.write((const char*)streamRecords.data(), streamRecords.size() * sizeof(GLTraceRecord));
+    streamRecordCount += streamRecords.size();
+    streamRecords.clear();
+}
+
+bool GLTrace::requested()
+{
+    const char *option = traceOption();
+    return *option && std::strcmp(option, "off") != 0;
+}
+
+void GLTrace::install()
+{
+    if(traceInstalled)
+        return;
+    traceInstalled = true;
+
+    for(int i = 0; i < GL_TRACE_ENTRY_COUNT; i++)
+        entryCategory[i] = (unsigned char)categorize(GL_TRACE_NAMES[i]);
+
+#define GL_FUNCTION(ret, name, params, args) \
+    real_##name = glad_##name; \
+    if(real_##name) \
+        glad_##name = trace_##name;
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+#define GL_TRACE_OVERRIDE(name, wrapper) \
+    if(real_##name) \
+        glad_##name = wrapper;
+    GL_TRACE_OVERRIDE(glDrawArrays, traceDrawArrays)
+    GL_TRACE_OVERRIDE(glDrawArraysInstanced, traceDrawArraysInstanced)
+    GL_TRACE_OVERRIDE(glDrawElements, traceDrawElements)
+    GL_TRACE_OVERRIDE(glDrawElementsInstanced, traceDrawElementsInstanced)
+    GL_TRACE_OVERRIDE(glDrawElementsBaseVertex, traceDrawElementsBaseVertex)
+    GL_TRACE_OVERRIDE(glDrawElementsInstancedBaseVertex, traceDrawElementsInstancedBaseVertex)
+    GL_TRACE_OVERRIDE(glDrawRangeElements, traceDrawRangeElements)
+    GL_TRACE_OVERRIDE(glBindBuffer, traceBindBuffer)
+    GL_TRACE_OVERRIDE(glBindFramebuffer, traceBindFramebuffer)
+    GL_TRACE_OVERRIDE(glBufferData, traceBufferData)
+    GL_TRACE_OVERRIDE(glBufferSubData, traceBufferSubData)
+    GL_TRACE_OVERRIDE(glMapBufferRange, traceMapBufferRange)
+    GL_TRACE_OVERRIDE(glTexImage2D, traceTexImage2D)
+    GL_TRACE_OVERRIDE(glTexSubImage2D, traceTexSubImage2D)
+    GL_TRACE_OVERRIDE(glCompressedTexImage2D, traceCompressedTexImage2D)
+    GL_TRACE_OVERRIDE(glCompressedTexSubImage2D, traceCompressedTexSubImage2D)
+#undef GL_TRACE_OVERRIDE
+
+    frameStart = Profiler::now();
+
+    const char *option = traceOption();
+    if(std::strcmp(option, "stats") == 0)
+        return;
+    streamPath = option;
+    streamFile.open(streamPath, std::ios::binary | std::ios::trunc);
+    if(!streamFile)
+    {
+        std::cout << "ERROR::GL_TRACE::Cannot write " << streamPath << ", counting only" << std::endl;
+        return;
+    }
+    GLTraceHeader header;
+    std::memcpy(header.magic, GL_TRACE_MAGIC, sizeof(header.magic));
+    header.version = GL_TRACE_VERSION;
+    header.entryCount = GL_TRACE_ENTRY_COUNT;
+    streamFile.write((const char*)&header, sizeof(header));
+    for(int i = 0; i < GL_TRACE_ENTRY_COUNT; i++)
+        streamFile.write(GL_TRACE_NAMES[i], std::strlen(GL_TRACE_NAMES[i]) + 1);
+    streaming = true;
+}
+
+bool GLTrace::installed()
+{
+    return traceInstalled;
+}
+
+void GLTrace::beginFrames()
+{
+    if(!traceInstalled)
+        return;
+    uint64_t now = Profiler::now();
+    for(int i = 0; i < COUNTER_COUNT; i++)
+        startupCounters[i] += frameCounters[i].exchange(0, std::memory_order_relaxed);
+    if(streaming)
+        writeMarker(GL_TRACE_STARTUP, now - frameStart);
+    frameStart = now;
+}
+
+void GLTrace::endFrame()
+{
+    if(!traceInstalled)
+        return;
+    uint64_t now = Profiler::now();
+    uint64_t frameTime = now - frameStart;
+    frameStart = now;
+
+    for(int i = 0; i < COUNTER_COUNT; i++)
+    {
+        uint64_t value = frameCounters[i].exchange(0, std::memory_order_relaxed);
+        counterTotals[i] += value;
+        counterPeaks[i] = std::max(counterPeaks[i], value);
+    }
+    frames++;
+    frameTimeTotal += frameTime;
+    frameTimePeak = std::max(frameTimePeak, frameTime);
+
+    if(streaming)
+        writeMarker(GL_TRACE_FRAME, frameTime);
+}
+
+void GLTrace::printStats()
+{
+    if(!traceInstalled)
+        return;
+
+    std::cout << "GL_TRACE:: startup " << startupCounters[COUNTER_CALLS] << " calls, "
+              << startupCounters[COUNTER_BUFFER_BYTES] / 1024 << " KiB buffer data, "
+              << startupCounters[COUNTER_TEXTURE_BYTES] / 1024 << " KiB texture data" << std::endl;
+    if(frames == 0)
+        return;
+
+    char line[160];
+    snprintf(line, sizeof(line), "GL_TRACE:: %llu frames, %.3f ms average, %.3f ms peak",
+             (unsigned long long)frames, frameTimeTotal / 1000.0 / frames, frameTimePeak / 1000.0);
+    std::cout << line << std::endl;
+    for(int i = 0; i < COUNTER_COUNT; i++)
+    {
+        // bytes are reported in KiB
+        double scale = i == COUNTER_BUFFER_BYTES || i == COUNTER_TEXTURE_BYTES ? 1.0 / 1024 : 1.0;
+        snprintf(line, sizeof(line), "GL_TRACE:: %-18s %12.1f per frame %12.1f peak",
+                 COUNTER_NAMES[i], counterTotals[i] * scale / frames, counterPeaks[i] * scale);
+        std::cout << line << std::endl;
+    }
+
+    std::vector<int> entries;
+    for(int i = 0; i < GL_TRACE_ENTRY_COUNT; i++)
+    {
+        if(entryCalls[i].load(std::memory_order_relaxed))
+            entries.push_back(i);
+    }
+    std::sort(entries.begin(), entries.end(), [](int a, int b) {
+        return entryCalls[a].load(std::memory_order_relaxed) > entryCalls[b].load(std::memory_order_relaxed);
+    });
+    // startup calls included, so one-off uploads show up too
+    for(size_t i = 0; i < entries.size() && i < 16; i++)
+    {
+        snprintf(line, sizeof(line), "GL_TRACE:: %12llu  %s",
+                 (unsigned long long)entryCalls[entries[i]].load(std::memory_order_relaxed), GL_TRACE_NAMES[entries[i]]);
+        std::cout << line << std::endl;
+    }
+}
+
+void GLTrace::finish()
+{
+    if(!streaming)
+        return;
+    streaming = false;
+
+    std::lock_guard<std::mutex> lock(streamMutex);
+    streamFile.write((const char*)streamRecords.data(), streamRecords.size() * sizeof(GLTraceRecord));
+    streamRecordCount += streamRecords.size();
+    streamRecords.clear();
+    streamFile.close();
+    std::cout << "GL_TRACE:: " << streamRecordCount << " records in " << streamPath << std::endl;
+}
@@ -0,0 +1,57 @@
+#ifndef GL_TRACE_H
+#define GL_TRACE_H
+
+#include <cstdint>
+
+// Optional layer over the glad function pointers that attributes each frame
+// to the API calls it made. install() runs right after gladLoadGLLoader and
+// swaps every loaded pointer for a wrapper that counts the call and forwards
+// it, so it works over a real driver, a software one or NullGL alike.
+// Extension entry points loaded by gl_extensions.cpp are not wrapped.
+//
+// Per frame it counts calls, draws, instances, triangles, state changes
+// (binds, enables, blend/depth state, uniforms), buffer and texture upload
+// bytes and framebuffer binds. beginFrames() sets everything counted so far
+// aside as startup, endFrame() closes a frame and printStats() reports
+// averages and peaks. ASTEROID_GL_TRACE=stats enables only the
+// counters, any other value except "off" names a file that also receives
+// the call stream in the binary format below, summarized by tools/gltrace.
+//
+// File layout: GLTraceHeader, entryCount NUL-terminated entry point names
+// (the record entry indexes them), then GLTraceRecords until the end. A
+// record with entry GL_TRACE_STARTUP ends the startup calls, each one with
+// GL_TRACE_FRAME ends a frame; both carry the wall time in microseconds.
+static const char GL_TRACE_MAGIC[8] = {'G', 'L', 'T', 'R', 'A', 'C', 'E', '1'};
+static const uint32_t GL_TRACE_VERSION = 1;
+static const uint16_t GL_TRACE_FRAME = 0xFFFF;
+static const uint16_t GL_TRACE_STARTUP = 0xFFFE;
+
+struct GLTraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+};
+
+// value is the triangle count for draws (all instances), the byte count for
+// uploads, the bound name for framebuffer binds and 0 otherwise
+struct GLTraceRecord {
+    uint16_t entry;
+    uint16_t thread;
+    uint32_t value;
+};
+
+class GLTrace
+{
+    public:
+        static bool requested();
+        static void install();
+        static bool installed();
+
+        static void beginFrames();
+        static void endFrame();
+        static void printStats();
+        // flushes and closes the trace file
+        static void finish();
+};
+
+#endif
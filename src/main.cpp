@@ -6,12 +6,30 @@
 #include "shader.h"
 #include "camera.h"
 #include "model.h"
+#include "texture_cache.h"
+#include "asset_loader.h"
+#include "asset_archive.h"
+#include "profiler.h"
+#include "frame_uniforms.h"
+#include "program_cache.h"
+#include "shader_variants.h"
+#include "gl_state.h"
+#include "gl_extensions.h"
+#include "render_queue.h"
+#include "command_buffer.h"
+#include "thread_pool.h"
+#include "null_gl.h"
+#include "gl_trace.h"
+#include "gl_capture.h"
+#include "frame_graph.h"
+#include "dynamic_resolution.h"
 #include "stb_image.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <map>
+#include <cstdlib>
 
 using namespace std;
 
@@ -20,12 +38,15 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow  *window);
-GLuint TextureFromFile(std::string path);
-GLuint loadCubemap(vector<std::string> textures_faces);
+void setupInstanceAttributes(Model &model, GLuint buffer);
+AssetTask<std::shared_ptr<Model>> loadRock(AssetLoader &loader, GLuint buffer);
 
 //RESOLUTION
 const GLuint SCDR_WIDTH = 800;
 const GLuint SCDR_HEIGHT = 600;
+// size of the default framebuffer, kept current by framebuffer_size_callback
+int framebufferWidth = SCDR_WIDTH;
+int framebufferHeight = SCDR_HEIGHT;
 
 //CAMERA
 Camera camera(glm::vec3(0.0f, 20.0f, 200.0f));
@@ -38,36 +59,72 @@ float lastFrame = 0.0f;
 
 int main()
 {
+    // ASTEROID_GL=null runs headless on stub GL entry points, see NullGL
+    bool nullGL = NullGL::requested();
+
+    ProfileScope windowScope("main::createWindow");
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    GLFWwindow* window = glfwCreateWindow(SCDR_WIDTH, SCDR_HEIGHT, "OpenGL", NULL, NULL);
-    if(window == NULL)
+    GLFWwindow* window = NULL;
+    if(!nullGL)
     {
-        std::cout <<"Failed to create GLFW window" << std::endl;
+        window = glfwCreateWindow(SCDR_WIDTH, SCDR_HEIGHT, "OpenGL", NULL, NULL);
+        if(window == NULL)
+        {
+            std::cout <<"Failed to create GLFW window" << std::endl;
+        }
+
+        glfwMakeContextCurrent(window);
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
-    
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    windowScope.end();
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    ProfileScope gladScope("main::gladLoadGLLoader");
+    GLADloadproc loadProc = nullGL ? (GLADloadproc)NullGL::loader : (GLADloadproc)glfwGetProcAddress;
+    if (!gladLoadGLLoader(loadProc))
     {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
-
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
+    setGLLoader(loadProc);
+    gladScope.end();
+    // ASTEROID_GL_TRACE counts API usage per frame, see GLTrace
+    if(GLTrace::requested())
+        GLTrace::install();
+    // ASTEROID_GL_CAPTURE records the call stream for tools/glreplay
+    if(GLCapture::requested())
+        GLCapture::install(framebufferWidth, framebufferHeight);
+
+    // state changes on the render thread go through the cache
+    GLState &gl = GLState::instance();
+
+    gl.enable(GL_DEPTH_TEST);
+    gl.enable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    Shader shader("shaders/vshader.glsl", "shaders/fshader.glsl");
-    Shader instanceShader("shaders/instancevshader.glsl", "shaders/fshader.glsl");
-    Shader screenShader("shaders/fbvshader.vert","shaders/fbfshader.frag");
+    // everything below resolves through the packed archive when one is present
+    ProfileScope archiveScope("AssetArchive::mount", "assets.pak");
+    bool archiveMounted = AssetArchive::mount("assets.pak");
+    archiveScope.end();
+    if(archiveMounted)
+        std::cout << "ASSET_ARCHIVE:: mounted assets.pak with " << AssetArchive::entryCount() << " entries" << std::endl;
+
+    // submitted here, compiled by the driver while the models load
+    ShaderVariants sceneShaders("shaders/vshader.glsl", "shaders/fshader.glsl");
+    ShaderVariants postShaders("shaders/fbvshader.vert", "shaders/fbfshader.frag");
+    Shader &shader = sceneShaders.variant(0);
+    Shader &instanceShader = sceneShaders.variant(SHADER_INSTANCED);
+    // post effects come from ASTEROID_POST, e.g. ASTEROID_POST=POST_BLUR,POST_GRAYSCALE
+    const char *postEffects = std::getenv("ASTEROID_POST");
+    uint32_t postFeatures = postEffects ? parseShaderFeatures(postEffects) : 0;
+    Shader &screenShader = postShaders.variant(postFeatures);
 
     glm::vec3 translations[100];
     GLuint instanceVBO;
@@ -84,9 +141,15 @@ int main()
 
     stbi_set_flip_vertically_on_load(true);
 
-    Model planet("models/planet/planet.obj");
-    Model rock("models/rock/rock.obj");
-    
+    // models stream in while the render loop is already running
+    double loadStart = glfwGetTime();
+    AssetLoader *loader = new AssetLoader(window);
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    AssetTask<std::shared_ptr<Model>> planetTask = loader->model("models/planet/planet.obj");
+    AssetTask<std::shared_ptr<Model>> rockTask = loadRock(*loader, buffer);
+
+    ProfileScope asteroidScope("main::generateAsteroids");
     GLuint amount = 50000;
     glm::mat4 *modelMatrices;
     modelMatrices = new glm::mat4[amount];
@@ -118,75 +181,18 @@ int main()
         modelMatrices[i] = model;
     }
 
-    GLuint buffer;
-    glGenBuffers(1, &buffer);
     glBindBuffer(GL_ARRAY_BUFFER, buffer);
     glBufferData(GL_ARRAY_BUFFER, amount * sizeof(glm::mat4), &modelMatrices[0], GL_STATIC_DRAW);
+    asteroidScope.bytesUploaded(amount * sizeof(glm::mat4));
 
-    for (GLuint i = 0; i < rock.meshes.size(); i++)
-    {
-        GLuint VAO = rock.meshes[i].VAO;
-        glBindVertexArray(VAO);
-        std::size_t v4s = sizeof(glm::vec4);
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) 0);
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) (1 * v4s));
-        glEnableVertexAttribArray(5);
-        glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) (2 * v4s));
-        glEnableVertexAttribArray(6);
-        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) (3 * v4s));
-
-        glVertexAttribDivisor(3, 1);
-        glVertexAttribDivisor(4, 1);
-        glVertexAttribDivisor(5, 1);
-        glVertexAttribDivisor(6, 1);
-
-        glBindVertexArray(0);
-
-    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    bool firstFrame = true;
+    bool modelsResident = false;
+    bool texturesStreamed = false;
 
-    //FB MSAA---------------------------------------------------------------------------------------------------
-    GLuint MSAAFBO;
-    glGenFramebuffers(1, &MSAAFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, MSAAFBO);
-    // multisampled color
-    GLuint MSAATextureColorBuffer;
-    GLuint samples = 4;
-    glGenTextures(1, &MSAATextureColorBuffer);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, MSAATextureColorBuffer);
-    glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, GL_RGB, SCDR_WIDTH, SCDR_HEIGHT, GL_TRUE);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, MSAATextureColorBuffer, 0);
-
-    GLuint MSAARBO;
-    glGenRenderbuffers(1, &MSAARBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, MSAARBO);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, SCDR_WIDTH, SCDR_HEIGHT);
-    glBindRenderbuffer(GL_RENDERBUFFER, 0);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, MSAARBO);
-
-    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout<< "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << endl;
-    glBindFramebuffer(GL_FRAMEBUFFER,0);
-
-    //CONFIGURE SECOND_FRAMEBUFFER------------------------------------------------------------------------------
-    GLuint intermediateFBO;
-    glGenFramebuffers(1, &intermediateFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, intermediateFBO);
-
-    GLuint screenTexture;
-    glGenTextures (1, &screenTexture);
-    glBindTexture (GL_TEXTURE_2D, screenTexture);
-    glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB, SCDR_WIDTH, SCDR_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, screenTexture, 0);
-
-    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout <<"ERROR::FRAMEBUFFER:: Intermediate framebuffer is not complete!"<< std::endl;
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    asteroidScope.end();
 
+    ProfileScope framebufferScope("main::setupFramebuffers");
     GLfloat fbVertices[] = {
         // positions    // texCoords
         -1.0f,  1.0f,   0.0f, 1.0f,
@@ -201,7 +207,7 @@ int main()
     GLuint fbVAO, fbVBO;
     glGenVertexArrays(1, &fbVAO);
     glGenBuffers(1, &fbVBO);
-    glBindVertexArray(fbVAO);
+    gl.bindVertexArray(fbVAO);
     glBindBuffer(GL_ARRAY_BUFFER, fbVBO);
     glEnableVertexAttribArray(0);
     glBufferData(GL_ARRAY_BUFFER, sizeof(fbVertices), fbVertices, GL_STATIC_DRAW);
@@ -209,80 +215,179 @@ int main()
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * (sizeof(GLfloat))));
     //SET_FRAMEBUFFER_END---------------------------------------------------------------------------
-    screenShader.use();
-    screenShader.setInt("screenTexture", 0);
-
-    while(!glfwWindowShouldClose(window))
+    framebufferScope.end();
+
+    // camera matrices reach every shader through the Frame uniform block
+    FrameUniforms *frameUniforms = new FrameUniforms();
+    // draws are sorted by state and depth instead of issued in code order,
+    // recorded off the render thread and replayed here; more passes or
+    // sectors would each get their own queue, buffer and worker
+    RenderQueue renderQueue;
+    CommandBuffer sceneCommands;
+    CommandExecutor executor;
+    ThreadPool recordPool(1);
+    std::future<void> sceneRecorded;
+
+    // the scene renders multisampled at the render resolution; with a post
+    // effect the post pass samples it (the graph resolves it first) and draws
+    // it to the screen, without one the post pass is culled and the scene is
+    // resolved straight to the screen. Either way the last step scales it up
+    // to the framebuffer when dynamic resolution renders smaller.
+    FrameGraph frameGraph;
+    DynamicResolution dynamicResolution;
+    GLsizei graphWidth = 0, graphHeight = 0;
+    GLsizei renderWidth = 0, renderHeight = 0;
+    // declared again whenever the framebuffer or the render resolution changes size
+    auto buildFrameGraph = [&](GLsizei width, GLsizei height, GLsizei sceneWidth, GLsizei sceneHeight) {
+        frameGraph.reset();
+        FrameResource backbuffer = frameGraph.importBackbuffer(width, height);
+        FrameResource sceneColor = frameGraph.createTexture("sceneColor", {sceneWidth, sceneHeight, GL_RGBA8, 4});
+        FrameResource sceneDepth = frameGraph.createTexture("sceneDepth", {sceneWidth, sceneHeight, GL_DEPTH24_STENCIL8, 4});
+        frameGraph.addPass("scene", [&](const FrameGraph &) {
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            gl.enable(GL_DEPTH_TEST);
+            sceneRecorded.get();
+            executor.execute(sceneCommands);
+        }).write(sceneColor).write(sceneDepth);
+        frameGraph.addPass("post", [&, sceneColor](const FrameGraph &graph) {
+            gl.disable(GL_DEPTH_TEST);
+            screenShader.use();
+            gl.bindVertexArray(fbVAO);
+            gl.bindTexture(0, GL_TEXTURE_2D, graph.texture(sceneColor));
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }).read(sceneColor).write(backbuffer);
+        frameGraph.present(postFeatures ? backbuffer : sceneColor);
+        frameGraph.compile();
+        graphWidth = width;
+        graphHeight = height;
+        renderWidth = sceneWidth;
+        renderHeight = sceneHeight;
+    };
+    buildFrameGraph(framebufferWidth, framebufferHeight, framebufferWidth, framebufferHeight);
+    frameGraph.printStats();
+
+    // ASTEROID_FRAMES stops after that many frames, for benchmark runs; the
+    // headless backend has no window to close, so it always stops
+    const char *framesVariable = std::getenv("ASTEROID_FRAMES");
+    size_t frameLimit = framesVariable ? (size_t)std::strtoul(framesVariable, NULL, 10) : 0;
+    if(nullGL && frameLimit == 0)
+        frameLimit = 1000;
+    size_t frames = 0;
+    uint64_t loopStart = Profiler::now();
+    GLTrace::beginFrames();
+    GLCapture::beginFrames();
+
+    while((!window || !glfwWindowShouldClose(window)) && (frameLimit == 0 || frames < frameLimit))
     {
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
         // input
-        processInput(window);
+        if(window)
+            processInput(window);
+        gl.beginFrame();
+        TextureCache::instance().processUploads();
+        loader->poll();
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if(firstFrame)
+        {
+            std::cout << "STARTUP:: first frame after " << (currentFrame - loadStart) * 1000.0 << " ms" << std::endl;
+            firstFrame = false;
+        }
+        if(!modelsResident && loader->pending() == 0 && planetTask.done() && rockTask.done())
+        {
+            std::cout << "STARTUP:: models and textures resident after " << (currentFrame - loadStart) * 1000.0
+                      << " ms with " << TextureCache::instance().decodeThreads() << " decode threads" << std::endl;
+            modelsResident = true;
+        }
+        if(modelsResident && !texturesStreamed && TextureCache::instance().streamingTextures() == 0)
+        {
+            std::cout << "STARTUP:: full resolution textures resident after " << (currentFrame - loadStart) * 1000.0 << " ms" << std::endl;
+            texturesStreamed = true;
+        }
 
-        // rendering with MSAA
-        glBindFramebuffer(GL_FRAMEBUFFER, MSAAFBO);
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_DEPTH_TEST);
+        //DRAW----------------------------------------------------------------------------------------------------
+        // the scene is sorted and recorded on a worker while this thread does the GL setup of the frame
+        glm::vec3 cameraPosition = camera.Position;
+        Model *planet = planetTask.done() ? planetTask.result().get() : NULL;
+        Model *rock = rockTask.done() ? rockTask.result().get() : NULL;
+        sceneRecorded = recordPool.submit([&, cameraPosition, planet, rock]() {
+            renderQueue.begin(cameraPosition, 1000.0f);
+
+            //DRAW PLANET
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(0.0f, -3.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(10.0f, 10.0f, 10.0f));
+            if(planet)
+                renderQueue.submit(*planet, shader, model);
+
+            //DRAW ROCK
+            if(rock)
+                renderQueue.submit(*rock, instanceShader, glm::mat4(1.0f), amount);
+
+            sceneCommands.reset();
+            renderQueue.record(sceneCommands);
+        });
+
+        // targets follow the window and the dynamic resolution scale; a
+        // minimized window has no size and keeps the ones it had
+        GLsizei sceneWidth = dynamicResolution.scaled(framebufferWidth);
+        GLsizei sceneHeight = dynamicResolution.scaled(framebufferHeight);
+        if(framebufferWidth > 0 && framebufferHeight > 0
+           && (framebufferWidth != graphWidth || framebufferHeight != graphHeight || sceneWidth != renderWidth || sceneHeight != renderHeight))
+            buildFrameGraph(framebufferWidth, framebufferHeight, sceneWidth, sceneHeight);
 
         //PROJECTION AND VIEW------------------------------------------------------------------------------------------------------
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCDR_WIDTH / (float)SCDR_HEIGHT, 0.1f, 1000.0f);
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)graphWidth / (float)graphHeight, 0.1f, 1000.0f);
         glm::mat4 view = camera.GetViewMatrix();
-        //DRAW----------------------------------------------------------------------------------------------------
-        //USE SHADER
-        shader.use();
+        frameUniforms->update(view, projection, camera.Position, currentFrame, deltaTime, (float)renderWidth, (float)renderHeight);
 
-        //CONFIGURE VIEW AND PROJECTION
-        view = camera.GetViewMatrix();
-        projection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 1000.0f);
-        
-        shader.setMatrix4("view", view);
-        shader.setMatrix4("projection", projection);
+        // waiting for the recording here keeps the CPU side out of the GPU timing
+        sceneRecorded.wait();
+        dynamicResolution.beginFrame();
+        frameGraph.execute();
+        if(dynamicResolution.endFrame())
+            std::cout << "DYNAMIC_RES:: rendering at " << dynamicResolution.scale() * 100.0f << "% ("
+                      << dynamicResolution.scaled(graphWidth) << "x" << dynamicResolution.scaled(graphHeight) << ") after "
+                      << dynamicResolution.gpuMs() << " ms of GPU time" << std::endl;
 
-        //DRAW PLANET
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(0.0f, -3.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(10.0f, 10.0f, 10.0f));
-        shader.setMatrix4("model", model);
-        planet.Draw(shader);
-
-        //DRAW ROCK
-        instanceShader.use();
-        instanceShader.setMatrix4("view", view);
-        instanceShader.setMatrix4("projection", projection);
-        rock.DrawInstances(instanceShader, amount);
-        
-        //DRAW_END----------------------------------------------------------------------------------------------
-        // blit multisampled buffer to normal colorbuffer of intermediate FBO
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, MSAAFBO);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, intermediateFBO);
-        glBlitFramebuffer(0, 0, SCDR_WIDTH, SCDR_HEIGHT, 0, 0, SCDR_WIDTH, SCDR_HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-
-        // now render quad with scene's visuals as its texture image
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glDisable(GL_DEPTH_TEST);
-
-        screenShader.use();
-        glBindVertexArray(fbVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, screenTexture);
-        glDrawArrays (GL_TRIANGLES, 0, 6);
-        
         // check and call events and swap the buffers
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if(window)
+        {
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+        GLTrace::endFrame();
+        GLCapture::endFrame();
+        frames++;
+    }
+    if(frameLimit)
+    {
+        double loopMs = (Profiler::now() - loopStart) / 1000.0;
+        std::cout << "BENCHMARK:: " << frames << " frames in " << loopMs << " ms, "
+                  << (frames ? loopMs / frames : 0.0) << " ms per frame" << std::endl;
     }
-    planet.DeleteBuffers();
-    rock.DeleteBuffers();
-    glDeleteProgram(shader.ID);
-    glDeleteFramebuffers(1, &MSAAFBO);
-    glDeleteFramebuffers(1, &intermediateFBO);
+    delete loader;
+    TextureCache::instance().printStats();
+    ProgramCache::printStats();
+    gl.printStats();
+    if(nullGL)
+        NullGL::printStats();
+    GLTrace::printStats();
+    dynamicResolution.printStats();
+    Profiler::finish();
+    if(planetTask.done())
+        planetTask.result()->DeleteBuffers();
+    if(rockTask.done())
+        rockTask.result()->DeleteBuffers();
+    delete frameUniforms;
+    sceneShaders.deletePrograms();
+    postShaders.deletePrograms();
+    frameGraph.deleteObjects();
+    dynamicResolution.deleteQueries();
+    GLTrace::finish();
+    GLCapture::finish();
 
     glfwTerminate();
     return 0;
@@ -311,9 +416,11 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     camera.ProcessMouseScroll(yoffset);
 }
 
+// the frame graph is rebuilt at the new size and sets the viewport of each pass
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    framebufferWidth = width;
+    framebufferHeight = height;
 }
 
 void processInput(GLFWwindow  *window)
@@ -331,61 +438,39 @@ void processInput(GLFWwindow  *window)
         camera.ProcessKeyboard(RIGHT, deltaTime);
 }
 
-GLuint TextureFromFile(std::string path)
+void setupInstanceAttributes(Model &model, GLuint buffer)
 {
-    GLint width, height, nrChannels;
-    unsigned char *data = stbi_load((path).c_str(), &width, &height, &nrChannels, 0);
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    if(data)
-    {
-        GLenum format;
-        if(nrChannels == 1)
-            format = GL_RED;
-        else if(nrChannels == 3)
-            format = GL_RGB;
-        else if(nrChannels == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint i = 0; i < model.meshes.size(); i++)
     {
-        std::cout << "Failed to load texture" << std::endl;
-    }
+        GLuint VAO = model.meshes[i].VAO;
+        GLState::instance().bindVertexArray(VAO);
+        std::size_t v4s = sizeof(glm::vec4);
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) 0);
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) (1 * v4s));
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) (2 * v4s));
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, 4*v4s, (void*) (3 * v4s));
 
-    stbi_image_free(data);
-    return textureID;
-}
+        glVertexAttribDivisor(3, 1);
+        glVertexAttribDivisor(4, 1);
+        glVertexAttribDivisor(5, 1);
+        glVertexAttribDivisor(6, 1);
 
-GLuint loadCubemap(vector<std::string> textures_faces)
-{
-    GLuint textureCubeMapID;
-    glGenTextures(1, &textureCubeMapID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureCubeMapID);
+        GLState::instance().bindVertexArray(0);
 
-    int width, height, nrChannels;
-    for(GLuint i = 0; i < textures_faces.size(); i++)
-    {
-        unsigned char *data = stbi_load(textures_faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if(data)
-        {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
-        }
-        else{
-            std::cout << "Cubemap failed to load at path: " << textures_faces[i] << std::endl;
-            stbi_image_free(data);
-        }
     }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-    return textureCubeMapID;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+// the instance attributes live in the rock's vertex arrays, which only exist
+// once the load has resumed on the render thread
+AssetTask<std::shared_ptr<Model>> loadRock(AssetLoader &loader, GLuint buffer)
+{
+    std::shared_ptr<Model> rock = co_await loader.model("models/rock/rock.obj");
+    setupInstanceAttributes(*rock, buffer);
+    co_return rock;
+}
@@ -0,0 +1,196 @@
+#include "mapped_io.h"
+#include "texture_cache.h"
+#include "asset_archive.h"
+#include "profiler.h"
+
+#include <assimp/MemoryIOWrapper.h>
+
+#include <unordered_map>
+#include <mutex>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+struct MountedRegion {
+    const unsigned char *data;
+    size_t size;
+};
+
+static std::mutex mappingMutex;
+static std::unordered_map<std::string, std::shared_ptr<MappedFile>> mappings;
+static std::unordered_map<std::string, MountedRegion> mounts;
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if(mappedData)
+        UnmapViewOfFile(mappedData);
+    if(mappingHandle)
+        CloseHandle(mappingHandle);
+    if(fileHandle)
+        CloseHandle(fileHandle);
+#else
+    if(mappedData)
+        munmap((void*)mappedData, mappedSize);
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &path)
+{
+    std::string key = canonicalPath(path);
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    auto it = mappings.find(key);
+    if(it != mappings.end())
+        return it -> second;
+
+    ProfileScope scope("MappedFile::open", key);
+    std::shared_ptr<MappedFile> file(new MappedFile());
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(key.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(handle == INVALID_HANDLE_VALUE)
+        return nullptr;
+    file -> fileHandle = handle;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(handle, &size))
+        return nullptr;
+    file -> mappedSize = (size_t)size.QuadPart;
+    if(file -> mappedSize > 0)
+    {
+        file -> mappingHandle = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(!file -> mappingHandle)
+            return nullptr;
+        file -> mappedData = (const unsigned char*)MapViewOfFile(file -> mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if(!file -> mappedData)
+            return nullptr;
+    }
+#else
+    int descriptor = ::open(key.c_str(), O_RDONLY);
+    if(descriptor < 0)
+        return nullptr;
+
+    struct stat status;
+    if(fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        return nullptr;
+    }
+    file -> mappedSize = (size_t)status.st_size;
+    if(file -> mappedSize > 0)
+    {
+        void *data = mmap(NULL, file -> mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if(data == MAP_FAILED)
+        {
+            close(descriptor);
+            return nullptr;
+        }
+        file -> mappedData = (const unsigned char*)data;
+    }
+    // the mapping keeps the file contents reachable without the descriptor
+    close(descriptor);
+#endif
+
+    mappings[key] = file;
+    return file;
+}
+
+void MappedFile::releaseMappings()
+{
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    mappings.clear();
+}
+
+const unsigned char* MappedFile::data() const
+{
+    return mappedData;
+}
+
+size_t MappedFile::size() const
+{
+    return mappedSize;
+}
+
+bool MappedIOSystem::Exists(const char *file) const
+{
+    const unsigned char *data;
+    size_t size;
+    return mapFileRegion(file, data, size);
+}
+
+char MappedIOSystem::getOsSeparator() const
+{
+    return '/';
+}
+
+Assimp::IOStream* MappedIOSystem::Open(const char *file, const char *mode)
+{
+    std::string access = mode ? mode : "rb";
+    if(access.find('w') != std::string::npos || access.find('a') != std::string::npos)
+    {
+        std::cout << "ERROR::MAPPED_IO::Writing is not supported: " << file << std::endl;
+        return nullptr;
+    }
+
+    // mappings stay cached, so the stream can point into them directly
+    const unsigned char *data;
+    size_t size;
+    if(!mapFileRegion(file, data, size))
+        return nullptr;
+    return new Assimp::MemoryIOStream(data, size, false);
+}
+
+void MappedIOSystem::Close(Assimp::IOStream *file)
+{
+    delete file;
+}
+
+void MappedIOSystem::mount(const std::string &path, const unsigned char *data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    MountedRegion region;
+    region.data = data;
+    region.size = size;
+    mounts[canonicalPath(path)] = region;
+}
+
+void MappedIOSystem::unmount(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    mounts.erase(canonicalPath(path));
+}
+
+bool MappedIOSystem::findMounted(const std::string &path, const unsigned char *&data, size_t &size)
+{
+    std::string key = canonicalPath(path);
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    auto it = mounts.find(key);
+    if(it == mounts.end())
+        return false;
+    data = it -> second.data;
+    size = it -> second.size;
+    return true;
+}
+
+bool mapFileRegion(const std::string &path, const unsigned char *&data, size_t &size)
+{
+    if(MappedIOSystem::findMounted(path, data, size))
+        return true;
+    if(AssetArchive::find(path, data, size))
+        return true;
+
+    std::shared_ptr<MappedFile> mapped = MappedFile::open(path);
+    if(!mapped)
+        return false;
+    data = mapped -> data();
+    size = mapped -> size();
+    return true;
+}
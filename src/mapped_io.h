@@ -0,0 +1,59 @@
+#ifndef MAPPED_IO_H
+#define MAPPED_IO_H
+
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
+
+#include <string>
+#include <memory>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. Mappings are cached by canonical
+// path for the lifetime of the process (or until releaseMappings), so loading
+// the same model again does not touch the file system.
+class MappedFile
+{
+    public:
+        ~MappedFile();
+
+        static std::shared_ptr<MappedFile> open(const std::string &path);
+        static void releaseMappings();
+
+        const unsigned char* data() const;
+        size_t size() const;
+
+    private:
+        const unsigned char *mappedData = nullptr;
+        size_t mappedSize = 0;
+#ifdef _WIN32
+        void *fileHandle = nullptr;
+        void *mappingHandle = nullptr;
+#endif
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// Assimp IOSystem that serves file contents straight out of memory: either a
+// region mounted by name (an entry of a packed archive, read in place) or a
+// cached MappedFile. Mounted regions are process-wide and must stay valid
+// until unmounted. Writing is not supported.
+class MappedIOSystem : public Assimp::IOSystem
+{
+    public:
+        bool Exists(const char *file) const override;
+        char getOsSeparator() const override;
+        Assimp::IOStream* Open(const char *file, const char *mode = "rb") override;
+        void Close(Assimp::IOStream *file) override;
+
+        static void mount(const std::string &path, const unsigned char *data, size_t size);
+        static void unmount(const std::string &path);
+        static bool findMounted(const std::string &path, const unsigned char *&data, size_t &size);
+};
+
+// mounted region first, then the asset archive, then a cached mapping of the
+// file on disk
+bool mapFileRegion(const std::string &path, const unsigned char *&data, size_t &size);
+
+#endif
@@ -0,0 +1,84 @@
+#include "material.h"
+#include "gl_state.h"
+
+#include <iostream>
+#include <atomic>
+
+// meshes are built on the upload thread as well
+static std::atomic<uint32_t> nextMaterialId(1);
+
+TextureRole textureRoleFromType(const std::string &type)
+{
+    if(type == "texture_specular")
+        return TEXTURE_SPECULAR;
+    return TEXTURE_DIFFUSE;
+}
+
+const char* textureRoleName(TextureRole role)
+{
+    switch(role)
+    {
+        case TEXTURE_SPECULAR: return "texture_specular";
+        default:               return "texture_diffuse";
+    }
+}
+
+Material::Material() : materialId(nextMaterialId++), count(0), bindingCount(0), nextEvicted(0)
+{
+    for(int i = 0; i < TEXTURE_ROLE_COUNT; i++)
+        roleCounts[i] = 0;
+}
+
+void Material::addTexture(GLuint id, TextureRole role)
+{
+    if(count == MAX_TEXTURES)
+    {
+        std::cout << "ERROR::MATERIAL::Too many textures, dropping " << textureRoleName(role) << std::endl;
+        return;
+    }
+    textures[count].id = id;
+    textures[count].role = role;
+    textures[count].index = ++roleCounts[role];
+    textures[count].sampler = textureRoleName(role) + std::to_string(textures[count].index);
+    count++;
+
+    // units were resolved for the old texture list
+    bindingCount = 0;
+    nextEvicted = 0;
+}
+
+const Material::ProgramBinding& Material::bindingFor(const Shader &shader)
+{
+    for(int i = 0; i < bindingCount; i++)
+    {
+        if(bindings[i].program == shader.ID)
+            return bindings[i];
+    }
+
+    // first draw with this program, or the first since it was evicted
+    ProgramBinding *binding;
+    if(bindingCount < MAX_PROGRAMS)
+    {
+        binding = &bindings[bindingCount++];
+    }
+    else
+    {
+        binding = &bindings[nextEvicted];
+        nextEvicted = (nextEvicted + 1) % MAX_PROGRAMS;
+    }
+    binding -> program = shader.ID;
+    for(int i = 0; i < count; i++)
+        binding -> units[i] = shader.samplerUnit(textures[i].sampler);
+    return *binding;
+}
+
+void Material::bind(const Shader &shader)
+{
+    const ProgramBinding &binding = bindingFor(shader);
+    for(int i = 0; i < count; i++)
+    {
+        if(binding.units[i] < 0)
+            continue;
+        GLState::instance().bindTexture((GLuint)binding.units[i], GL_TEXTURE_2D, textures[i].id);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <glad/glad.h>
+#include <string>
+#include <cstdint>
+
+#include "shader.h"
+
+enum TextureRole {
+    TEXTURE_DIFFUSE,
+    TEXTURE_SPECULAR,
+    TEXTURE_ROLE_COUNT
+};
+
+// maps the loaders' "texture_diffuse"/"texture_specular" type strings
+TextureRole textureRoleFromType(const std::string &type);
+const char* textureRoleName(TextureRole role);
+
+// Texture bindings baked when a mesh is loaded. Each texture keeps its role
+// and its index within that role (texture_diffuse1, texture_diffuse2, ...).
+// The first bind with a shader looks up the texture unit that shader assigned
+// to each sampler at link time and caches it per program, so every later
+// draw is just texture binds through GLState: no string work and no heap
+// allocations. Sampler names are built when a texture is added, so a program
+// evicted from the cache and drawn with again does not allocate either.
+// Textures whose sampler the shader does not use are skipped.
+class Material
+{
+    public:
+        static const int MAX_TEXTURES = 8;
+        static const int MAX_PROGRAMS = 4;
+
+        Material();
+        void addTexture(GLuint id, TextureRole role);
+        void bind(const Shader &shader);
+        int textureCount() const { return count; }
+        // distinct per constructed material, copies share it; used for draw sorting
+        uint32_t id() const { return materialId; }
+
+    private:
+        struct MaterialTexture {
+            GLuint id;
+            TextureRole role;
+            int index;
+            // texture_diffuse1, ...
+            std::string sampler;
+        };
+
+        // texture units for one program, -1 for samplers it lacks
+        struct ProgramBinding {
+            GLuint program;
+            GLint units[MAX_TEXTURES];
+        };
+
+        uint32_t materialId;
+        MaterialTexture textures[MAX_TEXTURES];
+        int count;
+        int roleCounts[TEXTURE_ROLE_COUNT];
+        ProgramBinding bindings[MAX_PROGRAMS];
+        int bindingCount;
+        int nextEvicted;
+
+        const ProgramBinding& bindingFor(const Shader &shader);
+};
+
+#endif
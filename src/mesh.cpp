@@ -1,25 +1,46 @@
 #include "mesh.h"
-
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, std::vector<Texture> textures){
+#include "texture_cache.h"
+#include "gl_state.h"
+
+// Buffers can be filled from any context sharing objects with the window, but
+// vertex array objects are not shared between contexts: an upload thread
+// passes createVertexArray = false and the render thread calls
+// setupVertexArray once the buffers are visible to it.
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, std::vector<Texture> textures, bool createVertexArray){
     this -> vertices = vertices;
     this -> indices = indices;
     this -> textures = textures;
+    VAO = 0;
+
+    // texture roles are resolved once here instead of on every draw
+    for(GLuint i = 0; i < textures.size(); i++)
+        material.addTexture(textures[i].id, textureRoleFromType(textures[i].type));
 
-    setupMesh();
+    uploadBuffers();
+    if(createVertexArray)
+        setupVertexArray();
 }
 
-void Mesh::setupMesh(){
-    glGenVertexArrays(1, &VAO);
+void Mesh::uploadBuffers(){
+    // the element buffer binding belongs to whichever vertex array is bound
+    GLState::instance().bindVertexArray(0);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Mesh::setupVertexArray(){
+    glGenVertexArrays(1, &VAO);
+    GLState::instance().bindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 
     //VERTEX ATTRIBUTE POINTER TO INTERPRET THE VERTICES IN THE VERTEX SHADER
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
@@ -33,74 +54,35 @@ void Mesh::setupMesh(){
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
+    GLState::instance().bindVertexArray(0);
 }
 
 void Mesh::Draw(Shader &shader)
 {
-    GLuint diffuseNr = 1;
-    GLuint specularNr = 1;
+    material.bind(shader);
 
-    for (GLuint i = 0; i < textures.size(); i++)
-    {
-        glActiveTexture(GL_TEXTURE0 + i);
-        std::string number;
-        std::string name = textures[i].type;
-        if(name == "texture_diffuse")
-        {
-            number = std::to_string(diffuseNr++);
-        } 
-        else if(name == "texture_specular")
-        {
-            number = std::to_string(specularNr++);
-        }
-
-        shader.setInt((name + number).c_str(), i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
-    }
-    
     //DRAW
-    glBindVertexArray(VAO);
+    GLState::instance().bindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    glActiveTexture(GL_TEXTURE0);
 }
 
 void Mesh::DrawInstances(Shader &shader, GLuint amount)
 {
-    GLuint diffuseNr = 1;
-    GLuint specularNr = 1;
+    material.bind(shader);
 
-    for (GLuint i = 0; i < textures.size(); i++)
-    {
-        glActiveTexture(GL_TEXTURE0 + i);
-        std::string number;
-        std::string name = textures[i].type;
-        if(name == "texture_diffuse")
-        {
-            number = std::to_string(diffuseNr++);
-        } 
-        else if(name == "texture_specular")
-        {
-            number = std::to_string(specularNr++);
-        }
-
-        shader.setInt((name + number).c_str(), i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
-    }
-    
     //DRAW
-    glBindVertexArray(VAO);
+    GLState::instance().bindVertexArray(VAO);
     glDrawElementsInstanced(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0, amount);
-    glBindVertexArray(0);
-
-    glActiveTexture(GL_TEXTURE0);
 }
 
 void Mesh::DeleteBuffers()
 {
-    glDeleteVertexArrays(1, &VAO);
+    GLState::instance().deleteVertexArray(VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+
+    for(GLuint i = 0; i < textures.size(); i++)
+    {
+        TextureCache::instance().release(textures[i].id);
+    }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "shader.h"
+#include "material.h"
 
 #include <vector>
 #include <string>
@@ -27,9 +28,11 @@ class Mesh {
         std::vector<Vertex>      vertices;
         std::vector<GLuint>      indices;
         std::vector<Texture>     textures;
+        Material                 material;
         GLuint VAO;
 
-        Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, std::vector<Texture> textures);
+        Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, std::vector<Texture> textures, bool createVertexArray = true);
+        void setupVertexArray();
         void Draw(Shader &shader);
         void DrawInstances(Shader &shader, GLuint amount);
         void DeleteBuffers();
@@ -38,7 +41,7 @@ class Mesh {
         //render data
         GLuint VBO, EBO;
 
-        void setupMesh();
+        void uploadBuffers();
 };
 
 #endif
\ No newline at end of file
@@ -1,8 +1,113 @@
 #include "model.h"
+#include "obj_loader.h"
+#include "mapped_io.h"
+#include "profiler.h"
 
-Model::Model(const char *path)
+#include <algorithm>
+#include <cstdlib>
+
+Model::Model(const char *path) : state(MODEL_EMPTY)
 {
+    importMeshes(path);
+    uploadMeshes();
+    finishMeshes();
+}
+
+Model::Model() : state(MODEL_EMPTY)
+{
+}
+
+// CPU only: parse the file into MeshData, safe to run on a worker thread
+void Model::importMeshes(std::string path)
+{
+    ProfileScope scope("Model::import", path);
     loadModel(path);
+    for(GLuint i = 0; i < pending.size(); i++)
+        scope.bytesDecoded(pending[i].vertices.size() * sizeof(Vertex) + pending[i].indices.size() * sizeof(GLuint));
+    state = MODEL_IMPORTED;
+}
+
+// buffers and textures; any context sharing objects with the window will do
+void Model::uploadMeshes()
+{
+    ProfileScope scope("Model::upload", directory);
+    // every texture of the model is read in a single I/O batch
+    std::vector<GLuint> ids = TextureCache::instance().acquireBatch(texturePaths());
+
+    size_t next = 0;
+    for(GLuint i = 0; i < pending.size(); i++)
+    {
+        std::vector<Texture> &textures = pending[i].textures;
+        for(GLuint j = 0; j < textures.size(); j++)
+        {
+            textures[j].id = ids[next++];
+        }
+        scope.bytesUploaded(pending[i].vertices.size() * sizeof(Vertex) + pending[i].indices.size() * sizeof(GLuint));
+        uploaded.push_back(Mesh(pending[i].vertices, pending[i].indices, textures, false));
+    }
+    pending.clear();
+}
+
+// texture files of the imported meshes, in mesh order
+std::vector<std::string> Model::texturePaths() const
+{
+    std::vector<std::string> paths;
+    for(GLuint i = 0; i < pending.size(); i++)
+    {
+        for(GLuint j = 0; j < pending[i].textures.size(); j++)
+            paths.push_back(directory + "/" + pending[i].textures[j].path);
+    }
+    return paths;
+}
+
+// texture names of the uploaded (or finished) meshes
+std::vector<GLuint> Model::textureIds() const
+{
+    std::vector<GLuint> ids;
+    const std::vector<Mesh> &source = uploaded.empty() ? meshes : uploaded;
+    for(GLuint i = 0; i < source.size(); i++)
+    {
+        for(GLuint j = 0; j < source[i].textures.size(); j++)
+            ids.push_back(source[i].textures[j].id);
+    }
+    return ids;
+}
+
+// marks the end of the uploads so the render thread can tell when they landed
+void Model::fenceUploads()
+{
+    uploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    state = MODEL_UPLOADED;
+}
+
+// vertex arrays, on the render thread
+void Model::finishMeshes()
+{
+    for(GLuint i = 0; i < uploaded.size(); i++)
+    {
+        uploaded[i].setupVertexArray();
+    }
+    meshes.swap(uploaded);
+    uploaded.clear();
+    state = MODEL_READY;
+}
+
+bool Model::isReady()
+{
+    if(state == MODEL_READY)
+        return true;
+    if(state != MODEL_UPLOADED)
+        return false;
+
+    GLenum status = glClientWaitSync(uploadFence, 0, 0);
+    if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        return false;
+
+    glDeleteSync(uploadFence);
+    uploadFence = 0;
+    finishMeshes();
+    return true;
 }
 
 void Model::Draw(Shader &shader)
@@ -23,7 +128,17 @@ void Model::DrawInstances(Shader &shader, GLuint amount)
 
 void Model::loadModel(std::string path)
 {
+    directory = path.substr(0, path.find_last_of('/'));
+
+    // OBJ files take the native loader unless ASTEROID_OBJ_ASSIMP is set,
+    // which keeps the Assimp path around for comparisons
+    std::string extension = path.substr(path.find_last_of('.') + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if(extension == "obj" && !std::getenv("ASTEROID_OBJ_ASSIMP") && loadObjModel(path))
+        return;
+
     Assimp::Importer import;
+    import.SetIOHandler(new MappedIOSystem());
     const aiScene *scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
 
     if(!scene || scene -> mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene -> mRootNode)
@@ -31,16 +146,47 @@ void Model::loadModel(std::string path)
         std::cout << "ERROR::ASSIMP::" << import.GetErrorString() << std::endl;
         return;
     }
-    directory = path.substr(0, path.find_last_of('/'));
     processNode(scene->mRootNode, scene);
 }
 
+bool Model::loadObjModel(std::string path)
+{
+    std::vector<ObjMesh> objMeshes;
+    if(!loadObj(path, objMeshes))
+        return false;
+
+    for(GLuint i = 0; i < objMeshes.size(); i++)
+    {
+        MeshData data;
+        data.vertices.swap(objMeshes[i].vertices);
+        data.indices.swap(objMeshes[i].indices);
+        if(!objMeshes[i].diffuseMap.empty())
+        {
+            Texture texture;
+            texture.id = 0;
+            texture.type = "texture_diffuse";
+            texture.path = objMeshes[i].diffuseMap;
+            data.textures.push_back(texture);
+        }
+        if(!objMeshes[i].specularMap.empty())
+        {
+            Texture texture;
+            texture.id = 0;
+            texture.type = "texture_specular";
+            texture.path = objMeshes[i].specularMap;
+            data.textures.push_back(texture);
+        }
+        pending.push_back(data);
+    }
+    return true;
+}
+
 void Model::processNode(aiNode *node, const aiScene *scene)
 {
     for(GLuint i = 0; i < node -> mNumMeshes; i++)
     {
         aiMesh *mesh = scene -> mMeshes[node -> mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+        pending.push_back(processMesh(mesh, scene));
     }
     for(GLuint i = 0; i < node -> mNumChildren; i++)
     {
@@ -48,7 +194,7 @@ void Model::processNode(aiNode *node, const aiScene *scene)
     }
 }
 
-Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene)
+MeshData Model::processMesh(aiMesh *mesh, const aiScene *scene)
 {
     std::vector<Vertex> vertices;
     std::vector<GLuint> indices;
@@ -100,7 +246,11 @@ Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene)
         std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
     }
-    return Mesh(vertices, indices, textures);
+    MeshData data;
+    data.vertices.swap(vertices);
+    data.indices.swap(indices);
+    data.textures.swap(textures);
+    return data;
 }
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName)
@@ -111,62 +261,26 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType
     {
         aiString str;
         mat -> GetTexture(type, i, &str);
-        bool skip = false;
-        for(GLuint j = 0; j < textures_loaded.size(); j++)
-        {
-            if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-            {
-                textures.push_back(textures_loaded[j]);
-                skip = true;
-                break;
-            }
-        }
-        if(!skip)
-        {
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), directory);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            textures_loaded.push_back(texture);
-        }
+        Texture texture;
+        texture.id = 0;
+        texture.type = typeName;
+        texture.path = str.C_Str();
+        textures.push_back(texture);
     }
     return textures;
 }
 
-GLuint Model::TextureFromFile(std::string location, std::string directory)
-{
-    GLint width, height, nrChannels;
-    unsigned char *data = stbi_load((directory + "/" +location).c_str(), &width, &height, &nrChannels, 0);
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    if(data)
-    {
-        GLenum format;
-        if(nrChannels == 1)
-            format = GL_RED;
-        else if(nrChannels == 3)
-            format = GL_RGB;
-        else if(nrChannels == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-
-    stbi_image_free(data);
-    return textureID;
-}
-
 void Model::DeleteBuffers()
 {
     for(GLuint i = 0; i < meshes.size(); i++)
     {
         meshes[i].DeleteBuffers();
     }
+    // uploaded but never made ready, e.g. when the window closed mid-load
+    for(GLuint i = 0; i < uploaded.size(); i++)
+    {
+        uploaded[i].DeleteBuffers();
+    }
+    if(uploadFence)
+        glDeleteSync(uploadFence);
 }
\ No newline at end of file
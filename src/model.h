@@ -3,31 +3,61 @@
 
 #include"shader.h"
 #include "mesh.h"
-#include "stb_image.h"
+#include "texture_cache.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <vector>
+#include <atomic>
+
+// CPU side of a mesh between import and upload; texture ids are resolved
+// through the TextureCache when the mesh is uploaded
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    std::vector<Texture> textures;
+};
+
+enum Model_State {
+    MODEL_EMPTY,
+    MODEL_IMPORTED,
+    MODEL_UPLOADED,
+    MODEL_READY
+};
 
 class Model
 {
     public:
         Model(const char *path);
+        Model();
         void Draw(Shader &shader);
         void DrawInstances(Shader &shader, GLuint amount);
         void DeleteBuffers();
+        bool isReady();
         std::vector<Mesh> meshes;
+
+        // load phases, see AssetLoader; the constructor taking a path runs all
+        // of them on the calling thread
+        void importMeshes(std::string path);
+        void uploadMeshes();
+        void fenceUploads();
+        void finishMeshes();
+        std::vector<std::string> texturePaths() const;
+        std::vector<GLuint> textureIds() const;
     
     private:
         
         std::string directory;
-        std::vector<Texture> textures_loaded;
+        std::vector<MeshData> pending;
+        std::vector<Mesh> uploaded;
+        GLsync uploadFence = 0;
+        std::atomic<int> state;
 
         void loadModel(std::string path);
+        bool loadObjModel(std::string path);
         void processNode(aiNode *node, const aiScene *scene);
-        Mesh processMesh(aiMesh *mesh, const aiScene *scene);
+        MeshData processMesh(aiMesh *mesh, const aiScene *scene);
         std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
-        GLuint TextureFromFile(std::string location, std::string directory);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,625 @@
+#include "null_gl.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+enum NullGLEntry {
+#define GL_FUNCTION(ret, name, params, args) NULL_GL_##name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+    NULL_GL_ENTRY_COUNT
+};
+
+static const char* const NULL_GL_NAMES[NULL_GL_ENTRY_COUNT] = {
+#define GL_FUNCTION(ret, name, params, args) #name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+};
+
+static std::atomic<uint64_t> callCounts[NULL_GL_ENTRY_COUNT];
+static std::atomic<uint64_t> bufferBytes(0);
+static std::atomic<uint64_t> textureBytes(0);
+static std::atomic<GLuint> nextName(1);
+static std::atomic<uintptr_t> nextSync(1);
+// per thread, like the context state it stands in for
+static thread_local GLuint unpackBuffer = 0;
+static thread_local std::vector<char> mappedScratch;
+
+static void countCall(NullGLEntry entry)
+{
+    callCounts[entry].fetch_add(1, std::memory_order_relaxed);
+}
+
+// the generated stubs name every parameter but read none of them
+template<typename... Args>
+static void unused(const Args &...) {}
+
+// stubs for everything without special behaviour: count and return zero
+#define GL_FUNCTION(ret, name, params, args) \
+    static ret APIENTRY nullDefault_##name params { unused args; countCall(NULL_GL_##name); return (ret)0; }
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+static void generateNames(GLsizei n, GLuint *names)
+{
+    for(GLsizei i = 0; i < n; i++)
+        names[i] = nextName++;
+}
+
+size_t pixelBytes(GLenum format, GLenum type)
+{
+    size_t components;
+    switch(format)
+    {
+        case GL_RG:   components = 2; break;
+        case GL_RGB:
+        case GL_BGR:  components = 3; break;
+        case GL_RGBA:
+        case GL_BGRA: components = 4; break;
+        default:      components = 1; break;
+    }
+    switch(type)
+    {
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:        return components * 2;
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:             return components * 4;
+        case GL_UNSIGNED_INT_24_8: return 4;
+        default:                   return components;
+    }
+}
+
+// with a pixel unpack buffer bound the pointer is an offset, 0 included
+static void accountTexture(const void *pixels, size_t bytes)
+{
+    if(pixels || unpackBuffer)
+        textureBytes += bytes;
+}
+
+static const GLubyte* APIENTRY nullGetString(GLenum name)
+{
+    countCall(NULL_GL_glGetString);
+    switch(name)
+    {
+        case GL_VENDOR:                   return (const GLubyte*)"Asteroid";
+        case GL_RENDERER:                 return (const GLubyte*)"Null GL";
+        case GL_VERSION:                  return (const GLubyte*)"3.3.0 Null";
+        case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"3.30";
+        default:                          return NULL;
+    }
+}
+
+// glad refuses a context without extensions, so one harmless one is listed
+static const GLubyte* APIENTRY nullGetStringi(GLenum name, GLuint index)
+{
+    countCall(NULL_GL_glGetStringi);
+    return name == GL_EXTENSIONS && index == 0 ? (const GLubyte*)"GL_KHR_debug" : NULL;
+}
+
+static void APIENTRY nullGetIntegerv(GLenum pname, GLint *data)
+{
+    countCall(NULL_GL_glGetIntegerv);
+    switch(pname)
+    {
+        case GL_NUM_EXTENSIONS:                     *data = 1; break;
+        case GL_MAX_TEXTURE_SIZE:                   *data = 16384; break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:            *data = 32; break;
+        case GL_MAX_SAMPLES:                        *data = 8; break;
+        case GL_MAX_UNIFORM_BUFFER_BINDINGS:        *data = 36; break;
+        case GL_MAJOR_VERSION:                      *data = 3; break;
+        case GL_MINOR_VERSION:                      *data = 3; break;
+        default:                                    *data = 0; break;
+    }
+}
+
+#define NULL_GL_GENERATE(name) \
+    static void APIENTRY nullGenerate_##name(GLsizei n, GLuint *names) { countCall(NULL_GL_##name); generateNames(n, names); }
+NULL_GL_GENERATE(glGenBuffers)
+NULL_GL_GENERATE(glGenTextures)
+NULL_GL_GENERATE(glGenVertexArrays)
+NULL_GL_GENERATE(glGenFramebuffers)
+NULL_GL_GENERATE(glGenRenderbuffers)
+NULL_GL_GENERATE(glGenQueries)
+NULL_GL_GENERATE(glGenSamplers)
+#undef NULL_GL_GENERATE
+
+static GLuint APIENTRY nullCreateShader(GLenum)
+{
+    countCall(NULL_GL_glCreateShader);
+    return nextName++;
+}
+
+static GLuint APIENTRY nullCreateProgram()
+{
+    countCall(NULL_GL_glCreateProgram);
+    return nextName++;
+}
+
+// A linked program reports the default-block uniforms its shaders' sources
+// declare, one location each in declaration order; arrays are reported as
+// "name[0]". Shaders are compiled on the upload thread as well.
+struct NullUniform {
+    std::string name;
+    GLenum type;
+    GLint size;
+};
+
+static std::mutex programMutex;
+static std::unordered_map<GLuint, std::string> shaderSources;
+static std::unordered_map<GLuint, std::vector<GLuint>> attachedShaders;
+static std::unordered_map<GLuint, std::vector<NullUniform>> programUniforms;
+
+static GLenum uniformType(const std::string &type)
+{
+    static const std::unordered_map<std::string, GLenum> types = {
+        { "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+        { "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+        { "uint", GL_UNSIGNED_INT }, { "bool", GL_BOOL },
+        { "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+        { "sampler2D", GL_SAMPLER_2D }, { "sampler2DMS", GL_SAMPLER_2D_MULTISAMPLE },
+        { "samplerCube", GL_SAMPLER_CUBE }, { "sampler2DShadow", GL_SAMPLER_2D_SHADOW },
+        { "sampler2DArray", GL_SAMPLER_2D_ARRAY }, { "sampler3D", GL_SAMPLER_3D }
+    };
+    auto it = types.find(type);
+    return it == types.end() ? GL_FLOAT : it -> second;
+}
+
+// one declaration per line, the way the shaders here are written; #define,
+// #ifdef, #ifndef, #else and #endif are followed, any other #if counts as true
+static void declaredUniforms(const std::string &source, std::vector<NullUniform> &uniforms)
+{
+    std::unordered_set<std::string> defines;
+    std::vector<bool> conditions;
+    bool inBlock = false;
+    std::istringstream lines(source);
+    std::string line;
+    while(std::getline(lines, line))
+    {
+        std::istringstream words(line);
+        std::string word;
+        if(!(words >> word))
+            continue;
+        bool enabled = std::find(conditions.begin(), conditions.end(), false) == conditions.end();
+        if(word[0] == '#')
+        {
+            std::string name;
+            words >> name;
+            if(word == "#ifdef" || word == "#ifndef")
+                conditions.push_back((defines.count(name) > 0) == (word == "#ifdef"));
+            else if(word == "#if")
+                conditions.push_back(true);
+            else if(word == "#else" && !conditions.empty())
+                conditions.back() = !conditions.back();
+            else if(word == "#endif" && !conditions.empty())
+                conditions.pop_back();
+            else if(word == "#define" && enabled)
+                defines.insert(name);
+            continue;
+        }
+        if(!enabled)
+            continue;
+        // members of a uniform block have no location of their own
+        if(inBlock)
+        {
+            inBlock = line.find('}') == std::string::npos;
+            continue;
+        }
+        if(word.compare(0, 6, "layout") == 0)
+        {
+            size_t close = line.find(')');
+            if(close == std::string::npos)
+                continue;
+            words.str(line.substr(close + 1));
+            words.clear();
+            if(!(words >> word))
+                continue;
+        }
+        if(word != "uniform")
+            continue;
+        if(line.find(';') == std::string::npos || line.find('{') != std::string::npos)
+        {
+            inBlock = line.find('}') == std::string::npos;
+            continue;
+        }
+
+        std::string type, name;
+        words >> type;
+        if(type == "lowp" || type == "mediump" || type == "highp")
+            words >> type;
+        words >> name;
+        name = name.substr(0, name.find(';'));
+        NullUniform uniform;
+        uniform.type = uniformType(type);
+        uniform.size = 1;
+        size_t bracket = name.find('[');
+        if(bracket != std::string::npos)
+        {
+            uniform.size = std::max(std::atoi(name.c_str() + bracket + 1), 1);
+            name = name.substr(0, bracket) + "[0]";
+        }
+        uniform.name = name;
+        bool declared = false;
+        for(size_t i = 0; i < uniforms.size() && !declared; i++)
+            declared = uniforms[i].name == name;
+        if(!declared && !name.empty())
+            uniforms.push_back(uniform);
+    }
+}
+
+static void APIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    countCall(NULL_GL_glShaderSource);
+    std::string source;
+    for(GLsizei i = 0; i < count; i++)
+    {
+        if(length && length[i] >= 0)
+            source.append(string[i], (size_t)length[i]);
+        else
+            source.append(string[i]);
+    }
+    std::lock_guard<std::mutex> lock(programMutex);
+    shaderSources[shader] = source;
+}
+
+static void APIENTRY nullAttachShader(GLuint program, GLuint shader)
+{
+    countCall(NULL_GL_glAttachShader);
+    std::lock_guard<std::mutex> lock(programMutex);
+    attachedShaders[program].push_back(shader);
+}
+
+static void APIENTRY nullLinkProgram(GLuint program)
+{
+    countCall(NULL_GL_glLinkProgram);
+    std::lock_guard<std::mutex> lock(programMutex);
+    std::vector<NullUniform> uniforms;
+    const std::vector<GLuint> &shaders = attachedShaders[program];
+    for(size_t i = 0; i < shaders.size(); i++)
+        declaredUniforms(shaderSources[shaders[i]], uniforms);
+    programUniforms[program] = uniforms;
+}
+
+static void APIENTRY nullDeleteShader(GLuint shader)
+{
+    countCall(NULL_GL_glDeleteShader);
+    std::lock_guard<std::mutex> lock(programMutex);
+    shaderSources.erase(shader);
+}
+
+static void APIENTRY nullDeleteProgram(GLuint program)
+{
+    countCall(NULL_GL_glDeleteProgram);
+    std::lock_guard<std::mutex> lock(programMutex);
+    attachedShaders.erase(program);
+    programUniforms.erase(program);
+}
+
+// every shader compiles and every program links
+static void APIENTRY nullGetShaderiv(GLuint, GLenum pname, GLint *params)
+{
+    countCall(NULL_GL_glGetShaderiv);
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    countCall(NULL_GL_glGetProgramiv);
+    std::lock_guard<std::mutex> lock(programMutex);
+    const std::vector<NullUniform> &uniforms = programUniforms[program];
+    switch(pname)
+    {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            *params = GL_TRUE;
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            *params = (GLint)uniforms.size();
+            break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+            *params = 0;
+            for(size_t i = 0; i < uniforms.size(); i++)
+                *params = std::max(*params, (GLint)uniforms[i].name.size() + 1);
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+static void APIENTRY nullGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    countCall(NULL_GL_glGetShaderInfoLog);
+    if(length)
+        *length = 0;
+    if(bufSize > 0)
+        infoLog[0] = '\0';
+}
+
+static void APIENTRY nullGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    countCall(NULL_GL_glGetProgramInfoLog);
+    if(length)
+        *length = 0;
+    if(bufSize > 0)
+        infoLog[0] = '\0';
+}
+
+static void APIENTRY nullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+    countCall(NULL_GL_glGetActiveUniform);
+    std::lock_guard<std::mutex> lock(programMutex);
+    const std::vector<NullUniform> &uniforms = programUniforms[program];
+    std::string uniformName = index < uniforms.size() ? uniforms[index].name : std::string();
+    GLsizei copied = bufSize > 0 ? std::min((GLsizei)uniformName.size(), bufSize - 1) : 0;
+    if(bufSize > 0)
+    {
+        memcpy(name, uniformName.data(), (size_t)copied);
+        name[copied] = '\0';
+    }
+    if(length)
+        *length = copied;
+    *size = index < uniforms.size() ? uniforms[index].size : 0;
+    *type = index < uniforms.size() ? uniforms[index].type : 0;
+}
+
+static GLint APIENTRY nullGetUniformLocation(GLuint program, const GLchar *name)
+{
+    countCall(NULL_GL_glGetUniformLocation);
+    std::lock_guard<std::mutex> lock(programMutex);
+    const std::vector<NullUniform> &uniforms = programUniforms[program];
+    for(size_t i = 0; i < uniforms.size(); i++)
+    {
+        const std::string &declared = uniforms[i].name;
+        size_t bracket = declared.find('[');
+        if(declared == name || (bracket != std::string::npos && declared.compare(0, bracket, name) == 0 && name[bracket] == '\0'))
+            return (GLint)i;
+    }
+    return -1;
+}
+
+static GLuint APIENTRY nullGetUniformBlockIndex(GLuint, const GLchar *)
+{
+    countCall(NULL_GL_glGetUniformBlockIndex);
+    return GL_INVALID_INDEX;
+}
+
+static GLenum APIENTRY nullCheckFramebufferStatus(GLenum)
+{
+    countCall(NULL_GL_glCheckFramebufferStatus);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void APIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+    countCall(NULL_GL_glBindBuffer);
+    if(target == GL_PIXEL_UNPACK_BUFFER)
+        unpackBuffer = buffer;
+}
+
+static void APIENTRY nullBufferData(GLenum, GLsizeiptr size, const void *data, GLenum)
+{
+    countCall(NULL_GL_glBufferData);
+    if(data)
+        bufferBytes += (uint64_t)size;
+}
+
+static void APIENTRY nullBufferSubData(GLenum, GLintptr, GLsizeiptr size, const void *)
+{
+    countCall(NULL_GL_glBufferSubData);
+    bufferBytes += (uint64_t)size;
+}
+
+static void* APIENTRY nullMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield access)
+{
+    countCall(NULL_GL_glMapBufferRange);
+    if(access & GL_MAP_WRITE_BIT)
+        bufferBytes += (uint64_t)length;
+    if(mappedScratch.size() < (size_t)length)
+        mappedScratch.resize((size_t)length);
+    return mappedScratch.data();
+}
+
+static GLboolean APIENTRY nullUnmapBuffer(GLenum)
+{
+    countCall(NULL_GL_glUnmapBuffer);
+    return GL_TRUE;
+}
+
+static void APIENTRY nullTexImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height,
+                                    GLint, GLenum format, GLenum type, const void *pixels)
+{
+    countCall(NULL_GL_glTexImage2D);
+    accountTexture(pixels, (size_t)width * height * pixelBytes(format, type));
+}
+
+static void APIENTRY nullTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height,
+                                       GLenum format, GLenum type, const void *pixels)
+{
+    countCall(NULL_GL_glTexSubImage2D);
+    accountTexture(pixels, (size_t)width * height * pixelBytes(format, type));
+}
+
+static void APIENTRY nullCompressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei,
+                                              GLint, GLsizei imageSize, const void *data)
+{
+    countCall(NULL_GL_glCompressedTexImage2D);
+    accountTexture(data, (size_t)imageSize);
+}
+
+static void APIENTRY nullCompressedTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei,
+                                                 GLenum, GLsizei imageSize, const void *data)
+{
+    countCall(NULL_GL_glCompressedTexSubImage2D);
+    accountTexture(data, (size_t)imageSize);
+}
+
+static GLsync APIENTRY nullFenceSync(GLenum, GLbitfield)
+{
+    countCall(NULL_GL_glFenceSync);
+    return (GLsync)nextSync++;
+}
+
+static GLenum APIENTRY nullClientWaitSync(GLsync, GLbitfield, GLuint64)
+{
+    countCall(NULL_GL_glClientWaitSync);
+    return GL_ALREADY_SIGNALED;
+}
+
+// queries are always available and measured nothing
+static void APIENTRY nullGetQueryObjectiv(GLuint, GLenum pname, GLint *params)
+{
+    countCall(NULL_GL_glGetQueryObjectiv);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetQueryObjectuiv(GLuint, GLenum pname, GLuint *params)
+{
+    countCall(NULL_GL_glGetQueryObjectuiv);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetQueryObjecti64v(GLuint, GLenum pname, GLint64 *params)
+{
+    countCall(NULL_GL_glGetQueryObjecti64v);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static void APIENTRY nullGetQueryObjectui64v(GLuint, GLenum pname, GLuint64 *params)
+{
+    countCall(NULL_GL_glGetQueryObjectui64v);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+struct NullGLOverride {
+    const char *name;
+    void *function;
+};
+
+static const NullGLOverride NULL_GL_OVERRIDES[] = {
+    { "glGetString", (void*)nullGetString },
+    { "glGetStringi", (void*)nullGetStringi },
+    { "glGetIntegerv", (void*)nullGetIntegerv },
+    { "glGenBuffers", (void*)nullGenerate_glGenBuffers },
+    { "glGenTextures", (void*)nullGenerate_glGenTextures },
+    { "glGenVertexArrays", (void*)nullGenerate_glGenVertexArrays },
+    { "glGenFramebuffers", (void*)nullGenerate_glGenFramebuffers },
+    { "glGenRenderbuffers", (void*)nullGenerate_glGenRenderbuffers },
+    { "glGenQueries", (void*)nullGenerate_glGenQueries },
+    { "glGenSamplers", (void*)nullGenerate_glGenSamplers },
+    { "glCreateShader", (void*)nullCreateShader },
+    { "glCreateProgram", (void*)nullCreateProgram },
+    { "glShaderSource", (void*)nullShaderSource },
+    { "glAttachShader", (void*)nullAttachShader },
+    { "glLinkProgram", (void*)nullLinkProgram },
+    { "glDeleteShader", (void*)nullDeleteShader },
+    { "glDeleteProgram", (void*)nullDeleteProgram },
+    { "glGetShaderiv", (void*)nullGetShaderiv },
+    { "glGetProgramiv", (void*)nullGetProgramiv },
+    { "glGetShaderInfoLog", (void*)nullGetShaderInfoLog },
+    { "glGetProgramInfoLog", (void*)nullGetProgramInfoLog },
+    { "glGetActiveUniform", (void*)nullGetActiveUniform },
+    { "glGetUniformLocation", (void*)nullGetUniformLocation },
+    { "glGetUniformBlockIndex", (void*)nullGetUniformBlockIndex },
+    { "glCheckFramebufferStatus", (void*)nullCheckFramebufferStatus },
+    { "glBindBuffer", (void*)nullBindBuffer },
+    { "glBufferData", (void*)nullBufferData },
+    { "glBufferSubData", (void*)nullBufferSubData },
+    { "glMapBufferRange", (void*)nullMapBufferRange },
+    { "glUnmapBuffer", (void*)nullUnmapBuffer },
+    { "glTexImage2D", (void*)nullTexImage2D },
+    { "glTexSubImage2D", (void*)nullTexSubImage2D },
+    { "glCompressedTexImage2D", (void*)nullCompressedTexImage2D },
+    { "glCompressedTexSubImage2D", (void*)nullCompressedTexSubImage2D },
+    { "glFenceSync", (void*)nullFenceSync },
+    { "glClientWaitSync", (void*)nullClientWaitSync },
+    { "glGetQueryObjectiv", (void*)nullGetQueryObjectiv },
+    { "glGetQueryObjectuiv", (void*)nullGetQueryObjectuiv },
+    { "glGetQueryObjecti64v", (void*)nullGetQueryObjecti64v },
+    { "glGetQueryObjectui64v", (void*)nullGetQueryObjectui64v },
+};
+
+static void* const NULL_GL_DEFAULTS[NULL_GL_ENTRY_COUNT] = {
+#define GL_FUNCTION(ret, name, params, args) (void*)nullDefault_##name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+};
+
+bool NullGL::requested()
+{
+    const char *backend = std::getenv("ASTEROID_GL");
+    return backend && std::strcmp(backend, "null") == 0;
+}
+
+void* NullGL::loader(const char *name)
+{
+    for(size_t i = 0; i < sizeof(NULL_GL_OVERRIDES) / sizeof(NULL_GL_OVERRIDES[0]); i++)
+    {
+        if(std::strcmp(NULL_GL_OVERRIDES[i].name, name) == 0)
+            return NULL_GL_OVERRIDES[i].function;
+    }
+    for(int i = 0; i < NULL_GL_ENTRY_COUNT; i++)
+    {
+        if(std::strcmp(NULL_GL_NAMES[i], name) == 0)
+            return NULL_GL_DEFAULTS[i];
+    }
+    return NULL;
+}
+
+uint64_t NullGL::calls()
+{
+    uint64_t total = 0;
+    for(int i = 0; i < NULL_GL_ENTRY_COUNT; i++)
+        total += callCounts[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t NullGL::calls(const char *entryPoint)
+{
+    for(int i = 0; i < NULL_GL_ENTRY_COUNT; i++)
+    {
+        if(std::strcmp(NULL_GL_NAMES[i], entryPoint) == 0)
+            return callCounts[i].load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+uint64_t NullGL::uploadBytes()
+{
+    return bufferBytes + textureBytes;
+}
+
+void NullGL::printStats()
+{
+    std::vector<int> entries;
+    for(int i = 0; i < NULL_GL_ENTRY_COUNT; i++)
+    {
+        if(callCounts[i].load(std::memory_order_relaxed))
+            entries.push_back(i);
+    }
+    std::sort(entries.begin(), entries.end(), [](int a, int b) {
+        return callCounts[a].load(std::memory_order_relaxed) > callCounts[b].load(std::memory_order_relaxed);
+    });
+
+    std::cout << "NULL_GL:: " << calls() << " calls to " << entries.size() << " entry points, "
+              << bufferBytes / 1024 << " KiB buffer data, " << textureBytes / 1024 << " KiB texture data" << std::endl;
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        char line[128];
+        snprintf(line, sizeof(line), "NULL_GL:: %12llu  %s",
+                 (unsigned long long)callCounts[entries[i]].load(std::memory_order_relaxed), NULL_GL_NAMES[entries[i]]);
+        std::cout << line << std::endl;
+    }
+}
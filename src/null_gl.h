@@ -0,0 +1,35 @@
+#ifndef NULL_GL_H
+#define NULL_GL_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstddef>
+
+// GL backend that does no rendering, for measuring CPU-side frame cost on
+// machines without a GPU. ASTEROID_GL=null makes main skip window and
+// context creation and hand loader() to gladLoadGLLoader instead of the GLFW
+// one, so every glad function pointer lands on a stub. Stubs count calls per
+// entry point, hand out object names, report shaders and framebuffers as
+// complete, map buffers to scratch memory and account the bytes passed to
+// buffer and texture uploads. Linked programs report the uniforms their
+// shader sources declare, so uniform lookups and sampler setup take the
+// same path as on a driver. Everything else returns zero.
+class NullGL
+{
+    public:
+        static bool requested();
+        static void* loader(const char *name);
+
+        static uint64_t calls();
+        // calls to one entry point, e.g. "glBindTexture"
+        static uint64_t calls(const char *entryPoint);
+        static uint64_t uploadBytes();
+        // per entry point call counts, busiest first, and upload totals
+        static void printStats();
+};
+
+// bytes per pixel of client data in the given format and type, for upload
+// accounting here and in GLTrace
+size_t pixelBytes(GLenum format, GLenum type);
+
+#endif
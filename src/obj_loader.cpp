@@ -0,0 +1,537 @@
+#include "obj_loader.h"
+#include "thread_pool.h"
+#include "mapped_io.h"
+
+#include <assimp/fast_atof.h>
+
+#include <iostream>
+#include <cstring>
+#include <unordered_map>
+#include <future>
+#include <algorithm>
+
+//CHUNK PARSING-------------------------------------------------------------------------------------------
+namespace {
+
+// a face corner; negative OBJ indices are only resolvable once the number
+// of elements in the preceding chunks is known, so they stay chunk-relative
+struct Corner {
+    int v, vt, vn;
+    unsigned char relative;
+};
+
+enum {
+    RELATIVE_V = 1,
+    RELATIVE_VT = 2,
+    RELATIVE_VN = 4
+};
+
+struct Segment {
+    size_t firstFace;
+    bool setsObject, setsMaterial;
+    std::string object, material;
+};
+
+struct Chunk {
+    const char *begin;
+    const char *end;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<Corner> corners;
+    std::vector<size_t> faceStarts;
+    std::vector<Segment> segments;
+    std::vector<std::string> materialLibraries;
+    size_t positionBase = 0, normalBase = 0, texCoordBase = 0;
+    bool failed = false;
+};
+
+struct FaceRange {
+    const Chunk *chunk;
+    size_t first, last;
+};
+
+struct CornerKey {
+    int v, vt, vn;
+    bool operator==(const CornerKey &other) const
+    {
+        return v == other.v && vt == other.vt && vn == other.vn;
+    }
+};
+
+struct CornerKeyHash {
+    size_t operator()(const CornerKey &key) const
+    {
+        uint64_t hash = (uint64_t)(uint32_t)key.v * 0x9E3779B97F4A7C15ull;
+        hash ^= (uint64_t)(uint32_t)key.vt * 0xC2B2AE3D27D4EB4Full + (hash >> 29);
+        hash ^= (uint64_t)(uint32_t)key.vn * 0x165667B19E3779F9ull + (hash >> 32);
+        return (size_t)hash;
+    }
+};
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+inline bool isLineEnd(const char *c, const char *end)
+{
+    return c >= end || *c == '\n' || *c == '\r';
+}
+
+inline const char* skipSpaces(const char *c, const char *end)
+{
+    while(c < end && isSpace(*c))
+        c++;
+    return c;
+}
+
+inline const char* nextLine(const char *c, const char *end)
+{
+    while(c < end && *c != '\n')
+        c++;
+    return c < end ? c + 1 : end;
+}
+
+inline bool parseFloat(const char *&c, const char *end, float &out)
+{
+    c = skipSpaces(c, end);
+    if(c >= end || !((*c >= '0' && *c <= '9') || *c == '-' || *c == '+' || *c == '.'))
+        return false;
+    c = Assimp::fast_atoreal_move<float>(c, out, false);
+    return true;
+}
+
+inline std::string parseName(const char *c, const char *end)
+{
+    c = skipSpaces(c, end);
+    const char *last = c;
+    while(!isLineEnd(last, end))
+        last++;
+    while(last > c && isSpace(last[-1]))
+        last--;
+    return std::string(c, last);
+}
+
+// parses "v", "v/vt", "v//vn" or "v/vt/vn"; returns false at the end of the line
+bool parseCorner(const char *&c, const char *end, Chunk &chunk, Corner &corner)
+{
+    c = skipSpaces(c, end);
+    if(isLineEnd(c, end))
+        return false;
+
+    int *targets[3] = {&corner.v, &corner.vt, &corner.vn};
+    size_t counts[3] = {chunk.positions.size(), chunk.texCoords.size(), chunk.normals.size()};
+    unsigned char flags[3] = {RELATIVE_V, RELATIVE_VT, RELATIVE_VN};
+    corner.v = corner.vt = corner.vn = -1;
+    corner.relative = 0;
+
+    for(int slot = 0; slot < 3; slot++)
+    {
+        if(slot > 0)
+        {
+            if(c >= end || *c != '/')
+                break;
+            c++;
+        }
+        if(c < end && (*c == '-' || (*c >= '0' && *c <= '9')))
+        {
+            int index = Assimp::strtol10(c, &c);
+            if(index > 0)
+            {
+                *targets[slot] = index - 1;
+            }
+            else if(index < 0)
+            {
+                *targets[slot] = (int)counts[slot] + index;
+                corner.relative |= flags[slot];
+            }
+        }
+    }
+    if(corner.v == -1 && !(corner.relative & RELATIVE_V))
+    {
+        chunk.failed = true;
+        return false;
+    }
+    // skip anything unexpected up to the next separator
+    while(c < end && !isSpace(*c) && *c != '\n' && *c != '\r')
+        c++;
+    return true;
+}
+
+void parseChunk(Chunk &chunk)
+{
+    const char *c = chunk.begin;
+    const char *end = chunk.end;
+    Segment first;
+    first.firstFace = 0;
+    first.setsObject = first.setsMaterial = false;
+    chunk.segments.push_back(first);
+
+    while(c < end && !chunk.failed)
+    {
+        c = skipSpaces(c, end);
+        if(c >= end)
+            break;
+
+        if(c[0] == 'v' && c + 1 < end && isSpace(c[1]))
+        {
+            const char *p = c + 1;
+            glm::vec3 position;
+            if(!parseFloat(p, end, position.x) || !parseFloat(p, end, position.y) || !parseFloat(p, end, position.z))
+                chunk.failed = true;
+            chunk.positions.push_back(position);
+        }
+        else if(c[0] == 'v' && c + 2 < end && c[1] == 't' && isSpace(c[2]))
+        {
+            const char *p = c + 2;
+            glm::vec2 texCoord(0.0f);
+            if(!parseFloat(p, end, texCoord.x))
+                chunk.failed = true;
+            parseFloat(p, end, texCoord.y);
+            chunk.texCoords.push_back(texCoord);
+        }
+        else if(c[0] == 'v' && c + 2 < end && c[1] == 'n' && isSpace(c[2]))
+        {
+            const char *p = c + 2;
+            glm::vec3 normal;
+            if(!parseFloat(p, end, normal.x) || !parseFloat(p, end, normal.y) || !parseFloat(p, end, normal.z))
+                chunk.failed = true;
+            chunk.normals.push_back(normal);
+        }
+        else if(c[0] == 'f' && c + 1 < end && isSpace(c[1]))
+        {
+            const char *p = c + 1;
+            size_t start = chunk.corners.size();
+            Corner corner;
+            while(parseCorner(p, end, chunk, corner))
+                chunk.corners.push_back(corner);
+            if(chunk.corners.size() - start < 3)
+                chunk.corners.resize(start);
+            else
+                chunk.faceStarts.push_back(start);
+        }
+        else if((c[0] == 'o' || c[0] == 'g') && c + 1 < end && isSpace(c[1]))
+        {
+            Segment segment;
+            segment.firstFace = chunk.faceStarts.size();
+            segment.setsObject = true;
+            segment.setsMaterial = false;
+            segment.object = parseName(c + 1, end);
+            chunk.segments.push_back(segment);
+        }
+        else if(end - c > 7 && std::strncmp(c, "usemtl", 6) == 0 && isSpace(c[6]))
+        {
+            Segment segment;
+            segment.firstFace = chunk.faceStarts.size();
+            segment.setsObject = false;
+            segment.setsMaterial = true;
+            segment.material = parseName(c + 6, end);
+            chunk.segments.push_back(segment);
+        }
+        else if(end - c > 7 && std::strncmp(c, "mtllib", 6) == 0 && isSpace(c[6]))
+        {
+            chunk.materialLibraries.push_back(parseName(c + 6, end));
+        }
+        c = nextLine(c, end);
+    }
+    chunk.faceStarts.push_back(chunk.corners.size());
+}
+
+//MATERIALS-----------------------------------------------------------------------------------------------
+struct ObjMaterial {
+    std::string diffuseMap;
+    std::string specularMap;
+};
+
+// the texture file is the last token, earlier ones are map options
+std::string lastToken(const std::string &line)
+{
+    size_t end = line.find_last_not_of(" \t\r");
+    if(end == std::string::npos)
+        return "";
+    size_t start = line.find_last_of(" \t", end);
+    return line.substr(start == std::string::npos ? 0 : start + 1, end - (start == std::string::npos ? 0 : start + 1) + 1);
+}
+
+void parseMaterialLibrary(const std::string &path, std::unordered_map<std::string, ObjMaterial> &materials)
+{
+    const unsigned char *data;
+    size_t size;
+    if(!mapFileRegion(path, data, size))
+    {
+        std::cout << "ERROR::OBJ::Failed to read material library " << path << std::endl;
+        return;
+    }
+
+    const char *c = (const char*)data;
+    const char *end = c + size;
+    ObjMaterial *current = NULL;
+    while(c < end)
+    {
+        c = skipSpaces(c, end);
+        const char *lineEnd = c;
+        while(lineEnd < end && *lineEnd != '\n')
+            lineEnd++;
+        std::string line(c, lineEnd);
+        if(line.compare(0, 6, "newmtl") == 0)
+            current = &materials[parseName(c + 6, lineEnd)];
+        else if(current && line.compare(0, 6, "map_Kd") == 0)
+            current -> diffuseMap = lastToken(line.substr(6));
+        else if(current && line.compare(0, 6, "map_Ks") == 0)
+            current -> specularMap = lastToken(line.substr(6));
+        c = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+//MESH ASSEMBLY-------------------------------------------------------------------------------------------
+void buildMesh(const std::vector<FaceRange> &ranges, const std::vector<glm::vec3> &positions,
+               const std::vector<glm::vec3> &normals, const std::vector<glm::vec2> &texCoords, ObjMesh &mesh, bool &failed)
+{
+    std::unordered_map<CornerKey, GLuint, CornerKeyHash> lookup;
+    // per vertex: no vn in the file, the normal is accumulated from the faces
+    std::vector<bool> generatedNormal;
+    bool needsNormals = false;
+
+    for(GLuint r = 0; r < ranges.size(); r++)
+    {
+        const Chunk &chunk = *ranges[r].chunk;
+        for(size_t face = ranges[r].first; face < ranges[r].last; face++)
+        {
+            size_t first = chunk.faceStarts[face];
+            size_t count = chunk.faceStarts[face + 1] - first;
+            GLuint firstIndex = 0, previousIndex = 0;
+            // triangulate as a fan, like aiProcess_Triangulate does for convex polygons
+            for(size_t i = 0; i < count; i++)
+            {
+                const Corner &corner = chunk.corners[first + i];
+                CornerKey key;
+                key.v = corner.v + ((corner.relative & RELATIVE_V) ? (int)chunk.positionBase : 0);
+                key.vt = corner.vt + ((corner.relative & RELATIVE_VT) ? (int)chunk.texCoordBase : 0);
+                key.vn = corner.vn + ((corner.relative & RELATIVE_VN) ? (int)chunk.normalBase : 0);
+                if(key.v < 0 || key.v >= (int)positions.size() || key.vt >= (int)texCoords.size() || key.vn >= (int)normals.size())
+                {
+                    failed = true;
+                    return;
+                }
+
+                auto it = lookup.find(key);
+                GLuint index;
+                if(it != lookup.end())
+                {
+                    index = it -> second;
+                }
+                else
+                {
+                    Vertex vertex;
+                    vertex.Position = positions[key.v];
+                    vertex.Normal = key.vn >= 0 ? normals[key.vn] : glm::vec3(0.0f);
+                    vertex.TexCoords = key.vt >= 0 ? glm::vec2(texCoords[key.vt].x, 1.0f - texCoords[key.vt].y) : glm::vec2(0.0f);
+                    needsNormals |= key.vn < 0;
+                    index = (GLuint)mesh.vertices.size();
+                    mesh.vertices.push_back(vertex);
+                    generatedNormal.push_back(key.vn < 0);
+                    lookup.emplace(key, index);
+                }
+
+                if(i == 0)
+                {
+                    firstIndex = index;
+                }
+                else if(i >= 2)
+                {
+                    mesh.indices.push_back(firstIndex);
+                    mesh.indices.push_back(previousIndex);
+                    mesh.indices.push_back(index);
+                }
+                previousIndex = index;
+            }
+        }
+    }
+
+    // corners without normals get smooth ones accumulated from the faces;
+    // normals the file gives are left as they are
+    if(needsNormals)
+    {
+        for(size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            GLuint corners[3] = {mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+            const glm::vec3 &a = mesh.vertices[corners[0]].Position;
+            const glm::vec3 &b = mesh.vertices[corners[1]].Position;
+            const glm::vec3 &c = mesh.vertices[corners[2]].Position;
+            glm::vec3 normal = glm::cross(b - a, c - a);
+            for(int j = 0; j < 3; j++)
+            {
+                if(generatedNormal[corners[j]])
+                    mesh.vertices[corners[j]].Normal += normal;
+            }
+        }
+        for(GLuint i = 0; i < mesh.vertices.size(); i++)
+        {
+            float length = glm::length(mesh.vertices[i].Normal);
+            if(generatedNormal[i] && length > 0.0f)
+                mesh.vertices[i].Normal /= length;
+        }
+    }
+}
+
+ThreadPool& parsePool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+}
+
+bool loadObj(const std::string &path, std::vector<ObjMesh> &meshes)
+{
+    // parsed in place from the mapping, the file is never copied
+    const unsigned char *data;
+    size_t size;
+    if(!mapFileRegion(path, data, size))
+    {
+        std::cout << "ERROR::OBJ::Failed to read " << path << std::endl;
+        return false;
+    }
+    return parseObj((const char*)data, size, path.substr(0, path.find_last_of('/')), meshes);
+}
+
+bool parseObj(const char *data, size_t size, const std::string &directory, std::vector<ObjMesh> &meshes)
+{
+    ThreadPool &pool = parsePool();
+
+    // the number parsers stop at the newline that ends every line; a final
+    // line without one is copied so nothing reads past the buffer
+    size_t bodySize = size;
+    while(bodySize > 0 && data[bodySize - 1] != '\n')
+        bodySize--;
+    std::string tail(data + bodySize, data + size);
+    tail += '\n';
+
+    const size_t minChunkSize = 256 * 1024;
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(pool.size() * 4, bodySize / minChunkSize));
+    std::vector<Chunk> chunks(chunkCount + 1);
+    const char *begin = data;
+    for(size_t i = 0; i < chunkCount; i++)
+    {
+        const char *end = data + bodySize * (i + 1) / chunkCount;
+        while(end > begin && end[-1] != '\n')
+            end++;
+        chunks[i].begin = begin;
+        chunks[i].end = std::max(begin, end);
+        begin = chunks[i].end;
+    }
+    chunks[chunkCount].begin = tail.data();
+    chunks[chunkCount].end = tail.data() + tail.size();
+
+    std::vector<std::future<void>> jobs;
+    for(GLuint i = 0; i < chunks.size(); i++)
+    {
+        Chunk *chunk = &chunks[i];
+        jobs.push_back(pool.submit([chunk]() {
+            try
+            {
+                parseChunk(*chunk);
+            }
+            catch(const std::exception &e)
+            {
+                chunk -> failed = true;
+            }
+        }));
+    }
+    for(GLuint i = 0; i < jobs.size(); i++)
+        jobs[i].wait();
+
+    // stitch the chunks together in file order
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<std::string> materialLibraries;
+    for(GLuint i = 0; i < chunks.size(); i++)
+    {
+        Chunk &chunk = chunks[i];
+        if(chunk.failed)
+        {
+            std::cout << "ERROR::OBJ::Malformed data in chunk " << i << std::endl;
+            return false;
+        }
+        chunk.positionBase = positions.size();
+        chunk.normalBase = normals.size();
+        chunk.texCoordBase = texCoords.size();
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+        materialLibraries.insert(materialLibraries.end(), chunk.materialLibraries.begin(), chunk.materialLibraries.end());
+    }
+
+    // group face ranges by object and material
+    std::vector<std::string> groupNames;
+    std::vector<std::string> groupMaterials;
+    std::vector<std::vector<FaceRange>> groupRanges;
+    std::unordered_map<std::string, size_t> groups;
+    std::string object, material;
+    for(GLuint i = 0; i < chunks.size(); i++)
+    {
+        const Chunk &chunk = chunks[i];
+        for(GLuint s = 0; s < chunk.segments.size(); s++)
+        {
+            const Segment &segment = chunk.segments[s];
+            if(segment.setsObject)
+                object = segment.object;
+            if(segment.setsMaterial)
+                material = segment.material;
+
+            FaceRange range;
+            range.chunk = &chunk;
+            range.first = segment.firstFace;
+            range.last = s + 1 < chunk.segments.size() ? chunk.segments[s + 1].firstFace : chunk.faceStarts.size() - 1;
+            if(range.first == range.last)
+                continue;
+
+            std::string key = object + '\n' + material;
+            auto it = groups.find(key);
+            if(it == groups.end())
+            {
+                it = groups.emplace(key, groupRanges.size()).first;
+                groupNames.push_back(object);
+                groupMaterials.push_back(material);
+                groupRanges.push_back(std::vector<FaceRange>());
+            }
+            groupRanges[it -> second].push_back(range);
+        }
+    }
+
+    std::unordered_map<std::string, ObjMaterial> materials;
+    for(GLuint i = 0; i < materialLibraries.size(); i++)
+        parseMaterialLibrary(directory + "/" + materialLibraries[i], materials);
+
+    std::vector<ObjMesh> built(groupRanges.size());
+    std::vector<char> failures(groupRanges.size(), 0);
+    jobs.clear();
+    for(GLuint i = 0; i < groupRanges.size(); i++)
+    {
+        jobs.push_back(pool.submit([&, i]() {
+            bool failed = false;
+            buildMesh(groupRanges[i], positions, normals, texCoords, built[i], failed);
+            failures[i] = failed;
+        }));
+    }
+    for(GLuint i = 0; i < jobs.size(); i++)
+        jobs[i].wait();
+
+    for(GLuint i = 0; i < built.size(); i++)
+    {
+        if(failures[i])
+        {
+            std::cout << "ERROR::OBJ::Face index out of range in " << groupNames[i] << std::endl;
+            return false;
+        }
+        auto material = materials.find(groupMaterials[i]);
+        if(material != materials.end())
+        {
+            built[i].diffuseMap = material -> second.diffuseMap;
+            built[i].specularMap = material -> second.specularMap;
+        }
+        meshes.push_back(std::move(built[i]));
+    }
+    return true;
+}
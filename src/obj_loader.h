@@ -0,0 +1,25 @@
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+#include "mesh.h"
+
+#include <string>
+#include <vector>
+
+// Native Wavefront OBJ/MTL loader used by Model for .obj files instead of
+// going through the Assimp importer. The file is split into line-aligned
+// chunks that are parsed in parallel, identical position/uv/normal tuples are
+// merged through a hash map and the result comes out as ready-to-upload
+// Vertex/index arrays, one mesh per object and material. UVs are flipped the
+// same way aiProcess_FlipUVs does.
+struct ObjMesh {
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    std::string diffuseMap;
+    std::string specularMap;
+};
+
+bool loadObj(const std::string &path, std::vector<ObjMesh> &meshes);
+bool parseObj(const char *data, size_t size, const std::string &directory, std::vector<ObjMesh> &meshes);
+
+#endif
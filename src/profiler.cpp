@@ -0,0 +1,184 @@
+#include "profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+struct ProfileEvent {
+    const char *name;
+    std::string detail;
+    uint64_t start;
+    uint64_t duration;
+    unsigned thread;
+    size_t bytesRead;
+    size_t bytesDecoded;
+    size_t bytesUploaded;
+};
+
+static std::mutex profileMutex;
+static std::vector<ProfileEvent> profileEvents;
+static std::unordered_map<std::thread::id, unsigned> profileThreads;
+static const std::chrono::steady_clock::time_point profileEpoch = std::chrono::steady_clock::now();
+
+static const char* tracePath()
+{
+    const char *path = std::getenv("ASTEROID_TRACE");
+    return path && *path ? path : "startup_trace.json";
+}
+
+static std::string jsonEscape(const std::string &text)
+{
+    std::string escaped;
+    for(size_t i = 0; i < text.size(); i++)
+    {
+        char c = text[i];
+        if(c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if((unsigned char)c < 0x20)
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+bool Profiler::enabled()
+{
+    static const bool on = std::strcmp(tracePath(), "off") != 0;
+    return on;
+}
+
+// microseconds since startup
+uint64_t Profiler::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - profileEpoch).count();
+}
+
+void Profiler::record(const char *name, const std::string &detail, uint64_t start, uint64_t end,
+                      size_t bytesRead, size_t bytesDecoded, size_t bytesUploaded)
+{
+    if(!enabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(profileMutex);
+    auto thread = profileThreads.find(std::this_thread::get_id());
+    if(thread == profileThreads.end())
+        thread = profileThreads.emplace(std::this_thread::get_id(), (unsigned)profileThreads.size()).first;
+
+    ProfileEvent event;
+    event.name = name;
+    event.detail = detail;
+    event.start = start;
+    event.duration = end - start;
+    event.thread = thread -> second;
+    event.bytesRead = bytesRead;
+    event.bytesDecoded = bytesDecoded;
+    event.bytesUploaded = bytesUploaded;
+    profileEvents.push_back(event);
+}
+
+void Profiler::finish()
+{
+    if(!enabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(profileMutex);
+    std::ofstream trace(tracePath());
+    if(!trace)
+    {
+        std::cout << "ERROR::PROFILER::Cannot write " << tracePath() << std::endl;
+    }
+    else
+    {
+        trace << "{\"traceEvents\":[\n";
+        for(size_t i = 0; i < profileEvents.size(); i++)
+        {
+            const ProfileEvent &event = profileEvents[i];
+            trace << "{\"name\":\"" << jsonEscape(event.name) << "\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1"
+                  << ",\"tid\":" << event.thread << ",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                  << ",\"args\":{\"detail\":\"" << jsonEscape(event.detail) << "\""
+                  << ",\"bytesRead\":" << event.bytesRead << ",\"bytesDecoded\":" << event.bytesDecoded
+                  << ",\"bytesUploaded\":" << event.bytesUploaded << "}}"
+                  << (i + 1 < profileEvents.size() ? ",\n" : "\n");
+        }
+        trace << "]}\n";
+    }
+
+    struct Total {
+        size_t count = 0;
+        uint64_t total = 0;
+        uint64_t longest = 0;
+        std::string longestDetail;
+        size_t bytesRead = 0;
+        size_t bytesDecoded = 0;
+        size_t bytesUploaded = 0;
+    };
+    std::map<std::string, Total> totals;
+    for(size_t i = 0; i < profileEvents.size(); i++)
+    {
+        const ProfileEvent &event = profileEvents[i];
+        Total &total = totals[event.name];
+        total.count++;
+        total.total += event.duration;
+        if(event.duration >= total.longest)
+        {
+            total.longest = event.duration;
+            total.longestDetail = event.detail;
+        }
+        total.bytesRead += event.bytesRead;
+        total.bytesDecoded += event.bytesDecoded;
+        total.bytesUploaded += event.bytesUploaded;
+    }
+    std::vector<std::pair<std::string, Total>> sorted(totals.begin(), totals.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, Total> &a, const std::pair<std::string, Total> &b) {
+        return a.second.total > b.second.total;
+    });
+
+    std::cout << "PROFILER:: " << profileEvents.size() << " scopes on " << profileThreads.size() << " threads, trace in " << tracePath() << std::endl;
+    for(size_t i = 0; i < sorted.size(); i++)
+    {
+        const Total &total = sorted[i].second;
+        char line[256];
+        snprintf(line, sizeof(line), "PROFILER:: %10.2f ms %5zu x  %-28s max %8.2f ms  read %7zu KiB  decoded %7zu KiB  uploaded %7zu KiB",
+                 total.total / 1000.0, total.count, sorted[i].first.c_str(), total.longest / 1000.0,
+                 total.bytesRead / 1024, total.bytesDecoded / 1024, total.bytesUploaded / 1024);
+        std::cout << line;
+        if(!total.longestDetail.empty())
+            std::cout << "  (" << total.longestDetail << ")";
+        std::cout << std::endl;
+    }
+}
+
+ProfileScope::ProfileScope(const char *name, const std::string &detail) : name(name), detail(detail), start(Profiler::now())
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    end();
+}
+
+void ProfileScope::end()
+{
+    if(ended)
+        return;
+    ended = true;
+    Profiler::record(name, detail, start, Profiler::now(), readBytes, decodedBytes, uploadedBytes);
+}
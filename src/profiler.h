@@ -0,0 +1,54 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Startup timeline. Scopes record wall time per thread together with the
+// bytes they read from disk, decoded and uploaded to GL. At exit the
+// timeline is written as Chrome trace JSON (open it in chrome://tracing or
+// Perfetto) and a summary sorted by total time is printed, one line per
+// scope name. The trace goes to startup_trace.json unless ASTEROID_TRACE
+// names another file; ASTEROID_TRACE=off disables recording.
+//
+//   ProfileScope scope("Model::import", path);
+//   scope.bytesRead(size);
+//
+// end() closes a scope early, for phases that declare variables used later.
+class Profiler
+{
+    public:
+        static bool enabled();
+        static uint64_t now();
+        static void record(const char *name, const std::string &detail, uint64_t start, uint64_t end,
+                           size_t bytesRead, size_t bytesDecoded, size_t bytesUploaded);
+        static void finish();
+};
+
+class ProfileScope
+{
+    public:
+        ProfileScope(const char *name, const std::string &detail = std::string());
+        ~ProfileScope();
+        void end();
+
+        void bytesRead(size_t bytes) { readBytes += bytes; }
+        void bytesDecoded(size_t bytes) { decodedBytes += bytes; }
+        void bytesUploaded(size_t bytes) { uploadedBytes += bytes; }
+
+    private:
+        const char *name;
+        std::string detail;
+        uint64_t start;
+        size_t readBytes = 0;
+        size_t decodedBytes = 0;
+        size_t uploadedBytes = 0;
+        bool ended = false;
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "program_cache.h"
+#include "gl_extensions.h"
+#include "asset_archive.h"
+#include "gl_capture.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+const char PROGRAM_BINARY_MAGIC[8] = { 'P', 'R', 'G', 'B', 'I', 'N', '1', '\0' };
+
+struct ProgramBinaryHeader {
+    char magic[8];
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+static std::atomic<size_t> cacheHits(0);
+static std::atomic<size_t> cacheMisses(0);
+static std::atomic<size_t> cacheRejected(0);
+
+static const char* cacheDirectory()
+{
+    const char *directory = std::getenv("ASTEROID_SHADER_CACHE");
+    return directory && *directory ? directory : "shader_cache";
+}
+
+static std::filesystem::path cachePath(uint64_t key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return std::filesystem::path(cacheDirectory()) / name;
+}
+
+static std::string glString(GLenum name)
+{
+    const GLubyte *value = glGetString(name);
+    return value ? std::string((const char*)value) : std::string();
+}
+
+bool ProgramCache::enabled()
+{
+    // binaries are loaded outside glad, so a GL capture could not replay them
+    static const bool on = std::strcmp(cacheDirectory(), "off") != 0 && !GLCapture::requested();
+    return on && programBinaryFunctions() != NULL;
+}
+
+uint64_t ProgramCache::key(const std::string &sources)
+{
+    // binaries are only valid for the driver that produced them
+    static const std::string driver = glString(GL_VENDOR) + '\0' + glString(GL_RENDERER) + '\0' + glString(GL_VERSION);
+    return archiveHash(sources + '\0' + driver);
+}
+
+bool ProgramCache::load(uint64_t key, GLuint program)
+{
+    if(!enabled())
+        return false;
+
+    std::filesystem::path path = cachePath(key);
+    std::ifstream file(path, std::ios::binary);
+    ProgramBinaryHeader header;
+    if(!file || !file.read((char*)&header, sizeof(header)) ||
+       std::memcmp(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic)) != 0 || header.key != key)
+    {
+        cacheMisses++;
+        return false;
+    }
+    std::vector<char> binary(header.length);
+    if(!file.read(binary.data(), binary.size()))
+    {
+        cacheMisses++;
+        return false;
+    }
+    file.close();
+
+    programBinaryFunctions()->programBinary(program, (GLenum)header.format, binary.data(), (GLsizei)binary.size());
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if(!success)
+    {
+        std::cout << "SHADER_CACHE:: driver rejected " << path.generic_string() << ", compiling from source" << std::endl;
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        cacheRejected++;
+        cacheMisses++;
+        return false;
+    }
+    cacheHits++;
+    return true;
+}
+
+void ProgramCache::prepare(GLuint program)
+{
+    if(enabled())
+        programBinaryFunctions()->programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::store(uint64_t key, GLuint program)
+{
+    if(!enabled())
+        return;
+
+    GLint success = 0;
+    GLint length = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(!success || length <= 0)
+        return;
+
+    ProgramBinaryHeader header;
+    std::memcpy(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic));
+    header.key = key;
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    programBinaryFunctions()->getProgramBinary(program, length, &written, &format, binary.data());
+    header.format = format;
+    header.length = (uint32_t)written;
+
+    // written next to the final name and renamed, so a crash never leaves half a binary behind
+    std::error_code error;
+    std::filesystem::path path = cachePath(key);
+    std::filesystem::create_directories(path.parent_path(), error);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if(!file || !file.write((const char*)&header, sizeof(header)) || !file.write(binary.data(), written))
+        {
+            std::cout << "ERROR::SHADER_CACHE::Cannot write " << temporary.generic_string() << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if(error)
+        std::cout << "ERROR::SHADER_CACHE::Cannot write " << path.generic_string() << ": " << error.message() << std::endl;
+}
+
+void ProgramCache::printStats()
+{
+    if(!enabled())
+    {
+        std::cout << "SHADER_CACHE:: disabled" << std::endl;
+        return;
+    }
+    std::cout << "SHADER_CACHE:: " << cacheHits << " hits, " << cacheMisses << " misses, "
+              << cacheRejected << " rejected binaries in " << cacheDirectory() << std::endl;
+}
@@ -0,0 +1,38 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <cstdint>
+
+// On-disk cache of linked program binaries (glGetProgramBinary). A program is
+// keyed by a hash of its stage sources and defines together with the GL
+// vendor, renderer and version strings, so a driver update or a different GPU
+// simply misses. Binaries live in shader_cache/<key>.bin unless
+// ASTEROID_SHADER_CACHE names another directory; ASTEROID_SHADER_CACHE=off
+// disables the cache, and so does a GL capture (see GLCapture). When the
+// driver rejects a cached binary the entry is dropped and the program is
+// compiled from source as usual.
+//
+//   uint64_t key = ProgramCache::key(sources);
+//   if(!ProgramCache::load(key, program))
+//   {
+//       ProgramCache::prepare(program);
+//       ... attach, link ...
+//       ProgramCache::store(key, program);
+//   }
+class ProgramCache
+{
+    public:
+        static bool enabled();
+        static uint64_t key(const std::string &sources);
+        // true when a cached binary was accepted and the program is linked
+        static bool load(uint64_t key, GLuint program);
+        // asks the driver to keep the binary retrievable; call before linking
+        static void prepare(GLuint program);
+        static void store(uint64_t key, GLuint program);
+        static void printStats();
+};
+
+#endif
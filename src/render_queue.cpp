@@ -0,0 +1,123 @@
+#include "render_queue.h"
+
+#include <algorithm>
+
+static const int DEPTH_BITS = 24;
+static const int PROGRAM_BITS = 10;
+static const int MATERIAL_BITS = 12;
+static const int VAO_BITS = 12;
+
+static uint64_t field(uint64_t value, int bits)
+{
+    return value & ((1ull << bits) - 1);
+}
+
+void RenderQueue::begin(const glm::vec3 &cameraPosition, float farPlane)
+{
+    this -> cameraPosition = cameraPosition;
+    this -> farPlane = farPlane;
+    items.clear();
+    keys.clear();
+}
+
+void RenderQueue::submit(Model &model, Shader &shader, const glm::mat4 &transform, GLuint instances,
+                         bool blended, RenderPass pass)
+{
+    for(size_t i = 0; i < model.meshes.size(); i++)
+    {
+        RenderItem item;
+        item.mesh = &model.meshes[i];
+        item.shader = &shader;
+        item.transform = transform;
+        item.instances = instances;
+        item.blended = blended;
+        keys.push_back(makeKey(item, model.meshes[i], pass));
+        items.push_back(item);
+    }
+}
+
+uint64_t RenderQueue::makeKey(const RenderItem &item, const Mesh &mesh, RenderPass pass) const
+{
+    float distance = glm::length(glm::vec3(item.transform[3]) - cameraPosition) / farPlane;
+    distance = std::min(std::max(distance, 0.0f), 1.0f);
+    uint64_t depth = (uint64_t)(distance * (float)((1u << DEPTH_BITS) - 1));
+
+    uint64_t state = field(item.shader -> ID, PROGRAM_BITS) << (MATERIAL_BITS + VAO_BITS)
+                   | field(mesh.material.id(), MATERIAL_BITS) << VAO_BITS
+                   | field(mesh.VAO, VAO_BITS);
+    const int stateBits = PROGRAM_BITS + MATERIAL_BITS + VAO_BITS;
+
+    uint64_t key = field(pass, 4) << 60;
+    if(!item.blended)
+        return key | state << (DEPTH_BITS + 1) | depth;
+
+    uint64_t farToNear = ((1u << DEPTH_BITS) - 1) - depth;
+    return key | 1ull << 59 | farToNear << (stateBits + 1) | state << 1;
+}
+
+// LSD radix sort over the key bytes; bytes every key shares are skipped,
+// which with few programs and materials leaves two or three passes
+void RenderQueue::sort()
+{
+    size_t count = keys.size();
+    order.resize(count);
+    sortKeys.assign(keys.begin(), keys.end());
+    scratchKeys.resize(count);
+    scratchOrder.resize(count);
+    for(size_t i = 0; i < count; i++)
+        order[i] = (uint32_t)i;
+
+    for(int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = {};
+        for(size_t i = 0; i < count; i++)
+            histogram[(sortKeys[i] >> shift) & 0xFF]++;
+        if(count == 0 || histogram[(sortKeys[0] >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for(int bucket = 0; bucket < 256; bucket++)
+        {
+            size_t size = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += size;
+        }
+        for(size_t i = 0; i < count; i++)
+        {
+            size_t slot = histogram[(sortKeys[i] >> shift) & 0xFF]++;
+            scratchKeys[slot] = sortKeys[i];
+            scratchOrder[slot] = order[i];
+        }
+        sortKeys.swap(scratchKeys);
+        order.swap(scratchOrder);
+    }
+}
+
+void RenderQueue::record(CommandBuffer &commands)
+{
+    sort();
+
+    // only state changes between neighbouring draws are recorded
+    Shader *shader = NULL;
+    int blended = -1;
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        RenderItem &item = items[order[i]];
+        if(blended != (int)item.blended)
+        {
+            if(item.blended)
+                commands.enable(GL_BLEND);
+            else
+                commands.disable(GL_BLEND);
+            blended = item.blended;
+        }
+        if(shader != item.shader)
+        {
+            commands.useShader(*item.shader);
+            shader = item.shader;
+        }
+        if(!item.instances)
+            commands.setModelMatrix(*item.shader, item.transform);
+        commands.drawMesh(*item.mesh, item.instances);
+    }
+}
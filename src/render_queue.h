@@ -0,0 +1,70 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+#include "shader.h"
+#include "model.h"
+#include "command_buffer.h"
+
+enum RenderPass {
+    RENDER_PASS_SCENE,
+    RENDER_PASS_OVERLAY
+};
+
+// Per-frame list of mesh draws, executed in the order of a packed 64-bit key
+// instead of submission order. From the most significant bit down:
+//
+//   opaque       pass:4  blended:1 = 0  program:10  material:12  vao:12  -:1  depth:24
+//   transparent  pass:4  blended:1 = 1  far-to-near depth:24  program:10  material:12  vao:12  -:1
+//
+// so each pass draws its opaque meshes grouped by state and front to back
+// within a group (early-z), then its blended meshes back to front. Depth is
+// the distance from the camera to the transform's origin, quantized over
+// [0, farPlane). The keys are radix sorted and recorded into a CommandBuffer;
+// neither submitting nor recording touches GL, so a queue can be filled on a
+// worker thread while the render thread does other GL work.
+//
+//   queue.begin(camera.Position, 1000.0f);
+//   queue.submit(planet, shader, transform);
+//   queue.submit(rock, instanceShader, glm::mat4(1.0f), amount);
+//   queue.record(commands);
+//   executor.execute(commands);
+class RenderQueue
+{
+    public:
+        void begin(const glm::vec3 &cameraPosition, float farPlane);
+        // instances == 0 draws the meshes once with the shader's "model" uniform set to transform
+        void submit(Model &model, Shader &shader, const glm::mat4 &transform, GLuint instances = 0,
+                    bool blended = false, RenderPass pass = RENDER_PASS_SCENE);
+        void record(CommandBuffer &commands);
+        size_t size() const { return items.size(); }
+
+    private:
+        struct RenderItem {
+            Mesh *mesh;
+            Shader *shader;
+            glm::mat4 transform;
+            GLuint instances;
+            bool blended;
+        };
+
+        glm::vec3 cameraPosition;
+        float farPlane = 1.0f;
+        std::vector<RenderItem> items;
+        std::vector<uint64_t> keys;
+        // kept between frames so sorting does not allocate once warmed up
+        std::vector<uint32_t> order;
+        std::vector<uint64_t> sortKeys;
+        std::vector<uint64_t> scratchKeys;
+        std::vector<uint32_t> scratchOrder;
+
+        uint64_t makeKey(const RenderItem &item, const Mesh &mesh, RenderPass pass) const;
+        void sort();
+};
+
+#endif
@@ -1,72 +1,212 @@
 #include "shader.h"
+#include "frame_uniforms.h"
+#include "program_cache.h"
+#include "gl_extensions.h"
+#include "gl_state.h"
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+#include <algorithm>
+
+static const char* const SHADER_FEATURE_NAMES[SHADER_FEATURE_COUNT] = {
+    "POST_INVERT",
+    "POST_GRAYSCALE",
+    "POST_BLUR",
+    "POST_SHARPEN",
+    "POST_EDGE",
+    "INSTANCED",
+    "QUANTIZED_VERTEX"
+};
+
+const char* shaderFeatureName(uint32_t feature)
 {
-    std::string svShaderCode = loadShader(vertexPath);
-    std::string sfShaderCode = loadShader(fragmentPath);
-    const GLchar* vShaderCode = svShaderCode.c_str();
-    const GLchar* fShaderCode = sfShaderCode.c_str();
+    for(int i = 0; i < SHADER_FEATURE_COUNT; i++)
+    {
+        if(feature == (1u << i))
+            return SHADER_FEATURE_NAMES[i];
+    }
+    return NULL;
+}
 
-    GLuint vertex, fragment;
-    int success;
-    char infoLog[512];
+uint32_t parseShaderFeatures(const std::string &names)
+{
+    uint32_t features = 0;
+    std::stringstream list(names);
+    std::string name;
+    while(std::getline(list, name, ','))
+    {
+        if(name.empty())
+            continue;
+        bool found = false;
+        for(int i = 0; i < SHADER_FEATURE_COUNT && !found; i++)
+        {
+            if(name == SHADER_FEATURE_NAMES[i])
+            {
+                features |= 1u << i;
+                found = true;
+            }
+        }
+        if(!found)
+            std::cout << "ERROR::SHADER::UNKNOWN_FEATURE " << name << std::endl;
+    }
+    return features;
+}
 
-    vertex = createShader(GL_VERTEX_SHADER, vShaderCode);
-    fragment = createShader(GL_FRAGMENT_SHADER, fShaderCode);
+Shader::Shader(const char* vertexPath, const char* fragmentPath) : Shader(vertexPath, fragmentPath, NULL, 0)
+{
+}
 
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if(!success)
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) : Shader(vertexPath, fragmentPath, geometryPath, 0)
+{
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath, uint32_t features)
+{
+    std::vector<ShaderStage> stages;
+    std::string label = vertexPath;
+    stages.push_back(ShaderStage{GL_VERTEX_SHADER, applyFeatures(loadShader(vertexPath), features)});
+    if(geometryPath)
     {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"<<infoLog<< std::endl;
+        stages.push_back(ShaderStage{GL_GEOMETRY_SHADER, applyFeatures(loadShader(geometryPath), features)});
+        label = label + " + " + geometryPath;
+    }
+    stages.push_back(ShaderStage{GL_FRAGMENT_SHADER, applyFeatures(loadShader(fragmentPath), features)});
+    label = label + " + " + fragmentPath;
+    for(int i = 0; i < SHADER_FEATURE_COUNT; i++)
+    {
+        if(features & (1u << i))
+            label = label + " #" + SHADER_FEATURE_NAMES[i];
     }
+    buildProgram(stages, label);
+}
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+// the defines must follow #version, which has to stay the first statement
+std::string Shader::applyFeatures(const std::string &source, uint32_t features){
+    if(features == 0)
+        return source;
 
+    std::string defines;
+    for(int i = 0; i < SHADER_FEATURE_COUNT; i++)
+    {
+        if(features & (1u << i))
+            defines = defines + "#define " + SHADER_FEATURE_NAMES[i] + "\n";
+    }
+
+    size_t version = source.find("#version");
+    if(version == std::string::npos)
+        return defines + source;
+    size_t lineEnd = source.find('\n', version);
+    if(lineEnd == std::string::npos)
+        return source + "\n" + defines;
+    // keep compiler messages on the original line numbers
+    size_t nextLine = std::count(source.begin(), source.begin() + lineEnd + 1, '\n') + 1;
+    return source.substr(0, lineEnd + 1) + defines + "#line " + std::to_string(nextLine) + "\n" + source.substr(lineEnd + 1);
 }
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+// Submits the program and returns without asking GL about it: status queries
+// would make the driver finish this program before the caller submits the
+// next one. Cached binaries are restored here; anything else is compiled and
+// linked in the background and checked by resolve() on first use.
+void Shader::buildProgram(const std::vector<ShaderStage> &stages, const std::string &label)
 {
-    std::string svShaderCode = loadShader(vertexPath);
-    std::string sfShaderCode = loadShader(fragmentPath);
-    std::string sgShaderCode = loadShader(geometryPath);
-    const GLchar* vShaderCode = svShaderCode.c_str();
-    const GLchar* fShaderCode = sfShaderCode.c_str();
-    const GLchar* gShaderCode = sgShaderCode.c_str();
-
-    GLuint vertex, fragment, geometry;
-    int success;
-    char infoLog[512];
+    this -> label = label;
+    parallelShaderCompile();
 
-    vertex = createShader(GL_VERTEX_SHADER, vShaderCode);
-    fragment = createShader(GL_FRAGMENT_SHADER, fShaderCode);
-    geometry = createShader(GL_GEOMETRY_SHADER, gShaderCode);
+    std::string sources;
+    for(size_t i = 0; i < stages.size(); i++)
+    {
+        sources += std::to_string(stages[i].type) + '\0';
+        sources += stages[i].source + '\0';
+    }
+    cacheKey = ProgramCache::key(sources);
 
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, geometry);
-    glAttachShader(ID, fragment);
+    ProfileScope cacheScope("Shader::cacheLoad", label);
+    bool cached = ProgramCache::load(cacheKey, ID);
+    cacheScope.end();
+    pending = true;
+    if(cached)
+        return;
+
+    ProfileScope submitScope("Shader::submit", label);
+    for(size_t i = 0; i < stages.size(); i++)
+    {
+        GLuint shader = createShader(stages[i].type, stages[i].source.c_str());
+        glAttachShader(ID, shader);
+        pendingShaders.push_back(ShaderStageObject{stages[i].type, shader});
+    }
+    ProgramCache::prepare(ID);
     glLinkProgram(ID);
+}
+
+bool Shader::ready() const{
+    if(!pending || !parallelShaderCompile())
+        return true;
+    GLint complete = 0;
+    glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+static const char* stageName(GLenum type){
+    switch(type)
+    {
+        case GL_VERTEX_SHADER:   return "VERTEX_SHADER";
+        case GL_FRAGMENT_SHADER: return "FRAGMENT_SHADER";
+        case GL_GEOMETRY_SHADER: return "GEOMETRY_SHADER";
+        default:                 return "UNKNOWN_SHADER";
+    }
+}
+
+// first use: waits for the driver, reports errors, fills the binary cache and
+// reflects the uniforms
+void Shader::resolve() const{
+    if(!pending)
+        return;
+    pending = false;
+
+    ProfileScope scope("Shader::resolve", label);
+    int success;
+    char infoLog[512];
+    for(size_t i = 0; i < pendingShaders.size(); i++)
+    {
+        glGetShaderiv(pendingShaders[i].shader, GL_COMPILE_STATUS, &success);
+        if(!success)
+        {
+            glGetShaderInfoLog(pendingShaders[i].shader, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::" << stageName(pendingShaders[i].type) << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+        }
+    }
+
     glGetProgramiv(ID, GL_LINK_STATUS, &success);
     if(!success)
     {
         glGetProgramInfoLog(ID, 512, NULL, infoLog);
         std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"<<infoLog<< std::endl;
     }
+    else if(!pendingShaders.empty())
+    {
+        ProgramCache::store(cacheKey, ID);
+    }
 
-    glDeleteShader(vertex);
-    glDeleteShader(geometry);
-    glDeleteShader(fragment);
+    for(size_t i = 0; i < pendingShaders.size(); i++)
+    {
+        glDetachShader(ID, pendingShaders[i].shader);
+        glDeleteShader(pendingShaders[i].shader);
+    }
+    pendingShaders.clear();
 
+    reflectUniforms();
 }
 
 std::string Shader::loadShader(const char* shaderPath){
 
+    ProfileScope scope("Shader::read", shaderPath);
+    const unsigned char *data;
+    size_t size;
+    if(AssetArchive::find(shaderPath, data, size))
+    {
+        scope.bytesRead(size);
+        return std::string((const char*)data, size);
+    }
+
     std::ifstream shaderFile;
     shaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
 
@@ -77,7 +217,9 @@ std::string Shader::loadShader(const char* shaderPath){
 
         shaderFile.close();
 
-        return shaderStream.str();
+        std::string source = shaderStream.str();
+        scope.bytesRead(source.size());
+        return source;
     }
     catch(std::ifstream::failure& e){
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCEFULLY_READ" <<  e.what() <<std::endl;
@@ -88,58 +230,160 @@ std::string Shader::loadShader(const char* shaderPath){
 GLuint Shader::createShader(GLenum type, const char* shaderCode)
 {    
     GLuint shader;
-    int success;
-    char infoLog[512];
 
     shader = glCreateShader(type);
     glShaderSource(shader, 1, &shaderCode, NULL);
     glCompileShader(shader);
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if(!success)
-    {
-        glGetShaderInfoLog(shader, 512, NULL, infoLog);
-        std::string shaderName = "";
-        if(type = GL_VERTEX_SHADER){
-            shaderName ="VERTEX_SHADER";
-        }
-        else if (type = GL_FRAGMENT_SHADER){
-            shaderName ="FRAGMENT_SHADER";
-        }
-        else if (type = GL_GEOMETRY_SHADER){
-            shaderName ="GEOMETRY_SHADER";
-        }
-        std::cout << "ERROR::SHADER::"<<shaderName<<"::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
 
     return shader;
 }
 
 void Shader::use(){
-    glUseProgram(ID);
+    resolve();
+    GLState::instance().useProgram(ID);
 }
 
 void Shader::setBool(const std::string &name, bool value) const{
-    glUniform1i(glGetUniformLocation((ID), name.c_str()), (int)value);
+    glUniform1i(location(name), (int)value);
 }
 
 void Shader::setInt(const std::string &name, int value) const{
-    glUniform1i(glGetUniformLocation((ID), name.c_str()), value);
+    glUniform1i(location(name), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const{
-    glUniform1f(glGetUniformLocation((ID), name.c_str()), value);
+    glUniform1f(location(name), value);
 }
 
-void Shader::setMatrix4(const std::string &name, glm::mat4 matrix) const{
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+void Shader::setMatrix4(const std::string &name, const glm::mat4 &matrix) const{
+    glUniformMatrix4fv(location(name), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 void Shader::setVec3(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(location(name), x, y, z);
+}
+
+void Shader::setVec3(const std::string &name, const glm::vec3 &vector) const {
+    glUniform3f(location(name), vector.x, vector.y, vector.z);
+}
+
+void Shader::set(UniformHandle<bool> uniform, bool value) const{
+    glUniform1i(uniform.location, (int)value);
+}
+
+void Shader::set(UniformHandle<int> uniform, int value) const{
+    glUniform1i(uniform.location, value);
+}
+
+void Shader::set(UniformHandle<float> uniform, float value) const{
+    glUniform1f(uniform.location, value);
 }
 
-void Shader::setVec3(const std::string &name, glm::vec3 vector) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), vector.x, vector.y, vector.z);
+void Shader::set(UniformHandle<glm::vec3> uniform, const glm::vec3 &vector) const{
+    glUniform3f(uniform.location, vector.x, vector.y, vector.z);
 }
 
+void Shader::set(UniformHandle<glm::mat4> uniform, const glm::mat4 &matrix) const{
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+GLint Shader::location(const std::string &name) const{
+    resolve();
+    auto it = uniforms.find(name);
+    return it == uniforms.end() ? -1 : it->second.location;
+}
+
+static bool isSamplerType(GLenum type){
+    switch(type)
+    {
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_2D:
+            return true;
+        default:
+            return false;
+    }
+}
 
+void Shader::reflectUniforms() const{
+    uniforms.clear();
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> name(maxLength > 0 ? maxLength : 1);
+    // samplers in active uniform index order, so units do not depend on hashing
+    std::vector<std::string> samplers;
+
+    for(GLint i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+        std::string uniformName(name.data(), length);
+        // members of uniform blocks have no location
+        GLint uniformLocation = glGetUniformLocation(ID, uniformName.c_str());
+        if(uniformLocation < 0)
+            continue;
+
+        UniformInfo info;
+        info.location = uniformLocation;
+        info.type = type;
+        info.unit = -1;
+        uniforms[uniformName] = info;
+        // arrays are reported as "name[0]", but "name" addresses them as well
+        size_t bracket = uniformName.find('[');
+        if(bracket != std::string::npos)
+            uniforms[uniformName.substr(0, bracket)] = info;
+        if(isSamplerType(type))
+            samplers.push_back(uniformName.substr(0, bracket));
+    }
+
+    // every sampler gets a fixed texture unit of its own, set once here, so
+    // materials only bind textures and never touch sampler uniforms; the
+    // program stays bound, which GLState knows, so the next use() is free
+    GLState::instance().useProgram(ID);
+    GLint nextUnit = 0;
+    for(size_t i = 0; i < samplers.size(); i++)
+    {
+        UniformInfo &info = uniforms[samplers[i]];
+        info.unit = nextUnit++;
+        glUniform1i(info.location, info.unit);
+    }
+
+    // per-frame constants come from one shared buffer
+    GLuint frameBlock = glGetUniformBlockIndex(ID, FRAME_UNIFORM_BLOCK);
+    if(frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, frameBlock, FRAME_UNIFORM_BINDING);
+}
+
+GLint Shader::samplerUnit(const std::string &name) const{
+    resolve();
+    auto it = uniforms.find(name);
+    return it == uniforms.end() ? -1 : it->second.unit;
+}
+
+GLint Shader::resolveUniform(const std::string &name, UniformKind kind) const{
+    resolve();
+    auto it = uniforms.find(name);
+    if(it == uniforms.end())
+        return -1;
+
+    GLenum type = it->second.type;
+    bool matches = false;
+    switch(kind)
+    {
+        case UNIFORM_INT:   matches = type == GL_INT || type == GL_BOOL || isSamplerType(type); break;
+        case UNIFORM_BOOL:  matches = type == GL_BOOL || type == GL_INT; break;
+        case UNIFORM_FLOAT: matches = type == GL_FLOAT; break;
+        case UNIFORM_VEC3:  matches = type == GL_FLOAT_VEC3; break;
+        case UNIFORM_MAT4:  matches = type == GL_FLOAT_MAT4; break;
+    }
+    if(!matches)
+    {
+        std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH " << name << std::endl;
+        return -1;
+    }
+    return it->second.location;
+}
@@ -4,32 +4,134 @@
 #include <glad/glad.h>
 
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+#include "asset_archive.h"
+#include "profiler.h"
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
+enum UniformKind {
+    UNIFORM_INT,
+    UNIFORM_BOOL,
+    UNIFORM_FLOAT,
+    UNIFORM_VEC3,
+    UNIFORM_MAT4
+};
+
+template<typename T> struct UniformTraits;
+template<> struct UniformTraits<int> { static const UniformKind kind = UNIFORM_INT; };
+template<> struct UniformTraits<bool> { static const UniformKind kind = UNIFORM_BOOL; };
+template<> struct UniformTraits<float> { static const UniformKind kind = UNIFORM_FLOAT; };
+template<> struct UniformTraits<glm::vec3> { static const UniformKind kind = UNIFORM_VEC3; };
+template<> struct UniformTraits<glm::mat4> { static const UniformKind kind = UNIFORM_MAT4; };
+
+// Compile-time feature switches. Each set bit is injected into every stage as
+// "#define <NAME>" right after the #version line, so a permutation only
+// contains the work its features need. See ShaderVariants for on-demand
+// compilation per bitmask.
+enum ShaderFeature {
+    SHADER_POST_INVERT      = 1 << 0,
+    SHADER_POST_GRAYSCALE   = 1 << 1,
+    SHADER_POST_BLUR        = 1 << 2,
+    SHADER_POST_SHARPEN     = 1 << 3,
+    SHADER_POST_EDGE        = 1 << 4,
+    SHADER_INSTANCED        = 1 << 5,
+    SHADER_QUANTIZED_VERTEX = 1 << 6
+};
+const int SHADER_FEATURE_COUNT = 7;
+
+// "POST_BLUR" for SHADER_POST_BLUR, NULL for an unknown bit
+const char* shaderFeatureName(uint32_t feature);
+// comma separated names, e.g. "POST_BLUR,POST_GRAYSCALE"; unknown names are reported and skipped
+uint32_t parseShaderFeatures(const std::string &names);
+
+// Location of a uniform, resolved once through Shader::uniform<T> and then set
+// without any lookup. T is checked against the declared GLSL type when the
+// handle is resolved; a missing or optimised-out uniform gives location -1,
+// which GL ignores.
+template<typename T>
+struct UniformHandle {
+    GLint location = -1;
+    bool valid() const { return location >= 0; }
+};
+
+// Programs are submitted by the constructor and checked on first use
+// (use(), uniform lookups), so several shaders compile concurrently, with
+// KHR_parallel_shader_compile on driver threads. ready() polls without
+// blocking; resolve() forces the check.
 class Shader{
 public:
     unsigned int ID;
 
     Shader(const char* vertexPath, const char* fragmentPath);
     Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath);
+    // geometryPath may be NULL
+    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath, uint32_t features);
 
     void use();
+    bool ready() const;
+    void resolve() const;
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
-    void setMatrix4(const std::string &name, glm::mat4 matrix) const;
+    void setMatrix4(const std::string &name, const glm::mat4 &matrix) const;
     void setVec3(const std::string &name, float x, float y, float z) const;
-    void setVec3(const std::string &name, glm::vec3 vector) const;
+    void setVec3(const std::string &name, const glm::vec3 &vector) const;
+
+    template<typename T>
+    UniformHandle<T> uniform(const std::string &name) const
+    {
+        UniformHandle<T> handle;
+        handle.location = resolveUniform(name, UniformTraits<T>::kind);
+        return handle;
+    }
+    void set(UniformHandle<bool> uniform, bool value) const;
+    void set(UniformHandle<int> uniform, int value) const;
+    void set(UniformHandle<float> uniform, float value) const;
+    void set(UniformHandle<glm::vec3> uniform, const glm::vec3 &vector) const;
+    void set(UniformHandle<glm::mat4> uniform, const glm::mat4 &matrix) const;
+
+    // -1 when the program has no active uniform of that name
+    GLint location(const std::string &name) const;
+    // texture unit assigned to a sampler uniform at link time, -1 if none
+    GLint samplerUnit(const std::string &name) const;
 private:
+    struct UniformInfo {
+        GLint location;
+        GLenum type;
+        GLint unit;
+    };
+    struct ShaderStageObject {
+        GLenum type;
+        GLuint shader;
+    };
+    // filled from glGetActiveUniform once the link is resolved
+    mutable std::unordered_map<std::string, UniformInfo> uniforms;
+    // compile and link state checked by resolve()
+    mutable bool pending = false;
+    mutable std::vector<ShaderStageObject> pendingShaders;
+    uint64_t cacheKey = 0;
+    std::string label;
+
+    struct ShaderStage {
+        GLenum type;
+        std::string source;
+    };
+
     std::string loadShader(const char* shaderPath);
+    static std::string applyFeatures(const std::string &source, uint32_t features);
+    void buildProgram(const std::vector<ShaderStage> &stages, const std::string &label);
     GLuint createShader(GLenum type, const GLchar* shaderCode);
+    void reflectUniforms() const;
+    GLint resolveUniform(const std::string &name, UniformKind kind) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "shader_variants.h"
+#include "gl_state.h"
+
+ShaderVariants::ShaderVariants(const std::string &vertexPath, const std::string &fragmentPath, const std::string &geometryPath)
+    : vertexPath(vertexPath), fragmentPath(fragmentPath), geometryPath(geometryPath)
+{
+}
+
+Shader& ShaderVariants::variant(uint32_t features)
+{
+    auto it = variants.find(features);
+    if(it != variants.end())
+        return *it -> second;
+
+    const char *geometry = geometryPath.empty() ? NULL : geometryPath.c_str();
+    std::unique_ptr<Shader> shader(new Shader(vertexPath.c_str(), fragmentPath.c_str(), geometry, features));
+    Shader &result = *shader;
+    variants.emplace(features, std::move(shader));
+    return result;
+}
+
+void ShaderVariants::deletePrograms()
+{
+    for(auto it = variants.begin(); it != variants.end(); ++it)
+        GLState::instance().deleteProgram(it -> second -> ID);
+    variants.clear();
+}
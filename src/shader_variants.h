@@ -0,0 +1,35 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+#include "shader.h"
+
+// The permutations of one set of shader sources, compiled on demand and kept
+// per feature bitmask (see ShaderFeature). Asking for a variant the first
+// time submits it; like any Shader it is resolved when first used. Returned
+// references stay valid for the lifetime of the ShaderVariants.
+//
+//   ShaderVariants post("shaders/fbvshader.vert", "shaders/fbfshader.frag");
+//   Shader &blur = post.variant(SHADER_POST_BLUR | SHADER_POST_GRAYSCALE);
+class ShaderVariants
+{
+    public:
+        ShaderVariants(const std::string &vertexPath, const std::string &fragmentPath, const std::string &geometryPath = std::string());
+
+        Shader& variant(uint32_t features);
+        size_t count() const { return variants.size(); }
+        // glDeleteProgram on every compiled variant
+        void deletePrograms();
+
+    private:
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string geometryPath;
+        std::unordered_map<uint32_t, std::unique_ptr<Shader>> variants;
+};
+
+#endif
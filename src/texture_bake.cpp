@@ -0,0 +1,611 @@
+#include "texture_bake.h"
+#include "gl_extensions.h"
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <future>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BAKE_USE_SSE2
+#endif
+
+//SRGB CONVERSION-----------------------------------------------------------------------------------------
+static float srgbToLinear[256];
+static unsigned char linearToSrgb[4096];
+
+static bool buildConversionTables()
+{
+    for(int i = 0; i < 256; i++)
+    {
+        float c = i / 255.0f;
+        srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    for(int i = 0; i < 4096; i++)
+    {
+        float l = i / 4095.0f;
+        float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+        linearToSrgb[i] = (unsigned char)std::min(255.0f, std::max(0.0f, c * 255.0f + 0.5f));
+    }
+    return true;
+}
+
+static void initConversionTables()
+{
+    // function-local static, so concurrent bakes build the tables once
+    static bool initialised = buildConversionTables();
+    (void)initialised;
+}
+
+//MIP GENERATION------------------------------------------------------------------------------------------
+static inline void average4(const float *a, const float *b, const float *c, const float *d, float *out)
+{
+#ifdef BAKE_USE_SSE2
+    __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)), _mm_add_ps(_mm_loadu_ps(c), _mm_loadu_ps(d)));
+    _mm_storeu_ps(out, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+    for(int i = 0; i < 4; i++)
+        out[i] = (a[i] + b[i] + c[i] + d[i]) * 0.25f;
+#endif
+}
+
+static void quantizeLevel(const std::vector<float> &linear, MipLevel &level)
+{
+    size_t count = (size_t)level.width * level.height;
+    level.data.resize(count * 4);
+    for(size_t i = 0; i < count; i++)
+    {
+        const float *pixel = &linear[i * 4];
+#ifdef BAKE_USE_SSE2
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(pixel), _mm_set_ps(255.0f, 4095.0f, 4095.0f, 4095.0f));
+        scaled = _mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), _mm_set_ps(255.0f, 4095.0f, 4095.0f, 4095.0f));
+        __m128i index = _mm_cvtps_epi32(scaled);
+        int32_t lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, index);
+        level.data[i * 4 + 0] = linearToSrgb[lanes[0]];
+        level.data[i * 4 + 1] = linearToSrgb[lanes[1]];
+        level.data[i * 4 + 2] = linearToSrgb[lanes[2]];
+        level.data[i * 4 + 3] = (unsigned char)lanes[3];
+#else
+        for(int c = 0; c < 3; c++)
+        {
+            int index = (int)(std::min(1.0f, std::max(0.0f, pixel[c])) * 4095.0f + 0.5f);
+            level.data[i * 4 + c] = linearToSrgb[index];
+        }
+        level.data[i * 4 + 3] = (unsigned char)(std::min(1.0f, std::max(0.0f, pixel[3])) * 255.0f + 0.5f);
+#endif
+    }
+}
+
+std::vector<MipLevel> generateMipChain(const unsigned char *rgba, int width, int height)
+{
+    initConversionTables();
+
+    std::vector<MipLevel> levels;
+    MipLevel base;
+    base.width = width;
+    base.height = height;
+    base.data.assign(rgba, rgba + (size_t)width * height * 4);
+    levels.push_back(base);
+
+    // filter in linear space so the smaller levels don't darken
+    std::vector<float> linear((size_t)width * height * 4);
+    for(size_t i = 0; i < (size_t)width * height; i++)
+    {
+        linear[i * 4 + 0] = srgbToLinear[rgba[i * 4 + 0]];
+        linear[i * 4 + 1] = srgbToLinear[rgba[i * 4 + 1]];
+        linear[i * 4 + 2] = srgbToLinear[rgba[i * 4 + 2]];
+        linear[i * 4 + 3] = rgba[i * 4 + 3] / 255.0f;
+    }
+
+    int w = width, h = height;
+    while(w > 1 || h > 1)
+    {
+        int nw = std::max(1, w / 2);
+        int nh = std::max(1, h / 2);
+        std::vector<float> next((size_t)nw * nh * 4);
+        for(int y = 0; y < nh; y++)
+        {
+            int y0 = std::min(2 * y, h - 1), y1 = std::min(2 * y + 1, h - 1);
+            for(int x = 0; x < nw; x++)
+            {
+                int x0 = std::min(2 * x, w - 1), x1 = std::min(2 * x + 1, w - 1);
+                average4(&linear[((size_t)y0 * w + x0) * 4], &linear[((size_t)y0 * w + x1) * 4],
+                         &linear[((size_t)y1 * w + x0) * 4], &linear[((size_t)y1 * w + x1) * 4],
+                         &next[((size_t)y * nw + x) * 4]);
+            }
+        }
+
+        MipLevel level;
+        level.width = nw;
+        level.height = nh;
+        quantizeLevel(next, level);
+        levels.push_back(level);
+
+        linear.swap(next);
+        w = nw;
+        h = nh;
+    }
+    return levels;
+}
+
+//BLOCK COMPRESSION---------------------------------------------------------------------------------------
+// principal axis of the block through its mean, found by power iteration
+static void principalAxis(const unsigned char *block, int channels, float *mean, float *axis)
+{
+    for(int c = 0; c < channels; c++)
+    {
+        mean[c] = 0.0f;
+        for(int i = 0; i < 16; i++)
+            mean[c] += block[i * 4 + c];
+        mean[c] /= 16.0f;
+    }
+
+    float covariance[4][4] = {};
+    for(int i = 0; i < 16; i++)
+    {
+        for(int a = 0; a < channels; a++)
+            for(int b = 0; b < channels; b++)
+                covariance[a][b] += (block[i * 4 + a] - mean[a]) * (block[i * 4 + b] - mean[b]);
+    }
+
+    for(int c = 0; c < channels; c++)
+        axis[c] = 1.0f;
+    for(int iteration = 0; iteration < 8; iteration++)
+    {
+        float next[4] = {};
+        for(int a = 0; a < channels; a++)
+            for(int b = 0; b < channels; b++)
+                next[a] += covariance[a][b] * axis[b];
+        float length = 0.0f;
+        for(int c = 0; c < channels; c++)
+            length = std::max(length, std::fabs(next[c]));
+        if(length < 1e-6f)
+            break;
+        for(int c = 0; c < channels; c++)
+            axis[c] = next[c] / length;
+    }
+}
+
+static void axisEndpoints(const unsigned char *block, int channels, float *low, float *high)
+{
+    float mean[4], axis[4];
+    principalAxis(block, channels, mean, axis);
+
+    float minT = 0.0f, maxT = 0.0f;
+    float lengthSq = 0.0f;
+    for(int c = 0; c < channels; c++)
+        lengthSq += axis[c] * axis[c];
+    if(lengthSq > 0.0f)
+    {
+        minT = 1e30f;
+        maxT = -1e30f;
+        for(int i = 0; i < 16; i++)
+        {
+            float t = 0.0f;
+            for(int c = 0; c < channels; c++)
+                t += (block[i * 4 + c] - mean[c]) * axis[c];
+            t /= lengthSq;
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+    }
+    for(int c = 0; c < channels; c++)
+    {
+        low[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * minT));
+        high[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * maxT));
+    }
+}
+
+static inline uint16_t pack565(const float *color)
+{
+    int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+    int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+    int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static inline void unpack565(uint16_t packed, int *color)
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+static void encodeBC1Block(const unsigned char *block, unsigned char *out)
+{
+    float low[4], high[4];
+    axisEndpoints(block, 3, low, high);
+    uint16_t c0 = pack565(high);
+    uint16_t c1 = pack565(low);
+    if(c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if(c0 != c1)
+    {
+        int palette[4][3];
+        unpack565(c0, palette[0]);
+        unpack565(c1, palette[1]);
+        for(int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for(int i = 0; i < 16; i++)
+        {
+            int best = 0, bestError = 1 << 30;
+            for(int p = 0; p < 4; p++)
+            {
+                int error = 0;
+                for(int c = 0; c < 3; c++)
+                {
+                    int d = block[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if(error < bestError)
+                {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (2 * i);
+        }
+    }
+
+    out[0] = c0 & 0xFF;
+    out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF;
+    out[3] = c1 >> 8;
+    for(int i = 0; i < 4; i++)
+        out[4 + i] = (indices >> (8 * i)) & 0xFF;
+}
+
+static void encodeBC3AlphaBlock(const unsigned char *block, unsigned char *out)
+{
+    int a0 = 0, a1 = 255;
+    for(int i = 0; i < 16; i++)
+    {
+        a0 = std::max(a0, (int)block[i * 4 + 3]);
+        a1 = std::min(a1, (int)block[i * 4 + 3]);
+    }
+
+    uint64_t indices = 0;
+    if(a0 != a1)
+    {
+        int palette[8];
+        palette[0] = a0;
+        palette[1] = a1;
+        for(int i = 1; i < 7; i++)
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        for(int i = 0; i < 16; i++)
+        {
+            int best = 0, bestError = 1 << 30;
+            for(int p = 0; p < 8; p++)
+            {
+                int error = std::abs(block[i * 4 + 3] - palette[p]);
+                if(error < bestError)
+                {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= (uint64_t)best << (3 * i);
+        }
+    }
+
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for(int i = 0; i < 6; i++)
+        out[2 + i] = (indices >> (8 * i)) & 0xFF;
+}
+
+// BC7 mode 6 only: one subset, RGBA endpoints of 7 bits plus a p-bit each
+// and 4 bit indices. It is the mode that suits smooth colour textures best
+// and keeps the encoder small.
+static void writeBits(unsigned char *out, int &position, uint32_t value, int bits)
+{
+    for(int i = 0; i < bits; i++, position++)
+    {
+        if((value >> i) & 1)
+            out[position >> 3] |= (unsigned char)(1 << (position & 7));
+    }
+}
+
+static void quantizeBC7Endpoint(const float *color, int *quantized, int &pbit)
+{
+    int bestError = 1 << 30;
+    for(int p = 0; p < 2; p++)
+    {
+        int candidate[4], error = 0;
+        for(int c = 0; c < 4; c++)
+        {
+            candidate[c] = std::min(127, std::max(0, (int)((color[c] - p) / 2.0f + 0.5f)));
+            int d = ((candidate[c] << 1) | p) - (int)(color[c] + 0.5f);
+            error += d * d;
+        }
+        if(error < bestError)
+        {
+            bestError = error;
+            pbit = p;
+            std::memcpy(quantized, candidate, sizeof(candidate));
+        }
+    }
+}
+
+static void encodeBC7Block(const unsigned char *block, unsigned char *out)
+{
+    static const int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    float low[4], high[4];
+    axisEndpoints(block, 4, low, high);
+    int endpoints[2][4], pbits[2];
+    quantizeBC7Endpoint(low, endpoints[0], pbits[0]);
+    quantizeBC7Endpoint(high, endpoints[1], pbits[1]);
+
+    int palette[16][4];
+    for(int c = 0; c < 4; c++)
+    {
+        int e0 = (endpoints[0][c] << 1) | pbits[0];
+        int e1 = (endpoints[1][c] << 1) | pbits[1];
+        for(int i = 0; i < 16; i++)
+            palette[i][c] = ((64 - weights[i]) * e0 + weights[i] * e1 + 32) >> 6;
+    }
+
+    int indices[16];
+    for(int i = 0; i < 16; i++)
+    {
+        int best = 0, bestError = 1 << 30;
+        for(int p = 0; p < 16; p++)
+        {
+            int error = 0;
+            for(int c = 0; c < 4; c++)
+            {
+                int d = block[i * 4 + c] - palette[p][c];
+                error += d * d;
+            }
+            if(error < bestError)
+            {
+                bestError = error;
+                best = p;
+            }
+        }
+        indices[i] = best;
+    }
+
+    // the anchor index is stored with an implicit zero high bit
+    if(indices[0] & 8)
+    {
+        std::swap(endpoints[0], endpoints[1]);
+        std::swap(pbits[0], pbits[1]);
+        for(int i = 0; i < 16; i++)
+            indices[i] = 15 - indices[i];
+    }
+
+    std::memset(out, 0, 16);
+    int position = 0;
+    writeBits(out, position, 1 << 6, 7);
+    for(int c = 0; c < 4; c++)
+    {
+        writeBits(out, position, endpoints[0][c], 7);
+        writeBits(out, position, endpoints[1][c], 7);
+    }
+    writeBits(out, position, pbits[0], 1);
+    writeBits(out, position, pbits[1], 1);
+    writeBits(out, position, indices[0], 3);
+    for(int i = 1; i < 16; i++)
+        writeBits(out, position, indices[i], 4);
+}
+
+static void compressBlockRows(const MipLevel &level, BakeFormat format, unsigned char *out, int firstRow, int lastRow)
+{
+    int blocksWide = (level.width + 3) / 4;
+    size_t blockSize = format == BAKE_BC1 ? 8 : 16;
+    unsigned char block[64];
+    for(int by = firstRow; by < lastRow; by++)
+    {
+        for(int bx = 0; bx < blocksWide; bx++)
+        {
+            // edge blocks repeat the last row/column
+            for(int y = 0; y < 4; y++)
+            {
+                int sy = std::min(by * 4 + y, level.height - 1);
+                for(int x = 0; x < 4; x++)
+                {
+                    int sx = std::min(bx * 4 + x, level.width - 1);
+                    std::memcpy(&block[(y * 4 + x) * 4], &level.data[((size_t)sy * level.width + sx) * 4], 4);
+                }
+            }
+
+            unsigned char *dst = out + ((size_t)by * blocksWide + bx) * blockSize;
+            if(format == BAKE_BC1)
+            {
+                encodeBC1Block(block, dst);
+            }
+            else if(format == BAKE_BC3)
+            {
+                encodeBC3AlphaBlock(block, dst);
+                encodeBC1Block(block, dst + 8);
+            }
+            else
+            {
+                encodeBC7Block(block, dst);
+            }
+        }
+    }
+}
+
+void compressLevel(const MipLevel &level, BakeFormat format, MipLevel &compressed, ThreadPool *pool)
+{
+    int blocksWide = (level.width + 3) / 4;
+    int blocksHigh = (level.height + 3) / 4;
+    size_t blockSize = format == BAKE_BC1 ? 8 : 16;
+    compressed.width = level.width;
+    compressed.height = level.height;
+    compressed.data.assign((size_t)blocksWide * blocksHigh * blockSize, 0);
+
+    if(!pool || blocksHigh < 8)
+    {
+        compressBlockRows(level, format, compressed.data.data(), 0, blocksHigh);
+        return;
+    }
+
+    int chunks = std::min(blocksHigh, (int)pool -> size() * 4);
+    std::vector<std::future<void>> jobs;
+    for(int i = 0; i < chunks; i++)
+    {
+        int firstRow = blocksHigh * i / chunks;
+        int lastRow = blocksHigh * (i + 1) / chunks;
+        unsigned char *out = compressed.data.data();
+        jobs.push_back(pool -> submit([&level, format, out, firstRow, lastRow]() {
+            compressBlockRows(level, format, out, firstRow, lastRow);
+        }));
+    }
+    for(GLuint i = 0; i < jobs.size(); i++)
+        jobs[i].wait();
+}
+
+bool bakeTexture(const unsigned char *rgba, int width, int height, BakeFormat format, ThreadPool *pool, BakedTexture &baked)
+{
+    if(!rgba || width <= 0 || height <= 0)
+        return false;
+
+    if(format == BAKE_AUTO)
+    {
+        format = BAKE_BC1;
+        for(size_t i = 0; i < (size_t)width * height; i++)
+        {
+            if(rgba[i * 4 + 3] != 255)
+            {
+                format = BAKE_BC3;
+                break;
+            }
+        }
+    }
+
+    baked.width = width;
+    baked.height = height;
+    if(format == BAKE_BC1)
+    {
+        baked.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        baked.baseFormat = GL_RGB;
+    }
+    else if(format == BAKE_BC3)
+    {
+        baked.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        baked.baseFormat = GL_RGBA;
+    }
+    else
+    {
+        baked.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+        baked.baseFormat = GL_RGBA;
+    }
+
+    std::vector<MipLevel> mips = generateMipChain(rgba, width, height);
+    baked.levels.resize(mips.size());
+    for(GLuint i = 0; i < mips.size(); i++)
+    {
+        compressLevel(mips[i], format, baked.levels[i], pool);
+    }
+    return true;
+}
+
+//KTX CONTAINER-------------------------------------------------------------------------------------------
+static const unsigned char KTX_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+bool writeKTX(const std::string &path, const BakedTexture &baked, bool flipped)
+{
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+        return false;
+
+    std::string keyValue = std::string("KTXorientation") + '\0' + (flipped ? "S=r,T=u" : "S=r,T=d") + '\0';
+    uint32_t keyValueSize = (uint32_t)keyValue.size();
+    uint32_t keyValuePadded = (keyValueSize + 3) & ~3u;
+
+    uint32_t header[13] = {
+        0x04030201,
+        0, 1, 0,
+        baked.internalFormat,
+        baked.baseFormat,
+        (uint32_t)baked.width, (uint32_t)baked.height, 0,
+        0, 1,
+        (uint32_t)baked.levels.size(),
+        4 + keyValuePadded
+    };
+    file.write((const char*)KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)&keyValueSize, 4);
+    file.write(keyValue.data(), keyValueSize);
+    file.write("\0\0\0", keyValuePadded - keyValueSize);
+
+    for(GLuint i = 0; i < baked.levels.size(); i++)
+    {
+        uint32_t imageSize = (uint32_t)baked.levels[i].data.size();
+        file.write((const char*)&imageSize, 4);
+        file.write((const char*)baked.levels[i].data.data(), imageSize);
+        file.write("\0\0\0", ((imageSize + 3) & ~3u) - imageSize);
+    }
+    return (bool)file;
+}
+
+bool readKTX(const unsigned char *data, size_t size, BakedTexture &baked)
+{
+    if(size < sizeof(KTX_IDENTIFIER) + 52 || std::memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0)
+        return false;
+
+    uint32_t header[13];
+    std::memcpy(header, data + sizeof(KTX_IDENTIFIER), sizeof(header));
+    // only little-endian, single-face, compressed 2D files are produced by the baker
+    if(header[0] != 0x04030201 || header[1] != 0 || header[10] != 1 || header[8] > 1 || header[9] != 0)
+        return false;
+
+    baked.internalFormat = header[4];
+    baked.baseFormat = header[5];
+    baked.width = (int)header[6];
+    baked.height = (int)header[7];
+    uint32_t levelCount = std::max(1u, header[11]);
+
+    size_t offset = sizeof(KTX_IDENTIFIER) + sizeof(header) + header[12];
+    baked.levels.clear();
+    int w = baked.width, h = baked.height;
+    for(uint32_t i = 0; i < levelCount; i++)
+    {
+        if(offset + 4 > size)
+            return false;
+        uint32_t imageSize;
+        std::memcpy(&imageSize, data + offset, 4);
+        offset += 4;
+        if(offset + imageSize > size)
+            return false;
+
+        MipLevel level;
+        level.width = w;
+        level.height = h;
+        level.data.assign(data + offset, data + offset + imageSize);
+        baked.levels.push_back(level);
+        offset += (imageSize + 3) & ~3u;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return true;
+}
+
+GLenum ktxInternalFormat(const unsigned char *data, size_t size)
+{
+    if(size < sizeof(KTX_IDENTIFIER) + 52 || std::memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0)
+        return 0;
+
+    uint32_t internalFormat;
+    std::memcpy(&internalFormat, data + sizeof(KTX_IDENTIFIER) + 16, 4);
+    return internalFormat;
+}
+
+std::string bakedTexturePath(const std::string &path)
+{
+    return path + ".ktx";
+}
@@ -0,0 +1,47 @@
+#ifndef TEXTURE_BAKE_H
+#define TEXTURE_BAKE_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "thread_pool.h"
+
+// Offline texture baking: gamma-correct mip chains generated on the CPU,
+// block-compressed to BC1/BC3/BC7 and stored in a KTX (version 1) container
+// that TextureCache uploads with glCompressedTexImage2D.
+
+enum BakeFormat {
+    BAKE_AUTO,
+    BAKE_BC1,
+    BAKE_BC3,
+    BAKE_BC7
+};
+
+struct MipLevel {
+    int width;
+    int height;
+    std::vector<unsigned char> data;
+};
+
+struct BakedTexture {
+    GLenum internalFormat;
+    GLenum baseFormat;
+    int width;
+    int height;
+    std::vector<MipLevel> levels;
+};
+
+// rgba is width * height * 4 bytes in sRGB; every level of the result is RGBA8
+std::vector<MipLevel> generateMipChain(const unsigned char *rgba, int width, int height);
+void compressLevel(const MipLevel &level, BakeFormat format, MipLevel &compressed, ThreadPool *pool);
+bool bakeTexture(const unsigned char *rgba, int width, int height, BakeFormat format, ThreadPool *pool, BakedTexture &baked);
+
+bool writeKTX(const std::string &path, const BakedTexture &baked, bool flipped);
+bool readKTX(const unsigned char *data, size_t size, BakedTexture &baked);
+GLenum ktxInternalFormat(const unsigned char *data, size_t size);
+std::string bakedTexturePath(const std::string &path);
+
+#endif
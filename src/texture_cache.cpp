@@ -0,0 +1,711 @@
+#include "texture_cache.h"
+#include "stb_image.h"
+#include "gl_extensions.h"
+#include "gl_state.h"
+#include "asset_archive.h"
+#include "batch_io.h"
+#include "profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+// a baked texture is only used while it is newer than its source and the
+// driver can sample its block format (checked once its header is read);
+// inside the asset archive the two were packed together and the baked one
+// always wins
+static bool preferBakedTexture(const std::string &path)
+{
+    std::string bakedPath = bakedTexturePath(path);
+    if(AssetArchive::contains(bakedPath))
+        return true;
+
+    std::error_code error;
+    if(!std::filesystem::exists(bakedPath, error))
+        return false;
+    return !(std::filesystem::exists(path, error) && std::filesystem::last_write_time(bakedPath, error) < std::filesystem::last_write_time(path, error));
+}
+
+// reads the baked or the source file of every key in one batch; a baked file
+// the driver cannot sample falls back to the source image
+static void readTextureFiles(const std::vector<std::string> &keys, const std::function<void(size_t, std::vector<unsigned char>&, bool)> &onComplete)
+{
+    std::vector<ReadRequest> requests(keys.size());
+    std::vector<bool> baked(keys.size());
+    for(size_t i = 0; i < keys.size(); i++)
+    {
+        baked[i] = preferBakedTexture(keys[i]);
+        requests[i].path = baked[i] ? bakedTexturePath(keys[i]) : keys[i];
+    }
+
+    readFilesBatch(requests, [&](size_t i) {
+        std::vector<unsigned char> &bytes = requests[i].bytes;
+        bool ok = requests[i].ok;
+        if(baked[i] && (!ok || !supportsCompressedFormat(ktxInternalFormat(bytes.data(), bytes.size()))))
+        {
+            bytes.clear();
+            ok = readFileBytes(keys[i], bytes);
+        }
+        onComplete(i, bytes, ok);
+    });
+}
+
+TextureCache& TextureCache::instance()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+GLuint TextureCache::acquire(const std::string &path)
+{
+    return acquireBatch(std::vector<std::string>(1, path))[0];
+}
+
+std::vector<GLuint> TextureCache::acquireBatch(const std::vector<std::string> &paths)
+{
+    std::vector<GLuint> ids(paths.size(), 0);
+    std::vector<std::string> keys(paths.size());
+    std::vector<std::string> misses;
+    std::vector<size_t> owners;
+    std::unique_lock<std::recursive_mutex> lock(cacheMutex);
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        keys[i] = canonicalPath(paths[i]);
+        ids[i] = lookup(keys[i]);
+        if(ids[i] || loading.count(keys[i]))
+            continue;
+
+        auto file = prefetched.find(keys[i]);
+        if(file != prefetched.end())
+        {
+            ids[i] = create(keys[i], paths[i], file -> second.bytes, file -> second.ok);
+            prefetched.erase(file);
+            continue;
+        }
+        // other threads wait for this read instead of repeating it
+        loading.insert(keys[i]);
+        misses.push_back(keys[i]);
+        owners.push_back(i);
+    }
+
+    // all misses are read as one batch without the cache lock, so the render
+    // thread keeps uploading meanwhile; each image goes to the decode pool as
+    // soon as its read completes
+    lock.unlock();
+    readTextureFiles(misses, [&](size_t r, std::vector<unsigned char> &bytes, bool ok) {
+        std::lock_guard<std::recursive_mutex> completionLock(cacheMutex);
+        size_t i = owners[r];
+        ids[i] = create(keys[i], paths[i], bytes, ok);
+        loading.erase(keys[i]);
+        loadedCondition.notify_all();
+    });
+    lock.lock();
+
+    // the same path twice in one batch, or one another thread was reading,
+    // resolves to the texture created for it
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        if(ids[i])
+            continue;
+        loadedCondition.wait(lock, [&]() { return loading.count(keys[i]) == 0; });
+        ids[i] = lookup(keys[i]);
+        if(!ids[i])
+        {
+            // released again before this thread got to it
+            lock.unlock();
+            ids[i] = acquire(paths[i]);
+            lock.lock();
+        }
+    }
+    return ids;
+}
+
+void TextureCache::prefetch(const std::vector<std::string> &paths)
+{
+    std::vector<std::string> keys;
+    {
+        std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+        for(size_t i = 0; i < paths.size(); i++)
+        {
+            std::string key = canonicalPath(paths[i]);
+            if(!pathLookup.count(key) && !prefetched.count(key) && std::find(keys.begin(), keys.end(), key) == keys.end())
+                keys.push_back(key);
+        }
+    }
+
+    // no cache lock while reading, so uploads on other threads carry on
+    std::vector<PrefetchedFile> files(keys.size());
+    readTextureFiles(keys, [&files](size_t i, std::vector<unsigned char> &bytes, bool ok) {
+        files[i].bytes.swap(bytes);
+        files[i].ok = ok;
+    });
+
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    for(size_t i = 0; i < keys.size(); i++)
+    {
+        if(!pathLookup.count(keys[i]))
+            prefetched.emplace(keys[i], std::move(files[i]));
+    }
+}
+
+bool TextureCache::isResident(GLuint id) const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    auto it = entries.find(id);
+    return it == entries.end() || it -> second.pendingImages == 0;
+}
+
+GLuint TextureCache::acquireCubemap(const std::vector<std::string> &faces)
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    std::string key = "cubemap:";
+    for(GLuint i = 0; i < faces.size(); i++)
+        key += canonicalPath(faces[i]) + ";";
+    GLuint id = lookup(key);
+    if(id)
+        return id;
+
+    std::vector<ReadRequest> requests(faces.size());
+    for(GLuint i = 0; i < faces.size(); i++)
+        requests[i].path = faces[i];
+    readFilesBatch(requests);
+    uint64_t hash = hashBytes((const unsigned char*)"cubemap", 7);
+    for(GLuint i = 0; i < faces.size(); i++)
+        hash = hashBytes(requests[i].bytes.data(), requests[i].bytes.size(), hash);
+    id = lookupContent(key, hash);
+    if(id)
+        return id;
+
+    missCount++;
+    GLuint textureCubeMapID;
+    glGenTextures(1, &textureCubeMapID);
+    GLState::instance().bindTexture(GL_TEXTURE_CUBE_MAP, textureCubeMapID);
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    // the six faces decode concurrently and are uploaded as each one lands
+    insert(textureCubeMapID, key, hash, 0);
+    for(GLuint i = 0; i < faces.size(); i++)
+    {
+        decodeAsync(textureCubeMapID, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, false, std::move(requests[i].bytes), faces[i]);
+    }
+    return textureCubeMapID;
+}
+
+GLuint TextureCache::create(const std::string &key, const std::string &path, std::vector<unsigned char> &bytes, bool ok)
+{
+    if(!ok)
+    {
+        std::cout << "Failed to load texture: " << path << std::endl;
+        missCount++;
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        insert(textureID, key, 0, 0);
+        return textureID;
+    }
+
+    uint64_t hash = hashBytes(bytes.data(), bytes.size());
+    GLuint id = lookupContent(key, hash);
+    if(id)
+        return id;
+
+    missCount++;
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    insert(textureID, key, hash, 0);
+    decodeAsync(textureID, GL_TEXTURE_2D, true, std::move(bytes), path);
+    return textureID;
+}
+
+void TextureCache::retain(GLuint id)
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    auto it = entries.find(id);
+    if(it != entries.end())
+        it->second.refCount++;
+}
+
+void TextureCache::release(GLuint id)
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    auto it = entries.find(id);
+    if(it == entries.end())
+        return;
+
+    Entry &entry = it->second;
+    if(--entry.refCount > 0)
+        return;
+
+    for(GLuint i = 0; i < entry.keys.size(); i++)
+        pathLookup.erase(entry.keys[i]);
+    if(entry.hash)
+        hashLookup.erase(entry.hash);
+    streaming.erase(std::remove_if(streaming.begin(), streaming.end(),
+                                   [id](const StreamingTexture &texture) { return texture.id == id; }),
+                    streaming.end());
+    totalBytes -= entry.bytes;
+    GLState::instance().deleteTexture(id);
+    entries.erase(it);
+}
+
+void TextureCache::processUploads(size_t byteBudget)
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    std::vector<DecodedImage> ready;
+    {
+        std::lock_guard<std::mutex> decodedLock(decodedMutex);
+        ready.swap(decoded);
+    }
+    if(!ready.empty())
+    {
+        for(GLuint i = 0; i < ready.size(); i++)
+        {
+            upload(ready[i]);
+            Entry *entry = decodedFor(ready[i]);
+            if(entry)
+                entry -> pendingImages--;
+        }
+        {
+            std::lock_guard<std::mutex> decodedLock(decodedMutex);
+            inFlight -= ready.size();
+        }
+        decodedCondition.notify_all();
+    }
+
+    // always refine the texture whose next level is the smallest, so every
+    // texture reaches a given resolution before any of them goes finer
+    size_t spent = 0;
+    while(byteBudget > 0 && spent < byteBudget && !streaming.empty())
+    {
+        size_t next = 0;
+        for(size_t i = 1; i < streaming.size(); i++)
+        {
+            if(streaming[i].baked -> levels[streaming[i].level].data.size() < streaming[next].baked -> levels[streaming[next].level].data.size())
+                next = i;
+        }
+        spent += streamLevel(streaming[next], byteBudget - spent);
+        if(streaming[next].level < 0)
+            streaming.erase(streaming.begin() + next);
+    }
+}
+
+void TextureCache::finishUploads()
+{
+    while(true)
+    {
+        {
+            // another thread may upload the last images, so also wake on inFlight reaching zero
+            std::unique_lock<std::mutex> lock(decodedMutex);
+            decodedCondition.wait(lock, [this]() { return !decoded.empty() || inFlight == 0; });
+            if(decoded.empty() && inFlight == 0)
+                return;
+        }
+        // only the mip tails; the larger levels stream on the render thread
+        processUploads(0);
+    }
+}
+
+size_t TextureCache::pendingUploads() const
+{
+    std::lock_guard<std::mutex> lock(decodedMutex);
+    return inFlight;
+}
+
+size_t TextureCache::streamingTextures() const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return streaming.size();
+}
+
+unsigned TextureCache::decodeThreads()
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    if(!decodePool)
+        decodePool.reset(new ThreadPool());
+    return decodePool -> size();
+}
+
+void TextureCache::decodeAsync(GLuint id, GLenum target, bool mipmap, std::vector<unsigned char> &&bytes, const std::string &path)
+{
+    if(!decodePool)
+        decodePool.reset(new ThreadPool());
+
+    Entry &entry = entries[id];
+    entry.pendingImages++;
+    uint64_t generation = entry.generation;
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        inFlight++;
+    }
+    auto encoded = std::make_shared<std::vector<unsigned char>>(std::move(bytes));
+    decodePool -> enqueue([this, id, generation, target, mipmap, encoded, path]() {
+        ProfileScope scope("TextureCache::decode", path);
+        scope.bytesRead(encoded -> size());
+        DecodedImage image;
+        image.id = id;
+        image.generation = generation;
+        image.target = target;
+        image.mipmap = mipmap;
+        image.path = path;
+        image.data = NULL;
+        image.compressed = false;
+        std::shared_ptr<BakedTexture> baked = std::make_shared<BakedTexture>();
+        if(readKTX(encoded -> data(), encoded -> size(), *baked))
+        {
+            image.baked = baked;
+            image.compressed = true;
+        }
+        else if(mipmap)
+        {
+            // build the mip chain here so the render thread can upload the
+            // coarse levels first instead of calling glGenerateMipmap
+            unsigned char *rgba = stbi_load_from_memory(encoded -> data(), (int)encoded -> size(), &image.width, &image.height, &image.channels, 4);
+            if(rgba)
+            {
+                baked -> internalFormat = GL_RGB;
+                if(image.channels == 1)
+                    baked -> internalFormat = GL_RED;
+                else if(image.channels == 2)
+                    baked -> internalFormat = GL_RG;
+                else if(image.channels == 4)
+                    baked -> internalFormat = GL_RGBA;
+                baked -> baseFormat = GL_RGBA;
+                baked -> width = image.width;
+                baked -> height = image.height;
+                baked -> levels = generateMipChain(rgba, image.width, image.height);
+                image.baked = baked;
+                stbi_image_free(rgba);
+            }
+        }
+        else
+            image.data = stbi_load_from_memory(encoded -> data(), (int)encoded -> size(), &image.width, &image.height, &image.channels, 0);
+        if(image.baked)
+        {
+            for(size_t i = 0; i < image.baked -> levels.size(); i++)
+                scope.bytesDecoded(image.baked -> levels[i].data.size());
+        }
+        else if(image.data)
+        {
+            scope.bytesDecoded((size_t)image.width * image.height * image.channels);
+        }
+        scope.end();
+        {
+            std::lock_guard<std::mutex> lock(decodedMutex);
+            decoded.push_back(image);
+        }
+        decodedCondition.notify_all();
+    });
+}
+
+void TextureCache::upload(DecodedImage &image)
+{
+    if(image.baked)
+    {
+        beginStreaming(image);
+        return;
+    }
+
+    // released while decoding; the name may already belong to another texture
+    Entry *entry = decodedFor(image);
+    if(!image.data || !entry)
+    {
+        if(!image.data)
+            std::cout << "Failed to load texture: " << image.path << std::endl;
+        stbi_image_free(image.data);
+        return;
+    }
+
+    GLenum format = GL_RGB;
+    if(image.channels == 1)
+        format = GL_RED;
+    else if(image.channels == 2)
+        format = GL_RG;
+    else if(image.channels == 4)
+        format = GL_RGBA;
+    // cube faces have always been uploaded as RGB
+    if(image.target != GL_TEXTURE_2D)
+        format = GL_RGB;
+
+    size_t size = (size_t)image.width * image.height * image.channels;
+    ProfileScope scope("TextureCache::upload", image.path);
+    scope.bytesUploaded(size);
+    int slot;
+    const void *pixels = stagePixels(image.data, size, slot);
+
+    GLenum bindTarget = image.target == GL_TEXTURE_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
+    GLState::instance().bindTexture(bindTarget, image.id);
+    glTexImage2D(image.target, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    stbi_image_free(image.data);
+    size_t residentSize = size;
+    if(image.mipmap)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        // the full mip chain adds roughly a third on top of the base level
+        residentSize = size * 4 / 3;
+    }
+    finishStaging(slot);
+
+    entry -> bytes += residentSize;
+    totalBytes += residentSize;
+}
+
+void TextureCache::beginStreaming(DecodedImage &image)
+{
+    if(!decodedFor(image))
+        return;
+
+    // levels below GL_TEXTURE_BASE_LEVEL may stay undefined without making
+    // the texture incomplete, so sampling is limited to what has landed.
+    // GL_TEXTURE_MIN_LOD is left alone: it is relative to the base level.
+    StreamingTexture texture;
+    texture.id = image.id;
+    texture.baked = image.baked;
+    texture.compressed = image.compressed;
+    texture.level = (int)image.baked -> levels.size() - 1;
+    texture.row = 0;
+    GLState::instance().bindTexture(GL_TEXTURE_2D, image.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, texture.level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.level);
+
+    while(texture.level >= 0)
+    {
+        const MipLevel &level = texture.baked -> levels[texture.level];
+        if(level.width > TAIL_SIZE || level.height > TAIL_SIZE)
+            break;
+        streamLevel(texture, level.data.size());
+    }
+    if(texture.level >= 0)
+        streaming.push_back(texture);
+}
+
+size_t TextureCache::streamLevel(StreamingTexture &texture, size_t byteBudget)
+{
+    const BakedTexture &baked = *texture.baked;
+    const MipLevel &level = baked.levels[texture.level];
+
+    // block-compressed levels are split on block rows of four texels
+    int rowStep = texture.compressed ? 4 : 1;
+    int units = (level.height + rowStep - 1) / rowStep;
+    size_t unitBytes = level.data.size() / units;
+    int firstUnit = texture.row / rowStep;
+    int unitCount = units - firstUnit;
+    size_t fit = std::max<size_t>(byteBudget / unitBytes, 1);
+    if(fit < (size_t)unitCount)
+        unitCount = (int)fit;
+    int rows = std::min(unitCount * rowStep, level.height - texture.row);
+    size_t size = unitCount * unitBytes;
+    ProfileScope scope("TextureCache::streamLevel", "level " + std::to_string(texture.level));
+    scope.bytesUploaded(size);
+
+    GLState::instance().bindTexture(GL_TEXTURE_2D, texture.id);
+    if(texture.row == 0)
+    {
+        if(texture.compressed)
+            glCompressedTexImage2D(GL_TEXTURE_2D, texture.level, baked.internalFormat, level.width, level.height, 0, (GLsizei)level.data.size(), NULL);
+        else
+            glTexImage2D(GL_TEXTURE_2D, texture.level, baked.internalFormat, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+
+    int slot;
+    const void *pixels = stagePixels(level.data.data() + firstUnit * unitBytes, size, slot);
+    if(texture.compressed)
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, texture.level, 0, texture.row, level.width, rows, baked.internalFormat, (GLsizei)size, pixels);
+    else
+        glTexSubImage2D(GL_TEXTURE_2D, texture.level, 0, texture.row, level.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    finishStaging(slot);
+
+    texture.row += rows;
+    if(texture.row >= level.height)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, texture.level);
+        texture.level--;
+        texture.row = 0;
+    }
+
+    auto it = entries.find(texture.id);
+    if(it != entries.end())
+        it -> second.bytes += size;
+    totalBytes += size;
+    return size;
+}
+
+const void *TextureCache::stagePixels(const void *data, size_t size, int &slot)
+{
+    // wait until the GPU has consumed whatever was last staged in this slot;
+    // the fence may come from the other context sharing the ring, which
+    // finishStaging flushed, so a timeout only means the GPU is still busy
+    slot = nextUploadBuffer;
+    nextUploadBuffer = (nextUploadBuffer + 1) % UPLOAD_RING_SIZE;
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    if(uploadFences[slot])
+    {
+        GLenum status = GL_TIMEOUT_EXPIRED;
+        while(status == GL_TIMEOUT_EXPIRED)
+            status = glClientWaitSync(uploadFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        // without a signaled fence the driver has to synchronize the map
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            access &= ~GL_MAP_UNSYNCHRONIZED_BIT;
+        glDeleteSync(uploadFences[slot]);
+        uploadFences[slot] = 0;
+    }
+    if(!uploadBuffers[slot])
+        glGenBuffers(1, &uploadBuffers[slot]);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffers[slot]);
+    if(uploadBufferSizes[slot] < size)
+    {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+        uploadBufferSizes[slot] = size;
+    }
+    void *staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access);
+    if(!staging)
+    {
+        // mapping failed, fall back to a plain client-memory upload
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return data;
+    }
+    memcpy(staging, data, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    return (void*)0;
+}
+
+void TextureCache::finishStaging(int slot)
+{
+    uploadFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // the next wait on this fence may come from the other context, whose
+    // GL_SYNC_FLUSH_COMMANDS_BIT does not flush this one
+    glFlush();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+size_t TextureCache::hits() const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return hitCount;
+}
+
+size_t TextureCache::misses() const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return missCount;
+}
+
+float TextureCache::hitRate() const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    size_t total = hitCount + missCount;
+    return total ? (float)hitCount / (float)total : 0.0f;
+}
+
+size_t TextureCache::residentBytes() const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return totalBytes;
+}
+
+void TextureCache::printStats() const
+{
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    std::cout << "TEXTURE_CACHE:: " << entries.size() << " textures, "
+              << hitCount << " hits, " << missCount << " misses ("
+              << hitRate() * 100.0f << "% hit rate), "
+              << totalBytes / 1024 << " KiB resident, "
+              << streaming.size() << " still streaming" << std::endl;
+}
+
+GLuint TextureCache::lookup(const std::string &key)
+{
+    auto it = pathLookup.find(key);
+    if(it == pathLookup.end())
+        return 0;
+
+    hitCount++;
+    entries[it->second].refCount++;
+    return it->second;
+}
+
+GLuint TextureCache::lookupContent(const std::string &key, uint64_t hash)
+{
+    auto it = hashLookup.find(hash);
+    if(it == hashLookup.end())
+        return 0;
+
+    // same bytes under a different path: alias the path to the existing texture
+    hitCount++;
+    Entry &entry = entries[it->second];
+    entry.refCount++;
+    entry.keys.push_back(key);
+    pathLookup[key] = it->second;
+    return it->second;
+}
+
+void TextureCache::insert(GLuint id, const std::string &key, uint64_t hash, size_t bytes)
+{
+    Entry entry;
+    entry.refCount = 1;
+    entry.pendingImages = 0;
+    entry.generation = ++nextGeneration;
+    entry.bytes = bytes;
+    entry.hash = hash;
+    entry.keys.push_back(key);
+    entries[id] = entry;
+    pathLookup[key] = id;
+    if(hash)
+        hashLookup[hash] = id;
+    totalBytes += bytes;
+}
+
+TextureCache::Entry* TextureCache::decodedFor(const DecodedImage &image)
+{
+    auto it = entries.find(image.id);
+    if(it == entries.end() || it -> second.generation != image.generation)
+        return NULL;
+    return &it -> second;
+}
+
+std::string canonicalPath(const std::string &path)
+{
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if(error)
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    return canonical.generic_string();
+}
+
+bool readFileBytes(const std::string &path, std::vector<unsigned char> &bytes)
+{
+    const unsigned char *packed;
+    size_t packedSize;
+    if(AssetArchive::find(path, packed, packedSize))
+    {
+        bytes.assign(packed, packed + packedSize);
+        return true;
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file)
+        return false;
+
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    bytes.resize((size_t)size);
+    return (bool)file.read((char*)bytes.data(), size);
+}
+
+uint64_t hashBytes(const unsigned char *data, size_t size, uint64_t seed)
+{
+    // FNV-1a, 64 bit
+    uint64_t hash = seed;
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,163 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "thread_pool.h"
+#include "texture_bake.h"
+
+// Process-wide texture cache. Textures are keyed by canonical path and by a
+// hash of the file contents, so the same image referenced from two models (or
+// through two different paths) is decoded and uploaded only once. Every
+// acquire must be paired with a release; the GL texture is deleted when the
+// last reference goes away.
+//
+// Decoding runs on a worker pool: acquire returns a texture name straight
+// away and the pixels arrive later through processUploads, which streams
+// finished images into GL via a small ring of pixel-unpack buffers. Every
+// entry point needs a current context that shares objects with the main
+// window; calls from the render thread and the AssetLoader upload thread are
+// serialised by the cache, but file reads run outside its lock.
+//
+// When an up-to-date baked "<image>.ktx" sits next to the source image (see
+// tools/texbake.cpp) its precompressed mip chain is uploaded instead and the
+// image is never decoded.
+//
+// 2D textures become resident progressively: the decode worker builds the mip
+// chain, the small mip tail is uploaded as soon as the image arrives and the
+// larger levels follow in row bands, limited to a byte budget per
+// processUploads call. GL_TEXTURE_BASE_LEVEL points at the largest complete
+// level until level 0 has landed.
+class TextureCache
+{
+    public:
+        static TextureCache& instance();
+
+        GLuint acquire(const std::string &path);
+        // reads every miss in one I/O batch (see batch_io.h)
+        std::vector<GLuint> acquireBatch(const std::vector<std::string> &paths);
+        // reads the files a later acquireBatch will need; no GL, any thread
+        void prefetch(const std::vector<std::string> &paths);
+        // false while an image of the texture still waits for decode
+        bool isResident(GLuint id) const;
+        GLuint acquireCubemap(const std::vector<std::string> &faces);
+        void retain(GLuint id);
+        void release(GLuint id);
+
+        // levels of at most TAIL_SIZE texels per side are uploaded as soon as
+        // an image is decoded, regardless of the budget
+        static const int TAIL_SIZE = 64;
+        static const size_t STREAM_BUDGET_BYTES = 4 * 1024 * 1024;
+
+        void processUploads(size_t byteBudget = STREAM_BUDGET_BYTES);
+        void finishUploads();
+        size_t pendingUploads() const;
+        size_t streamingTextures() const;
+        unsigned decodeThreads();
+
+        size_t hits() const;
+        size_t misses() const;
+        float hitRate() const;
+        size_t residentBytes() const;
+        void printStats() const;
+
+    private:
+        struct Entry {
+            GLuint refCount;
+            GLuint pendingImages;
+            // unique per entry; GL reuses the names of released textures
+            uint64_t generation;
+            size_t bytes;
+            uint64_t hash;
+            std::vector<std::string> keys;
+        };
+
+        struct PrefetchedFile {
+            std::vector<unsigned char> bytes;
+            bool ok = false;
+        };
+
+        struct DecodedImage {
+            GLuint id;
+            // of the entry it was decoded for
+            uint64_t generation;
+            GLenum target;
+            bool mipmap;
+            unsigned char *data;
+            int width, height, channels;
+            std::shared_ptr<BakedTexture> baked;
+            bool compressed;
+            std::string path;
+        };
+
+        // a 2D texture whose larger mip levels are still being uploaded;
+        // level is the next one to stream, row the next texel row within it
+        struct StreamingTexture {
+            GLuint id;
+            std::shared_ptr<BakedTexture> baked;
+            bool compressed;
+            int level;
+            int row;
+        };
+
+        static const int UPLOAD_RING_SIZE = 4;
+
+        mutable std::recursive_mutex cacheMutex;
+        std::unordered_map<std::string, GLuint> pathLookup;
+        std::unordered_map<uint64_t, GLuint> hashLookup;
+        std::unordered_map<GLuint, Entry> entries;
+        std::unordered_map<std::string, PrefetchedFile> prefetched;
+        // keys an acquireBatch is reading right now, outside the lock
+        std::unordered_set<std::string> loading;
+        std::condition_variable_any loadedCondition;
+        size_t hitCount = 0;
+        size_t missCount = 0;
+        size_t totalBytes = 0;
+        uint64_t nextGeneration = 0;
+
+        std::unique_ptr<ThreadPool> decodePool;
+        mutable std::mutex decodedMutex;
+        std::condition_variable decodedCondition;
+        std::vector<DecodedImage> decoded;
+        size_t inFlight = 0;
+        std::vector<StreamingTexture> streaming;
+
+        GLuint uploadBuffers[UPLOAD_RING_SIZE] = {};
+        size_t uploadBufferSizes[UPLOAD_RING_SIZE] = {};
+        GLsync uploadFences[UPLOAD_RING_SIZE] = {};
+        int nextUploadBuffer = 0;
+
+        TextureCache() = default;
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        GLuint lookup(const std::string &key);
+        GLuint lookupContent(const std::string &key, uint64_t hash);
+        GLuint create(const std::string &key, const std::string &path, std::vector<unsigned char> &bytes, bool ok);
+        void insert(GLuint id, const std::string &key, uint64_t hash, size_t bytes);
+        // the entry an image was decoded for, NULL once that texture was released
+        Entry* decodedFor(const DecodedImage &image);
+        void decodeAsync(GLuint id, GLenum target, bool mipmap, std::vector<unsigned char> &&bytes, const std::string &path);
+        void upload(DecodedImage &image);
+        void beginStreaming(DecodedImage &image);
+        size_t streamLevel(StreamingTexture &texture, size_t byteBudget);
+        const void *stagePixels(const void *data, size_t size, int &slot);
+        void finishStaging(int slot);
+};
+
+std::string canonicalPath(const std::string &path);
+bool readFileBytes(const std::string &path, std::vector<unsigned char> &bytes);
+uint64_t hashBytes(const unsigned char *data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+#endif
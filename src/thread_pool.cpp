@@ -0,0 +1,67 @@
+#include "thread_pool.h"
+
+#include <cstdlib>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if(threadCount == 0)
+        threadCount = 1;
+    for(unsigned i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for(unsigned i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push(std::move(job));
+    }
+    condition.notify_one();
+}
+
+unsigned ThreadPool::size() const
+{
+    return (unsigned)workers.size();
+}
+
+unsigned ThreadPool::defaultThreadCount()
+{
+    const char *env = std::getenv("ASTEROID_THREADS");
+    if(env && std::atoi(env) > 0)
+        return (unsigned)std::atoi(env);
+
+    unsigned count = std::thread::hardware_concurrency();
+    return count ? count : 4;
+}
+
+void ThreadPool::workerLoop()
+{
+    while(true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if(stopping && jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+// Fixed-size pool of worker threads used for CPU-side asset work (image
+// decoding, parsing). Workers never touch GL; results are handed back to the
+// thread that owns the context.
+class ThreadPool
+{
+    public:
+        explicit ThreadPool(unsigned threadCount = defaultThreadCount());
+        ~ThreadPool();
+
+        void enqueue(std::function<void()> job);
+        unsigned size() const;
+
+        template<typename F>
+        auto submit(F &&f) -> std::future<decltype(f())>
+        {
+            auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::forward<F>(f));
+            std::future<decltype(f())> result = task -> get_future();
+            enqueue([task]() { (*task)(); });
+            return result;
+        }
+
+        // worker count from ASTEROID_THREADS, or the hardware concurrency
+        static unsigned defaultThreadCount();
+
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+        void workerLoop();
+};
+
+#endif
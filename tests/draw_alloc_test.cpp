@@ -0,0 +1,169 @@
+// Checks that drawing a mesh does not touch the heap once every program has
+// drawn it once. Runs on the null GL backend, so it needs no GPU or window:
+// global operator new is replaced with a counting one, each program draws
+// two meshes once, one with Draw and one with DrawInstances, then DRAWS more
+// draws alternate between them. Each of those has to bind all four of its
+// textures (the meshes share none, so the state cache cannot skip them) and
+// none may allocate. The last round uses more programs than a Material
+// caches bindings for, so every draw evicts one and resolves its samplers
+// again.
+//
+//   drawtest
+
+#include "null_gl.h"
+#include "mesh.h"
+#include "shader.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+#include <atomic>
+#include <new>
+#include <memory>
+#include <cstdlib>
+#include <cstddef>
+
+static std::atomic<size_t> allocations(0);
+
+// Every replaceable form goes through these two, so whatever a new
+// expression picks, its memory comes from malloc or aligned_alloc and goes
+// back through free.
+static void* allocate(std::size_t size, std::size_t align)
+{
+    allocations++;
+    if(size == 0)
+        size = 1;
+    if(align > alignof(std::max_align_t))
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+    return std::malloc(size);
+}
+
+static void release(void *memory)
+{
+    std::free(memory);
+}
+
+static void* allocateOrThrow(std::size_t size, std::size_t align)
+{
+    if(void *memory = allocate(size, align))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) { return allocateOrThrow(size, (std::size_t)align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocateOrThrow(size, (std::size_t)align); }
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept { return allocate(size, (std::size_t)align); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept { return allocate(size, (std::size_t)align); }
+
+void operator delete(void *memory) noexcept { release(memory); }
+void operator delete[](void *memory) noexcept { release(memory); }
+void operator delete(void *memory, std::size_t) noexcept { release(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { release(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { release(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { release(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { release(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { release(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { release(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { release(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { release(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { release(memory); }
+
+static const int DRAWS = 10000;
+
+static const int TEXTURES = 4;
+
+static Mesh* makeMesh(GLuint firstTexture)
+{
+    std::vector<Vertex> vertices(3);
+    vertices[1].Position = glm::vec3(1.0f, 0.0f, 0.0f);
+    vertices[2].Position = glm::vec3(0.0f, 1.0f, 0.0f);
+    std::vector<GLuint> indices = {0, 1, 2};
+    // two textures per role, so the sampler names are texture_diffuse1,
+    // texture_diffuse2, ...: too long for the small string buffer
+    std::vector<Texture> textures = {
+        Texture{firstTexture, "texture_diffuse", "a.png"},
+        Texture{firstTexture + 1, "texture_diffuse", "b.png"},
+        Texture{firstTexture + 2, "texture_specular", "c.png"},
+        Texture{firstTexture + 3, "texture_specular", "d.png"}
+    };
+    return new Mesh(vertices, indices, textures);
+}
+
+struct DrawCounts {
+    uint64_t textureBinds;
+    size_t allocations;
+};
+
+// DRAWS draws cycling through the given programs
+static DrawCounts draw(Mesh &a, Mesh &b, std::vector<std::unique_ptr<Shader>> &shaders, size_t programs)
+{
+    for(size_t i = 0; i < programs; i++)
+    {
+        shaders[i] -> use();
+        a.Draw(*shaders[i]);
+        b.DrawInstances(*shaders[i], 4);
+    }
+
+    uint64_t binds = NullGL::calls("glBindTexture");
+    size_t before = allocations;
+    for(int i = 0; i < DRAWS; i++)
+    {
+        Shader &shader = *shaders[i % programs];
+        shader.use();
+        if(i % 2)
+            b.DrawInstances(shader, 4);
+        else
+            a.Draw(shader);
+    }
+    DrawCounts counts;
+    counts.allocations = allocations - before;
+    counts.textureBinds = NullGL::calls("glBindTexture") - binds;
+    return counts;
+}
+
+static bool check(const char *name, const DrawCounts &counts)
+{
+    std::cout << "DRAW_ALLOC_TEST:: " << name << ": " << counts.textureBinds << " texture binds, "
+              << counts.allocations << " allocations in " << DRAWS << " draws" << std::endl;
+    if(counts.textureBinds != (uint64_t)DRAWS * TEXTURES)
+    {
+        std::cout << "DRAW_ALLOC_TEST:: " << name << ": expected " << (uint64_t)DRAWS * TEXTURES << " texture binds" << std::endl;
+        return false;
+    }
+    return counts.allocations == 0;
+}
+
+int main()
+{
+    if(!gladLoadGLLoader((GLADloadproc)NullGL::loader))
+    {
+        std::cout << "ERROR::DRAW_ALLOC_TEST::Failed to load the null GL backend" << std::endl;
+        return 1;
+    }
+
+    const size_t programs = Material::MAX_PROGRAMS + 2;
+    std::vector<std::unique_ptr<Shader>> shaders;
+    for(size_t i = 0; i < programs; i++)
+        shaders.emplace_back(new Shader("shaders/vshader.glsl", "tests/shaders/material.frag"));
+    // units follow the samplers' declaration order, the same for every program
+    const char *samplers[TEXTURES] = {"texture_diffuse1", "texture_diffuse2", "texture_specular1", "texture_specular2"};
+    for(size_t i = 0; i < programs; i++)
+        for(int unit = 0; unit < TEXTURES; unit++)
+            if(shaders[i] -> samplerUnit(samplers[unit]) != unit)
+            {
+                std::cout << "DRAW_ALLOC_TEST:: " << samplers[unit] << " is on unit " << shaders[i] -> samplerUnit(samplers[unit])
+                          << ", expected " << unit << std::endl;
+                return 1;
+            }
+    std::unique_ptr<Mesh> a(makeMesh(1));
+    std::unique_ptr<Mesh> b(makeMesh(1 + TEXTURES));
+
+    bool ok = check("one program", draw(*a, *b, shaders, 1));
+    ok = check("MAX_PROGRAMS programs", draw(*a, *b, shaders, Material::MAX_PROGRAMS)) && ok;
+    ok = check("MAX_PROGRAMS + 2 programs, evicting", draw(*a, *b, shaders, programs)) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+// Checks the native OBJ loader against Assimp: every fixture is loaded
+// through loadObj and through the importer Model falls back to with
+// ASTEROID_OBJ_ASSIMP (same post-processing, same IO handler). Meshes are
+// split differently by the two (Assimp starts a new mesh on every usemtl,
+// the native loader has one per object and material), so both sides are
+// grouped by their material's texture maps and compared per group:
+//
+//   - index counts
+//   - distinct (position, normal, uv) corners, and that the native loader
+//     emits each of them exactly once per mesh
+//   - the triangles themselves, with winding, within a tolerance
+//
+// Assimp leaves corners without a vn at a zero normal (Model does not ask it
+// to generate any); the native loader gives them the area-weighted sum of
+// the faces around them. The Assimp side computes that from its triangles
+// before comparing, so fixtures that mix corners with and without vn keep to
+// one object per material.
+//
+//   objtest [fixture.obj...]
+
+#include "obj_loader.h"
+#include "mapped_io.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <array>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+static const float TOLERANCE = 1e-4f;
+
+// position, normal, uv
+typedef std::array<float, 8> Corner;
+typedef std::array<Corner, 3> Triangle;
+
+struct MaterialGroup {
+    std::vector<Triangle> triangles;
+    size_t indices = 0;
+};
+
+typedef std::map<std::string, MaterialGroup> MaterialGroups;
+
+static Corner makeCorner(const glm::vec3 &position, const glm::vec3 &normal, const glm::vec2 &uv)
+{
+    Corner corner = {position.x, position.y, position.z, normal.x, normal.y, normal.z, uv.x, uv.y};
+    return corner;
+}
+
+// corners compare on a grid coarser than the parsers can disagree by
+static std::array<long long, 8> quantize(const Corner &corner)
+{
+    std::array<long long, 8> key;
+    for(size_t i = 0; i < corner.size(); i++)
+        key[i] = std::llround(corner[i] / TOLERANCE);
+    return key;
+}
+
+// rotated to start at its smallest corner, which keeps the winding
+static Triangle canonical(const Triangle &triangle)
+{
+    size_t first = 0;
+    for(size_t i = 1; i < 3; i++)
+    {
+        if(quantize(triangle[i]) < quantize(triangle[first]))
+            first = i;
+    }
+    Triangle result = {triangle[first], triangle[(first + 1) % 3], triangle[(first + 2) % 3]};
+    return result;
+}
+
+static size_t distinctCorners(const std::vector<Triangle> &triangles)
+{
+    std::set<std::array<long long, 8>> corners;
+    for(size_t t = 0; t < triangles.size(); t++)
+    {
+        for(size_t c = 0; c < 3; c++)
+            corners.insert(quantize(triangles[t][c]));
+    }
+    return corners.size();
+}
+
+static std::string groupKey(const std::string &diffuse, const std::string &specular)
+{
+    return "diffuse '" + diffuse + "', specular '" + specular + "'";
+}
+
+static bool loadNative(const std::string &path, MaterialGroups &groups)
+{
+    std::vector<ObjMesh> meshes;
+    if(!loadObj(path, meshes))
+        return false;
+
+    bool ok = true;
+    for(size_t m = 0; m < meshes.size(); m++)
+    {
+        const ObjMesh &mesh = meshes[m];
+        MaterialGroup &group = groups[groupKey(mesh.diffuseMap, mesh.specularMap)];
+        group.indices += mesh.indices.size();
+        std::vector<Triangle> triangles;
+        for(size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            Triangle triangle;
+            for(size_t c = 0; c < 3; c++)
+            {
+                const Vertex &vertex = mesh.vertices[mesh.indices[i + c]];
+                triangle[c] = makeCorner(vertex.Position, vertex.Normal, vertex.TexCoords);
+            }
+            triangles.push_back(triangle);
+        }
+        if(distinctCorners(triangles) != mesh.vertices.size())
+        {
+            std::cout << "OBJ_TEST:: native mesh " << m << " has " << mesh.vertices.size() << " vertices for "
+                      << distinctCorners(triangles) << " distinct corners" << std::endl;
+            ok = false;
+        }
+        group.triangles.insert(group.triangles.end(), triangles.begin(), triangles.end());
+    }
+    return ok;
+}
+
+static void collectAssimp(const aiNode *node, const aiScene *scene, MaterialGroups &groups)
+{
+    for(unsigned n = 0; n < node -> mNumMeshes; n++)
+    {
+        const aiMesh *mesh = scene -> mMeshes[node -> mMeshes[n]];
+        const aiMaterial *material = scene -> mMaterials[mesh -> mMaterialIndex];
+        aiString diffuse, specular;
+        if(material -> GetTextureCount(aiTextureType_DIFFUSE) == 0 || material -> GetTexture(aiTextureType_DIFFUSE, 0, &diffuse) != AI_SUCCESS)
+            diffuse = aiString();
+        if(material -> GetTextureCount(aiTextureType_SPECULAR) == 0 || material -> GetTexture(aiTextureType_SPECULAR, 0, &specular) != AI_SUCCESS)
+            specular = aiString();
+
+        MaterialGroup &group = groups[groupKey(diffuse.C_Str(), specular.C_Str())];
+        for(unsigned f = 0; f < mesh -> mNumFaces; f++)
+        {
+            const aiFace &face = mesh -> mFaces[f];
+            group.indices += face.mNumIndices;
+            if(face.mNumIndices != 3)
+                continue;
+            Triangle triangle;
+            for(size_t c = 0; c < 3; c++)
+            {
+                unsigned index = face.mIndices[c];
+                const aiVector3D &position = mesh -> mVertices[index];
+                glm::vec3 normal(0.0f);
+                if(mesh -> mNormals)
+                    normal = glm::vec3(mesh -> mNormals[index].x, mesh -> mNormals[index].y, mesh -> mNormals[index].z);
+                glm::vec2 uv(0.0f);
+                if(mesh -> mTextureCoords[0])
+                    uv = glm::vec2(mesh -> mTextureCoords[0][index].x, mesh -> mTextureCoords[0][index].y);
+                triangle[c] = makeCorner(glm::vec3(position.x, position.y, position.z), normal, uv);
+            }
+            group.triangles.push_back(triangle);
+        }
+    }
+    for(unsigned i = 0; i < node -> mNumChildren; i++)
+        collectAssimp(node -> mChildren[i], scene, groups);
+}
+
+// what the native loader does for corners without a vn: the normalized sum of
+// the (area-weighted) normals of the faces sharing that position and uv
+static void smoothMissingNormals(MaterialGroup &group)
+{
+    typedef std::array<long long, 5> Key;
+    auto keyOf = [](const Corner &corner) {
+        std::array<long long, 8> quantized = quantize(corner);
+        Key key = {quantized[0], quantized[1], quantized[2], quantized[6], quantized[7]};
+        return key;
+    };
+    auto missing = [](const Corner &corner) { return corner[3] == 0.0f && corner[4] == 0.0f && corner[5] == 0.0f; };
+
+    std::map<Key, glm::vec3> sums;
+    for(size_t t = 0; t < group.triangles.size(); t++)
+    {
+        const Triangle &triangle = group.triangles[t];
+        glm::vec3 a(triangle[0][0], triangle[0][1], triangle[0][2]);
+        glm::vec3 b(triangle[1][0], triangle[1][1], triangle[1][2]);
+        glm::vec3 c(triangle[2][0], triangle[2][1], triangle[2][2]);
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        for(size_t i = 0; i < 3; i++)
+        {
+            if(missing(triangle[i]))
+                sums[keyOf(triangle[i])] += normal;
+        }
+    }
+    for(size_t t = 0; t < group.triangles.size(); t++)
+    {
+        for(size_t i = 0; i < 3; i++)
+        {
+            Corner &corner = group.triangles[t][i];
+            if(!missing(corner))
+                continue;
+            glm::vec3 normal = sums[keyOf(corner)];
+            float length = glm::length(normal);
+            if(length > 0.0f)
+                normal /= length;
+            corner[3] = normal.x;
+            corner[4] = normal.y;
+            corner[5] = normal.z;
+        }
+    }
+}
+
+static bool loadAssimp(const std::string &path, MaterialGroups &groups)
+{
+    Assimp::Importer import;
+    import.SetIOHandler(new MappedIOSystem());
+    const aiScene *scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    if(!scene || scene -> mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene -> mRootNode)
+    {
+        std::cout << "ERROR::ASSIMP::" << import.GetErrorString() << std::endl;
+        return false;
+    }
+    collectAssimp(scene -> mRootNode, scene, groups);
+    for(auto it = groups.begin(); it != groups.end(); it++)
+        smoothMissingNormals(it -> second);
+    return true;
+}
+
+static bool sameTriangles(std::vector<Triangle> native, std::vector<Triangle> assimp, std::string &difference)
+{
+    for(size_t i = 0; i < native.size(); i++)
+        native[i] = canonical(native[i]);
+    for(size_t i = 0; i < assimp.size(); i++)
+        assimp[i] = canonical(assimp[i]);
+    auto order = [](const Triangle &a, const Triangle &b) {
+        for(size_t c = 0; c < 3; c++)
+        {
+            std::array<long long, 8> qa = quantize(a[c]), qb = quantize(b[c]);
+            if(qa != qb)
+                return qa < qb;
+        }
+        return false;
+    };
+    std::sort(native.begin(), native.end(), order);
+    std::sort(assimp.begin(), assimp.end(), order);
+
+    for(size_t t = 0; t < native.size(); t++)
+    {
+        for(size_t c = 0; c < 3; c++)
+        {
+            for(size_t v = 0; v < 8; v++)
+            {
+                if(std::fabs(native[t][c][v] - assimp[t][c][v]) > TOLERANCE)
+                {
+                    static const char *const fields[8] = {"position.x", "position.y", "position.z", "normal.x", "normal.y", "normal.z", "uv.x", "uv.y"};
+                    difference = "triangle " + std::to_string(t) + " corner " + std::to_string(c) + " " + fields[v] + ": "
+                               + std::to_string(native[t][c][v]) + " native, " + std::to_string(assimp[t][c][v]) + " Assimp";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool checkFixture(const std::string &path)
+{
+    MaterialGroups native, assimp;
+    bool ok = loadNative(path, native);
+    if(!loadAssimp(path, assimp))
+        ok = false;
+
+    for(auto it = assimp.begin(); it != assimp.end(); it++)
+    {
+        if(!native.count(it -> first))
+        {
+            std::cout << "OBJ_TEST:: " << path << ": " << it -> first << " only comes from Assimp" << std::endl;
+            ok = false;
+        }
+    }
+    for(auto it = native.begin(); it != native.end(); it++)
+    {
+        auto other = assimp.find(it -> first);
+        if(other == assimp.end())
+        {
+            std::cout << "OBJ_TEST:: " << path << ": " << it -> first << " only comes from the native loader" << std::endl;
+            ok = false;
+            continue;
+        }
+        const MaterialGroup &mine = it -> second;
+        const MaterialGroup &theirs = other -> second;
+        std::string difference;
+        if(mine.indices != theirs.indices)
+            difference = std::to_string(mine.indices) + " indices native, " + std::to_string(theirs.indices) + " Assimp";
+        else if(distinctCorners(mine.triangles) != distinctCorners(theirs.triangles))
+            difference = std::to_string(distinctCorners(mine.triangles)) + " distinct vertices native, "
+                       + std::to_string(distinctCorners(theirs.triangles)) + " Assimp";
+        else
+            sameTriangles(mine.triangles, theirs.triangles, difference);
+
+        if(!difference.empty())
+        {
+            std::cout << "OBJ_TEST:: " << path << ": " << it -> first << ": " << difference << std::endl;
+            ok = false;
+        }
+        else
+            std::cout << "OBJ_TEST:: " << path << ": " << it -> first << ": " << mine.indices << " indices, "
+                      << distinctCorners(mine.triangles) << " vertices match" << std::endl;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> fixtures;
+    for(int i = 1; i < argc; i++)
+        fixtures.push_back(argv[i]);
+    if(fixtures.empty())
+        fixtures = {"tests/obj/quads.obj", "tests/obj/negative.obj", "tests/obj/materials.obj", "tests/obj/mixed.obj"};
+
+    size_t failed = 0;
+    for(size_t i = 0; i < fixtures.size(); i++)
+    {
+        if(!checkFixture(fixtures[i]))
+            failed++;
+    }
+    std::cout << "OBJ_TEST:: " << fixtures.size() - failed << " of " << fixtures.size() << " fixtures match Assimp" << std::endl;
+    return failed ? 1 : 0;
+}
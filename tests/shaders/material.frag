@@ -0,0 +1,20 @@
+#version 330 core
+out vec4 FragColor;
+
+// every sampler a Material can name for two textures per role
+uniform sampler2D texture_diffuse1;
+uniform sampler2D texture_diffuse2;
+uniform sampler2D texture_specular1;
+uniform sampler2D texture_specular2;
+
+in VS_OUT
+{
+    vec2 texCoords;
+} fs_in;
+
+void main()
+{
+    vec4 diffuse = texture(texture_diffuse1, fs_in.texCoords) * texture(texture_diffuse2, fs_in.texCoords);
+    vec4 specular = texture(texture_specular1, fs_in.texCoords) + texture(texture_specular2, fs_in.texCoords);
+    FragColor = diffuse + specular * 0.5;
+}
@@ -0,0 +1,161 @@
+// Asset packer: writes every given file (directories are walked recursively)
+// into one archive that AssetArchive maps at startup. Run it from the
+// directory the application runs in, since entries are keyed by their path
+// relative to it.
+//
+//   assetpack [-o assets.pak] path...
+
+#include "asset_archive.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+struct PackedFile {
+    std::string key;
+    std::string path;
+    uint64_t size;
+    uint64_t offset;
+};
+
+static void collect(const std::filesystem::path &path, const std::string &output, std::vector<PackedFile> &files)
+{
+    std::error_code error;
+    if(std::filesystem::is_directory(path, error))
+    {
+        for(const auto &item : std::filesystem::recursive_directory_iterator(path, error))
+        {
+            if(item.is_regular_file(error))
+                collect(item.path(), output, files);
+        }
+        return;
+    }
+    if(!std::filesystem::is_regular_file(path, error))
+    {
+        std::cout << "ERROR::ASSETPACK::No such file: " << path.generic_string() << std::endl;
+        return;
+    }
+    // never pack the archive into itself
+    if(std::filesystem::equivalent(path, output, error))
+        return;
+
+    PackedFile file;
+    file.key = archiveKey(std::filesystem::absolute(path).generic_string());
+    file.path = path.generic_string();
+    file.size = std::filesystem::file_size(path, error);
+    files.push_back(file);
+}
+
+static uint64_t alignUp(uint64_t offset)
+{
+    return (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+int main(int argc, char **argv)
+{
+    std::string output = "assets.pak";
+    std::vector<std::string> inputs;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "-o" && i + 1 < argc)
+            output = argv[++i];
+        else
+            inputs.push_back(arg);
+    }
+    if(inputs.empty())
+    {
+        std::cout << "usage: assetpack [-o assets.pak] path..." << std::endl;
+        return 1;
+    }
+
+    std::vector<PackedFile> files;
+    for(size_t i = 0; i < inputs.size(); i++)
+        collect(inputs[i], output, files);
+    std::sort(files.begin(), files.end(), [](const PackedFile &a, const PackedFile &b) { return a.key < b.key; });
+    files.erase(std::unique(files.begin(), files.end(), [](const PackedFile &a, const PackedFile &b) { return a.key == b.key; }), files.end());
+
+    // keep the table at most half full so probe sequences stay short
+    uint32_t tableSize = 16;
+    while(tableSize < files.size() * 2)
+        tableSize *= 2;
+
+    std::string names;
+    std::vector<ArchiveEntry> table(tableSize);
+    memset(table.data(), 0, table.size() * sizeof(ArchiveEntry));
+    uint64_t namesOffset = sizeof(ArchiveHeader) + (uint64_t)tableSize * sizeof(ArchiveEntry);
+    for(size_t i = 0; i < files.size(); i++)
+        names += files[i].key;
+    uint64_t dataOffset = alignUp(namesOffset + names.size());
+
+    uint32_t nameOffset = 0;
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        ArchiveEntry entry;
+        entry.hash = archiveHash(files[i].key);
+        entry.offset = dataOffset;
+        entry.size = files[i].size;
+        files[i].offset = dataOffset;
+        entry.nameOffset = nameOffset;
+        entry.nameLength = (uint32_t)files[i].key.size();
+        nameOffset += entry.nameLength;
+        dataOffset = alignUp(dataOffset + entry.size);
+
+        uint32_t slot = (uint32_t)(entry.hash & (tableSize - 1));
+        while(table[slot].hash)
+            slot = (slot + 1) & (tableSize - 1);
+        table[slot] = entry;
+    }
+
+    ArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    header.version = ARCHIVE_VERSION;
+    header.entryCount = (uint32_t)files.size();
+    header.tableSize = tableSize;
+    header.tableOffset = sizeof(ArchiveHeader);
+    header.namesOffset = namesOffset;
+
+    std::ofstream archive(output, std::ios::binary | std::ios::trunc);
+    if(!archive)
+    {
+        std::cout << "ERROR::ASSETPACK::Cannot write " << output << std::endl;
+        return 1;
+    }
+    archive.write((const char*)&header, sizeof(header));
+    archive.write((const char*)table.data(), table.size() * sizeof(ArchiveEntry));
+    archive.write(names.data(), names.size());
+
+    // entries go out in key order, each padded to the next page boundary
+    uint64_t total = 0;
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        std::ifstream input(files[i].path, std::ios::binary);
+        std::vector<char> bytes((size_t)files[i].size);
+        if(!input.read(bytes.data(), bytes.size()))
+        {
+            std::cout << "ERROR::ASSETPACK::Cannot read " << files[i].path << std::endl;
+            return 1;
+        }
+        uint64_t position = (uint64_t)archive.tellp();
+        std::vector<char> padding((size_t)(files[i].offset - position), 0);
+        archive.write(padding.data(), padding.size());
+        archive.write(bytes.data(), bytes.size());
+        total += bytes.size();
+    }
+    uint64_t end = (uint64_t)archive.tellp();
+    std::vector<char> padding((size_t)(alignUp(end) - end), 0);
+    archive.write(padding.data(), padding.size());
+
+    if(!archive)
+    {
+        std::cout << "ERROR::ASSETPACK::Write failed: " << output << std::endl;
+        return 1;
+    }
+    std::cout << "ASSETPACK:: " << files.size() << " files, " << total / 1024 << " KiB -> " << output << std::endl;
+    return 0;
+}
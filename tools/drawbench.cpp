@@ -0,0 +1,155 @@
+// Draw submission benchmark on the null GL backend: measures the CPU cost of
+// the scene's per-frame draw work without a GPU, a window or Assimp. Each
+// frame sets the camera uniforms, then draws the planet mesh DRAWS times with
+// its model matrix and the rock mesh once instanced, alternating two texture
+// sets so no bind can be skipped. Two ways of doing it are timed:
+//
+//   names    what Mesh::Draw and main did before uniform locations were
+//            cached: every uniform write calls glGetUniformLocation and
+//            every draw builds its sampler names ("texture_diffuse1", ...)
+//            as strings and binds each texture directly
+//   handles  the current tree: UniformHandle writes and Mesh::Draw
+//
+// The null backend answers glGetUniformLocation with a short string compare,
+// so the names figures are a lower bound for a real driver.
+//
+//   drawbench [draws per frame] [frames]
+
+#include "null_gl.h"
+#include "mesh.h"
+#include "shader.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+
+static Mesh* makeMesh(GLuint firstTexture)
+{
+    std::vector<Vertex> vertices(3);
+    vertices[1].Position = glm::vec3(1.0f, 0.0f, 0.0f);
+    vertices[2].Position = glm::vec3(0.0f, 1.0f, 0.0f);
+    std::vector<GLuint> indices = {0, 1, 2};
+    std::vector<Texture> textures = {
+        Texture{firstTexture, "texture_diffuse", "diffuse.png"},
+        Texture{firstTexture + 1, "texture_specular", "specular.png"}
+    };
+    return new Mesh(vertices, indices, textures);
+}
+
+// Mesh::Draw as it was before the sampler names were built once
+static void drawByName(Mesh &mesh, Shader &shader, GLuint amount)
+{
+    GLuint diffuseNr = 1;
+    GLuint specularNr = 1;
+
+    for (GLuint i = 0; i < mesh.textures.size(); i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        std::string number;
+        std::string name = mesh.textures[i].type;
+        if(name == "texture_diffuse")
+        {
+            number = std::to_string(diffuseNr++);
+        }
+        else if(name == "texture_specular")
+        {
+            number = std::to_string(specularNr++);
+        }
+
+        glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
+        glBindTexture(GL_TEXTURE_2D, mesh.textures[i].id);
+    }
+
+    glBindVertexArray(mesh.VAO);
+    if(amount)
+        glDrawElementsInstanced(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0, amount);
+    else
+        glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
+static void setMatrixByName(Shader &shader, const char *name, const glm::mat4 &matrix)
+{
+    glUniformMatrix4fv(glGetUniformLocation(shader.ID, name), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+int main(int argc, char **argv)
+{
+    int draws = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 1000;
+    if(draws <= 0 || frames <= 0)
+    {
+        std::cout << "usage: drawbench [draws per frame] [frames]" << std::endl;
+        return 1;
+    }
+    if(!gladLoadGLLoader((GLADloadproc)NullGL::loader))
+    {
+        std::cout << "ERROR::DRAWBENCH::Failed to load the null GL backend" << std::endl;
+        return 1;
+    }
+
+    Shader shader("shaders/vshader.glsl", "shaders/fshader.glsl");
+    Shader instanceShader("shaders/vshader.glsl", "shaders/fshader.glsl", NULL, SHADER_INSTANCED);
+    std::unique_ptr<Mesh> planets[2] = {std::unique_ptr<Mesh>(makeMesh(1)), std::unique_ptr<Mesh>(makeMesh(3))};
+    std::unique_ptr<Mesh> rock(makeMesh(5));
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 55.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 1000.0f);
+    glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -3.0f, 0.0f)), glm::vec3(10.0f));
+    const GLuint amount = 50000;
+
+    auto byName = [&]() {
+        shader.use();
+        setMatrixByName(shader, "view", view);
+        setMatrixByName(shader, "projection", projection);
+        for(int i = 0; i < draws; i++)
+        {
+            setMatrixByName(shader, "model", model);
+            drawByName(*planets[i % 2], shader, 0);
+        }
+        instanceShader.use();
+        setMatrixByName(instanceShader, "view", view);
+        setMatrixByName(instanceShader, "projection", projection);
+        drawByName(*rock, instanceShader, amount);
+    };
+
+    UniformHandle<glm::mat4> shaderView = shader.uniform<glm::mat4>("view");
+    UniformHandle<glm::mat4> shaderProjection = shader.uniform<glm::mat4>("projection");
+    UniformHandle<glm::mat4> shaderModel = shader.uniform<glm::mat4>("model");
+    UniformHandle<glm::mat4> instanceView = instanceShader.uniform<glm::mat4>("view");
+    UniformHandle<glm::mat4> instanceProjection = instanceShader.uniform<glm::mat4>("projection");
+    auto byHandle = [&]() {
+        shader.use();
+        shader.set(shaderView, view);
+        shader.set(shaderProjection, projection);
+        for(int i = 0; i < draws; i++)
+        {
+            shader.set(shaderModel, model);
+            planets[i % 2] -> Draw(shader);
+        }
+        instanceShader.use();
+        instanceShader.set(instanceView, view);
+        instanceShader.set(instanceProjection, projection);
+        rock -> DrawInstances(instanceShader, amount);
+    };
+
+    auto run = [&](const char *name, auto frame) {
+        // one untimed frame resolves the programs and fills the caches
+        frame();
+        uint64_t calls = NullGL::calls();
+        auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < frames; i++)
+            frame();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+        std::cout << "DRAWBENCH:: " << name << ": " << us << " us/frame, " << us / (draws + 1) << " us/draw, "
+                  << (NullGL::calls() - calls) / frames << " GL calls/frame" << std::endl;
+    };
+    std::cout << "DRAWBENCH:: " << draws << " planet draws + 1 instanced rock draw per frame, " << frames << " frames" << std::endl;
+    run("names", byName);
+    run("handles", byHandle);
+    return 0;
+}
@@ -0,0 +1,607 @@
+// GL capture replayer: re-executes a stream recorded with ASTEROID_GL_CAPTURE
+// (see GLCapture) on an EGL surfaceless context, without a window or the
+// application; Mesa's llvmpipe is enough. Every captured thread gets its own
+// context sharing objects with the first one, and the default framebuffer is
+// stood in for by a framebuffer of the captured size. Object names, uniform
+// locations and sync objects are mapped from the captured values to the ones
+// this driver hands out.
+//
+// Reports startup and per-frame wall time (every frame ends with glFinish)
+// and, per entry point, how often it ran and how long its calls took. -s
+// adds a glFinish after every call so GPU work is charged to the call that
+// caused it; -e checks glGetError after every call and names failing calls.
+//
+//   glreplay [-s] [-e] capture.bin
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "gl_capture.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <cstring>
+#include <cstdio>
+
+enum ReplayEntry {
+#define GL_FUNCTION(ret, name, params, args) REPLAY_##name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+    REPLAY_ENTRY_COUNT
+};
+
+static const char* const REPLAY_NAMES[REPLAY_ENTRY_COUNT] = {
+#define GL_FUNCTION(ret, name, params, args) #name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+};
+
+// object namespaces; container objects and queries belong to one context
+enum NameSpace {
+    NAMES_BUFFER,
+    NAMES_TEXTURE,
+    NAMES_VERTEX_ARRAY,
+    NAMES_FRAMEBUFFER,
+    NAMES_RENDERBUFFER,
+    NAMES_PROGRAM,
+    NAMES_QUERY,
+    NAMES_SAMPLER
+};
+
+struct NameArgument {
+    const char *function;
+    int argument;
+    NameSpace names;
+};
+
+// arguments that name an object; shaders share the program namespace
+static const NameArgument NAME_ARGUMENTS[] = {
+    { "glBindBuffer", 1, NAMES_BUFFER },
+    { "glBindBufferBase", 2, NAMES_BUFFER },
+    { "glBindBufferRange", 2, NAMES_BUFFER },
+    { "glTexBuffer", 2, NAMES_BUFFER },
+    { "glBindTexture", 1, NAMES_TEXTURE },
+    { "glFramebufferTexture", 2, NAMES_TEXTURE },
+    { "glFramebufferTexture1D", 3, NAMES_TEXTURE },
+    { "glFramebufferTexture2D", 3, NAMES_TEXTURE },
+    { "glFramebufferTexture3D", 3, NAMES_TEXTURE },
+    { "glFramebufferTextureLayer", 2, NAMES_TEXTURE },
+    { "glBindVertexArray", 0, NAMES_VERTEX_ARRAY },
+    { "glBindFramebuffer", 1, NAMES_FRAMEBUFFER },
+    { "glBindRenderbuffer", 1, NAMES_RENDERBUFFER },
+    { "glFramebufferRenderbuffer", 3, NAMES_RENDERBUFFER },
+    { "glUseProgram", 0, NAMES_PROGRAM },
+    { "glAttachShader", 0, NAMES_PROGRAM },
+    { "glAttachShader", 1, NAMES_PROGRAM },
+    { "glDetachShader", 0, NAMES_PROGRAM },
+    { "glDetachShader", 1, NAMES_PROGRAM },
+    { "glShaderSource", 0, NAMES_PROGRAM },
+    { "glCompileShader", 0, NAMES_PROGRAM },
+    { "glDeleteShader", 0, NAMES_PROGRAM },
+    { "glLinkProgram", 0, NAMES_PROGRAM },
+    { "glValidateProgram", 0, NAMES_PROGRAM },
+    { "glDeleteProgram", 0, NAMES_PROGRAM },
+    { "glBindAttribLocation", 0, NAMES_PROGRAM },
+    { "glBindFragDataLocation", 0, NAMES_PROGRAM },
+    { "glBindFragDataLocationIndexed", 0, NAMES_PROGRAM },
+    { "glGetUniformLocation", 0, NAMES_PROGRAM },
+    { "glGetAttribLocation", 0, NAMES_PROGRAM },
+    { "glGetFragDataLocation", 0, NAMES_PROGRAM },
+    { "glGetUniformBlockIndex", 0, NAMES_PROGRAM },
+    { "glUniformBlockBinding", 0, NAMES_PROGRAM },
+    { "glBeginQuery", 1, NAMES_QUERY },
+    { "glQueryCounter", 0, NAMES_QUERY },
+    { "glBeginConditionalRender", 0, NAMES_QUERY },
+    { "glBindSampler", 1, NAMES_SAMPLER },
+    { "glSamplerParameteri", 0, NAMES_SAMPLER },
+    { "glSamplerParameteriv", 0, NAMES_SAMPLER },
+    { "glSamplerParameterf", 0, NAMES_SAMPLER },
+    { "glSamplerParameterfv", 0, NAMES_SAMPLER },
+    { "glSamplerParameterIiv", 0, NAMES_SAMPLER },
+    { "glSamplerParameterIuiv", 0, NAMES_SAMPLER }
+};
+
+struct Blob {
+    const char *data;
+    uint64_t size;
+};
+
+static std::unordered_map<uint64_t, Blob> blobData;
+static std::unordered_map<uint64_t, GLuint> objectNames;
+static std::unordered_map<uint64_t, GLint> locations;
+static std::unordered_map<uint64_t, GLsync> syncs;
+static std::map<std::pair<uint16_t, GLenum>, char*> mappings;
+static std::vector<GLuint> currentPrograms(1, 0);
+static uint16_t currentThread = 0;
+static GLuint backbuffer = 0;
+
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLConfig config;
+static std::vector<EGLContext> contexts;
+
+static uint64_t nameKey(NameSpace names, uint64_t captured)
+{
+    bool perContext = names == NAMES_VERTEX_ARRAY || names == NAMES_FRAMEBUFFER || names == NAMES_QUERY;
+    return (uint64_t)names << 56 | (perContext ? (uint64_t)currentThread << 32 : 0) | (captured & 0xFFFFFFFFu);
+}
+
+static uint64_t translateName(NameSpace names, uint64_t captured)
+{
+    if(captured == 0)
+        return names == NAMES_FRAMEBUFFER && currentThread == 0 ? backbuffer : 0;
+    auto name = objectNames.find(nameKey(names, captured));
+    return name == objectNames.end() ? captured : name -> second;
+}
+
+// uniform locations and block indices, per program of this driver
+static uint64_t locationKey(bool block, GLuint program, uint64_t captured)
+{
+    return (uint64_t)block << 63 | (uint64_t)program << 32 | (captured & 0xFFFFFFFFu);
+}
+
+static uint64_t translateLocation(bool block, GLuint program, uint64_t captured)
+{
+    if((GLint)captured == -1)
+        return captured;
+    auto location = locations.find(locationKey(block, program, captured));
+    return location == locations.end() ? captured : (uint64_t)(uint32_t)location -> second;
+}
+
+template<typename T>
+static T replayArgument(uint64_t slot, bool blob)
+{
+    if constexpr(std::is_same_v<T, GLsync>)
+    {
+        auto sync = syncs.find(slot);
+        return sync == syncs.end() ? NULL : sync -> second;
+    }
+    else if constexpr(std::is_pointer_v<T>)
+        return blob ? (T)blobData[slot].data : fromCaptureSlot<T>(slot);
+    else
+        return fromCaptureSlot<T>(slot);
+}
+
+template<typename R, typename... A, size_t... I>
+static R invokeSlots(R (APIENTRY *function)(A...), const uint64_t *slots, uint16_t blobs, std::index_sequence<I...>)
+{
+    return function(replayArgument<A>(slots[I], (blobs >> I) & 1)...);
+}
+
+template<typename R, typename... A>
+static R invoke(R (APIENTRY *function)(A...), const uint64_t *slots, uint16_t blobs)
+{
+    return invokeSlots(function, slots, blobs, std::index_sequence_for<A...>());
+}
+
+typedef void (*ReplayFunction)(const uint64_t *slots, uint16_t blobs);
+
+// calls that only need their arguments converted back
+#define GL_FUNCTION(ret, name, params, args) \
+    static void replay_##name(const uint64_t *slots, uint16_t blobs) { invoke(glad_##name, slots, blobs); }
+#include "gl_functions.h"
+#undef GL_FUNCTION
+
+#define REPLAY_GENERATE(function, names) \
+    static void replay_##function##Names(const uint64_t *slots, uint16_t) \
+    { \
+        GLsizei n = (GLsizei)slots[0]; \
+        std::vector<GLuint> created(n); \
+        glad_##function(n, created.data()); \
+        const GLuint *captured = (const GLuint*)blobData[slots[1]].data; \
+        for(GLsizei i = 0; i < n; i++) \
+            objectNames[nameKey(names, captured[i])] = created[i]; \
+    }
+REPLAY_GENERATE(glGenBuffers, NAMES_BUFFER)
+REPLAY_GENERATE(glGenTextures, NAMES_TEXTURE)
+REPLAY_GENERATE(glGenVertexArrays, NAMES_VERTEX_ARRAY)
+REPLAY_GENERATE(glGenFramebuffers, NAMES_FRAMEBUFFER)
+REPLAY_GENERATE(glGenRenderbuffers, NAMES_RENDERBUFFER)
+REPLAY_GENERATE(glGenQueries, NAMES_QUERY)
+REPLAY_GENERATE(glGenSamplers, NAMES_SAMPLER)
+#undef REPLAY_GENERATE
+
+#define REPLAY_DELETE(function, names) \
+    static void replay_##function##Names(const uint64_t *slots, uint16_t) \
+    { \
+        GLsizei n = (GLsizei)slots[0]; \
+        const GLuint *captured = (const GLuint*)blobData[slots[1]].data; \
+        std::vector<GLuint> deleted(n); \
+        for(GLsizei i = 0; i < n; i++) \
+        { \
+            deleted[i] = (GLuint)translateName(names, captured[i]); \
+            if(captured[i]) \
+                objectNames.erase(nameKey(names, captured[i])); \
+        } \
+        glad_##function(n, deleted.data()); \
+    }
+REPLAY_DELETE(glDeleteBuffers, NAMES_BUFFER)
+REPLAY_DELETE(glDeleteTextures, NAMES_TEXTURE)
+REPLAY_DELETE(glDeleteVertexArrays, NAMES_VERTEX_ARRAY)
+REPLAY_DELETE(glDeleteFramebuffers, NAMES_FRAMEBUFFER)
+REPLAY_DELETE(glDeleteRenderbuffers, NAMES_RENDERBUFFER)
+REPLAY_DELETE(glDeleteQueries, NAMES_QUERY)
+REPLAY_DELETE(glDeleteSamplers, NAMES_SAMPLER)
+#undef REPLAY_DELETE
+
+static void replayCreateShader(const uint64_t *slots, uint16_t)
+{
+    objectNames[nameKey(NAMES_PROGRAM, slots[1])] = glCreateShader((GLenum)slots[0]);
+}
+
+static void replayCreateProgram(const uint64_t *slots, uint16_t)
+{
+    objectNames[nameKey(NAMES_PROGRAM, slots[0])] = glCreateProgram();
+}
+
+static void replayUseProgram(const uint64_t *slots, uint16_t)
+{
+    currentPrograms[currentThread] = (GLuint)slots[0];
+    glUseProgram((GLuint)slots[0]);
+}
+
+static void replayGetUniformLocation(const uint64_t *slots, uint16_t)
+{
+    GLuint program = (GLuint)slots[0];
+    locations[locationKey(false, program, slots[2])] = glGetUniformLocation(program, blobData[slots[1]].data);
+}
+
+static void replayGetUniformBlockIndex(const uint64_t *slots, uint16_t)
+{
+    GLuint program = (GLuint)slots[0];
+    locations[locationKey(true, program, slots[2])] = (GLint)glGetUniformBlockIndex(program, blobData[slots[1]].data);
+}
+
+static void replayShaderSource(const uint64_t *slots, uint16_t)
+{
+    const GLchar *source = blobData[slots[2]].data;
+    glShaderSource((GLuint)slots[0], 1, &source, NULL);
+}
+
+static void replayFenceSync(const uint64_t *slots, uint16_t)
+{
+    syncs[slots[2]] = glFenceSync((GLenum)slots[0], (GLbitfield)slots[1]);
+}
+
+static void replayDeleteSync(const uint64_t *slots, uint16_t)
+{
+    glDeleteSync(replayArgument<GLsync>(slots[0], false));
+    syncs.erase(slots[0]);
+}
+
+static void replayMapBufferRange(const uint64_t *slots, uint16_t blobs)
+{
+    mappings[std::make_pair(currentThread, (GLenum)slots[0])] = (char*)invoke(glad_glMapBufferRange, slots, blobs);
+}
+
+static void replayMapBuffer(const uint64_t *slots, uint16_t blobs)
+{
+    mappings[std::make_pair(currentThread, (GLenum)slots[0])] = (char*)invoke(glad_glMapBuffer, slots, blobs);
+}
+
+static void replayUnmapBuffer(const uint64_t *slots, uint16_t)
+{
+    glUnmapBuffer((GLenum)slots[0]);
+    mappings.erase(std::make_pair(currentThread, (GLenum)slots[0]));
+}
+
+static void replayMappedWrite(const uint64_t *slots)
+{
+    auto mapping = mappings.find(std::make_pair(currentThread, (GLenum)slots[0]));
+    const Blob &blob = blobData[slots[2]];
+    if(mapping != mappings.end() && mapping -> second)
+        std::memcpy(mapping -> second + slots[1], blob.data, blob.size);
+}
+
+static void makeCurrent(uint16_t thread)
+{
+    if(thread == currentThread)
+        return;
+    static const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE
+    };
+    while(contexts.size() <= thread)
+    {
+        contexts.push_back(eglCreateContext(display, config, contexts[0], contextAttributes));
+        currentPrograms.push_back(0);
+    }
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, contexts[thread]);
+    currentThread = thread;
+}
+
+static bool createContext(uint32_t width, uint32_t height)
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    EGLint major, minor;
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cout << "ERROR::GLREPLAY::No surfaceless EGL display" << std::endl;
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+    static const EGLint configAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLint configs = 0;
+    if(!eglChooseConfig(display, configAttributes, &config, 1, &configs) || configs == 0)
+    {
+        std::cout << "ERROR::GLREPLAY::No EGL config for desktop GL" << std::endl;
+        return false;
+    }
+    static const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if(context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cout << "ERROR::GLREPLAY::Cannot create a GL 3.3 core context" << std::endl;
+        return false;
+    }
+    contexts.push_back(context);
+    if(!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+    {
+        std::cout << "ERROR::GLREPLAY::Failed to initialize GLAD" << std::endl;
+        return false;
+    }
+
+    // stands in for the window's framebuffer
+    GLuint renderbuffers[2];
+    glGenFramebuffers(1, &backbuffer);
+    glGenRenderbuffers(2, renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, backbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glViewport(0, 0, width, height);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+struct EntryTiming {
+    uint64_t calls = 0;
+    double seconds = 0.0;
+    uint64_t errors = 0;
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    bool finishCalls = false;
+    bool checkErrors = false;
+    std::string path;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "-s")
+            finishCalls = true;
+        else if(arg == "-e")
+            checkErrors = true;
+        else
+            path = arg;
+    }
+    if(path.empty())
+    {
+        std::cout << "usage: glreplay [-s] [-e] capture.bin" << std::endl;
+        return 1;
+    }
+
+    // whole file in 8-byte aligned memory; blobs are used in place
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file)
+    {
+        std::cout << "ERROR::GLREPLAY::Cannot read " << path << std::endl;
+        return 1;
+    }
+    size_t fileSize = (size_t)file.tellg();
+    std::vector<uint64_t> storage((fileSize + 7) / 8);
+    const char *data = (const char*)storage.data();
+    file.seekg(0);
+    file.read((char*)storage.data(), fileSize);
+
+    GLCaptureHeader header;
+    if(fileSize < sizeof(header))
+        fileSize = 0;
+    else
+        std::memcpy(&header, data, sizeof(header));
+    if(fileSize == 0 || std::memcmp(header.magic, GL_CAPTURE_MAGIC, sizeof(header.magic)) != 0 || header.version != GL_CAPTURE_VERSION)
+    {
+        std::cout << "ERROR::GLREPLAY::Not a GL capture: " << path << std::endl;
+        return 1;
+    }
+
+    // captured entry points by name, so the list may change between builds
+    std::vector<ReplayFunction> generic = {
+#define GL_FUNCTION(ret, name, params, args) replay_##name,
+#include "gl_functions.h"
+#undef GL_FUNCTION
+    };
+    std::vector<ReplayFunction> handlers(header.entryCount, NULL);
+    std::vector<int> localEntries(header.entryCount, -1);
+    std::vector<std::vector<std::pair<int, NameSpace>>> nameArguments(header.entryCount);
+    std::vector<bool> uniformCalls(header.entryCount, false);
+    size_t offset = sizeof(header);
+    for(uint32_t i = 0; i < header.entryCount && offset < fileSize; i++)
+    {
+        const char *name = data + offset;
+        offset += std::strlen(name) + 1;
+        for(int e = 0; e < REPLAY_ENTRY_COUNT; e++)
+        {
+            if(std::strcmp(name, REPLAY_NAMES[e]) == 0)
+            {
+                localEntries[i] = e;
+                handlers[i] = generic[e];
+            }
+        }
+        for(size_t a = 0; a < sizeof(NAME_ARGUMENTS) / sizeof(NAME_ARGUMENTS[0]); a++)
+        {
+            if(std::strcmp(name, NAME_ARGUMENTS[a].function) == 0)
+                nameArguments[i].push_back(std::make_pair(NAME_ARGUMENTS[a].argument, NAME_ARGUMENTS[a].names));
+        }
+        uniformCalls[i] = std::strncmp(name, "glUniform", 9) == 0 && std::strcmp(name, "glUniformBlockBinding") != 0;
+
+        static const std::pair<const char*, ReplayFunction> SPECIAL[] = {
+            { "glGenBuffers", replay_glGenBuffersNames },
+            { "glGenTextures", replay_glGenTexturesNames },
+            { "glGenVertexArrays", replay_glGenVertexArraysNames },
+            { "glGenFramebuffers", replay_glGenFramebuffersNames },
+            { "glGenRenderbuffers", replay_glGenRenderbuffersNames },
+            { "glGenQueries", replay_glGenQueriesNames },
+            { "glGenSamplers", replay_glGenSamplersNames },
+            { "glDeleteBuffers", replay_glDeleteBuffersNames },
+            { "glDeleteTextures", replay_glDeleteTexturesNames },
+            { "glDeleteVertexArrays", replay_glDeleteVertexArraysNames },
+            { "glDeleteFramebuffers", replay_glDeleteFramebuffersNames },
+            { "glDeleteRenderbuffers", replay_glDeleteRenderbuffersNames },
+            { "glDeleteQueries", replay_glDeleteQueriesNames },
+            { "glDeleteSamplers", replay_glDeleteSamplersNames },
+            { "glCreateShader", replayCreateShader },
+            { "glCreateProgram", replayCreateProgram },
+            { "glUseProgram", replayUseProgram },
+            { "glGetUniformLocation", replayGetUniformLocation },
+            { "glGetUniformBlockIndex", replayGetUniformBlockIndex },
+            { "glShaderSource", replayShaderSource },
+            { "glFenceSync", replayFenceSync },
+            { "glDeleteSync", replayDeleteSync },
+            { "glMapBufferRange", replayMapBufferRange },
+            { "glMapBuffer", replayMapBuffer },
+            { "glUnmapBuffer", replayUnmapBuffer }
+        };
+        for(size_t s = 0; s < sizeof(SPECIAL) / sizeof(SPECIAL[0]); s++)
+        {
+            if(std::strcmp(name, SPECIAL[s].first) == 0)
+                handlers[i] = SPECIAL[s].second;
+        }
+    }
+    offset = (offset + 7) / 8 * 8;
+
+    if(!createContext(header.width, header.height))
+        return 1;
+    std::cout << "GLREPLAY:: " << path << " on " << (const char*)glGetString(GL_RENDERER)
+              << ", " << header.width << "x" << header.height << std::endl;
+
+    std::vector<EntryTiming> timings(header.entryCount);
+    std::vector<double> frameTimes;
+    double startupTime = 0.0;
+    uint64_t frameErrors = 0;
+    auto frameStart = std::chrono::steady_clock::now();
+    while(offset + sizeof(GLCapturePacket) <= fileSize)
+    {
+        GLCapturePacket packet;
+        std::memcpy(&packet, data + offset, sizeof(packet));
+        offset += sizeof(packet);
+        uint64_t slots[16] = {};
+        std::memcpy(slots, data + offset, std::min<size_t>(packet.slotCount, 16) * sizeof(uint64_t));
+        offset += packet.slotCount * sizeof(uint64_t);
+
+        if(packet.entry == GL_CAPTURE_BLOB)
+        {
+            blobData[slots[0]] = Blob{data + offset, slots[1]};
+            offset += (slots[1] + 7) / 8 * 8;
+            continue;
+        }
+        if(packet.entry == GL_CAPTURE_FRAME || packet.entry == GL_CAPTURE_STARTUP)
+        {
+            makeCurrent(0);
+            glFinish();
+            double seconds = secondsSince(frameStart);
+            if(packet.entry == GL_CAPTURE_STARTUP)
+                startupTime = seconds;
+            else
+                frameTimes.push_back(seconds);
+            GLenum error = glGetError();
+            if(error != GL_NO_ERROR && frameErrors++ < 8)
+                std::cout << "ERROR::GLREPLAY::GL error 0x" << std::hex << error << std::dec << " in frame " << frameTimes.size() << std::endl;
+            frameStart = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        makeCurrent(packet.thread);
+        if(packet.entry == GL_CAPTURE_MAPPED_WRITE)
+        {
+            replayMappedWrite(slots);
+            continue;
+        }
+        if(packet.entry >= header.entryCount || !handlers[packet.entry])
+        {
+            std::cout << "ERROR::GLREPLAY::Unknown entry point " << packet.entry << ", stopping" << std::endl;
+            break;
+        }
+
+        for(size_t a = 0; a < nameArguments[packet.entry].size(); a++)
+        {
+            uint64_t &slot = slots[nameArguments[packet.entry][a].first];
+            slot = translateName(nameArguments[packet.entry][a].second, slot);
+        }
+        if(uniformCalls[packet.entry])
+            slots[0] = translateLocation(false, currentPrograms[currentThread], slots[0]);
+        else if(localEntries[packet.entry] == REPLAY_glUniformBlockBinding)
+            slots[1] = translateLocation(true, (GLuint)slots[0], slots[1]);
+
+        auto callStart = std::chrono::steady_clock::now();
+        handlers[packet.entry](slots, packet.blobs);
+        if(finishCalls)
+            glFinish();
+        EntryTiming &timing = timings[packet.entry];
+        timing.seconds += secondsSince(callStart);
+        timing.calls++;
+        if(checkErrors)
+        {
+            GLenum error = glGetError();
+            if(error != GL_NO_ERROR && timing.errors++ == 0)
+                std::cout << "ERROR::GLREPLAY::" << REPLAY_NAMES[localEntries[packet.entry]] << " raised 0x" << std::hex << error << std::dec << std::endl;
+        }
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "GLREPLAY:: startup %.2f ms, %zu frames on %zu contexts", startupTime * 1000.0, frameTimes.size(), contexts.size());
+    std::cout << line << std::endl;
+    if(!frameTimes.empty())
+    {
+        std::vector<double> sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for(size_t i = 0; i < sorted.size(); i++)
+            total += sorted[i];
+        snprintf(line, sizeof(line), "GLREPLAY:: frame %.3f ms average, %.3f ms median, %.3f ms min, %.3f ms max",
+                 total * 1000.0 / sorted.size(), sorted[sorted.size() / 2] * 1000.0, sorted.front() * 1000.0, sorted.back() * 1000.0);
+        std::cout << line << std::endl;
+    }
+
+    std::vector<uint32_t> entries;
+    for(uint32_t i = 0; i < header.entryCount; i++)
+    {
+        if(timings[i].calls)
+            entries.push_back(i);
+    }
+    std::sort(entries.begin(), entries.end(), [&](uint32_t a, uint32_t b) { return timings[a].seconds > timings[b].seconds; });
+    snprintf(line, sizeof(line), "GLREPLAY:: %10s %12s %10s  %s", "calls", "total ms", "us/call", "entry point");
+    std::cout << line << std::endl;
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        const EntryTiming &timing = timings[entries[i]];
+        snprintf(line, sizeof(line), "GLREPLAY:: %10llu %12.3f %10.2f  %s%s", (unsigned long long)timing.calls, timing.seconds * 1000.0,
+                 timing.seconds * 1e6 / timing.calls, REPLAY_NAMES[localEntries[entries[i]]], timing.errors ? "  (errors)" : "");
+        std::cout << line << std::endl;
+    }
+
+    for(size_t i = 0; i < contexts.size(); i++)
+        eglDestroyContext(display, contexts[i]);
+    eglTerminate(display);
+    return 0;
+}
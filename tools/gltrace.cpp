@@ -0,0 +1,180 @@
+// GL trace summarizer: reads a call stream written with ASTEROID_GL_TRACE=<file>
+// (see GLTrace) and reports frame times, per entry point call counts and
+// which calls the slowest frames make more of than the rest, to tie frame
+// time to API usage.
+//
+//   gltrace [-s slow%] trace.bin
+
+#include "gl_trace.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+struct TracedFrame {
+    uint64_t microseconds = 0;
+    uint64_t calls = 0;
+    uint64_t draws = 0;
+    uint64_t triangles = 0;
+    std::vector<std::pair<uint16_t, uint32_t>> entries;
+};
+
+struct EntryTotal {
+    uint64_t calls = 0;
+    uint64_t value = 0;
+    uint64_t frameCalls = 0;
+    uint64_t slowCalls = 0;
+};
+
+static bool isDraw(const std::string &name)
+{
+    return (name.compare(0, 6, "glDraw") == 0 && name.compare(0, 12, "glDrawBuffer") != 0) || name.compare(0, 11, "glMultiDraw") == 0;
+}
+
+int main(int argc, char **argv)
+{
+    double slowPercent = 10.0;
+    std::string path;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "-s" && i + 1 < argc)
+            slowPercent = std::atof(argv[++i]);
+        else
+            path = arg;
+    }
+    if(path.empty())
+    {
+        std::cout << "usage: gltrace [-s slow%] trace.bin" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    GLTraceHeader header;
+    if(!file.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, GL_TRACE_MAGIC, sizeof(header.magic)) != 0
+       || header.version != GL_TRACE_VERSION)
+    {
+        std::cout << "ERROR::GLTRACE::Not a GL trace: " << path << std::endl;
+        return 1;
+    }
+    std::vector<std::string> names(header.entryCount);
+    for(uint32_t i = 0; i < header.entryCount; i++)
+        std::getline(file, names[i], '\0');
+
+    std::vector<EntryTotal> totals(header.entryCount);
+    std::vector<TracedFrame> frames;
+    std::vector<uint32_t> counts(header.entryCount, 0);
+    TracedFrame current;
+    TracedFrame startup;
+    uint16_t threads = 0;
+    GLTraceRecord record;
+    while(file.read((char*)&record, sizeof(record)))
+    {
+        if(record.entry == GL_TRACE_FRAME || record.entry == GL_TRACE_STARTUP)
+        {
+            current.microseconds = record.value;
+            for(uint32_t i = 0; i < header.entryCount; i++)
+            {
+                if(counts[i])
+                    current.entries.push_back(std::make_pair((uint16_t)i, counts[i]));
+            }
+            std::fill(counts.begin(), counts.end(), 0);
+            if(record.entry == GL_TRACE_STARTUP)
+                startup = current;
+            else
+                frames.push_back(current);
+            current = TracedFrame();
+            continue;
+        }
+        if(record.entry >= header.entryCount)
+        {
+            std::cout << "ERROR::GLTRACE::Bad record for entry " << record.entry << ", stopping" << std::endl;
+            break;
+        }
+        threads = std::max<uint16_t>(threads, record.thread + 1);
+        counts[record.entry]++;
+        current.calls++;
+        totals[record.entry].calls++;
+        totals[record.entry].value += record.value;
+        if(isDraw(names[record.entry]))
+        {
+            current.draws++;
+            current.triangles += record.value;
+        }
+    }
+
+    std::cout << "GLTRACE:: " << path << ": " << frames.size() << " frames on " << threads << " threads, "
+              << startup.calls << " startup calls in " << startup.microseconds / 1000.0 << " ms" << std::endl;
+    if(frames.empty())
+        return 0;
+
+    // slowest frames first
+    std::vector<size_t> order(frames.size());
+    for(size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return frames[a].microseconds > frames[b].microseconds; });
+    size_t slowCount = std::max<size_t>(1, (size_t)(frames.size() * slowPercent / 100.0));
+    slowCount = std::min(slowCount, frames.size());
+
+    uint64_t totalTime = 0;
+    uint64_t slowTime = 0;
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        const TracedFrame &frame = frames[order[i]];
+        totalTime += frame.microseconds;
+        if(i < slowCount)
+            slowTime += frame.microseconds;
+        for(size_t e = 0; e < frame.entries.size(); e++)
+        {
+            EntryTotal &total = totals[frame.entries[e].first];
+            total.frameCalls += frame.entries[e].second;
+            if(i < slowCount)
+                total.slowCalls += frame.entries[e].second;
+        }
+    }
+    size_t restCount = frames.size() - slowCount;
+
+    char line[256];
+    snprintf(line, sizeof(line), "GLTRACE:: frame time %.3f ms average, %.3f ms median, %.3f ms peak; slowest %zu frames average %.3f ms",
+             totalTime / 1000.0 / frames.size(), frames[order[order.size() / 2]].microseconds / 1000.0,
+             frames[order[0]].microseconds / 1000.0, slowCount, slowTime / 1000.0 / slowCount);
+    std::cout << line << std::endl;
+
+    std::cout << "GLTRACE:: slowest frames" << std::endl;
+    for(size_t i = 0; i < slowCount && i < 8; i++)
+    {
+        const TracedFrame &frame = frames[order[i]];
+        snprintf(line, sizeof(line), "GLTRACE::   frame %6zu %9.3f ms %8llu calls %6llu draws %10llu triangles",
+                 order[i], frame.microseconds / 1000.0, (unsigned long long)frame.calls,
+                 (unsigned long long)frame.draws, (unsigned long long)frame.triangles);
+        std::cout << line << std::endl;
+    }
+
+    // calls per frame overall and in slow versus other frames; a large
+    // difference points at the API usage that costs the time
+    std::vector<uint32_t> entries;
+    for(uint32_t i = 0; i < header.entryCount; i++)
+    {
+        if(totals[i].calls)
+            entries.push_back(i);
+    }
+    std::sort(entries.begin(), entries.end(), [&](uint32_t a, uint32_t b) { return totals[a].calls > totals[b].calls; });
+    snprintf(line, sizeof(line), "GLTRACE:: %12s %10s %10s %10s %14s  %s", "calls", "per frame", "slow", "other", "value", "entry point");
+    std::cout << line << std::endl;
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        const EntryTotal &total = totals[entries[i]];
+        double slow = (double)total.slowCalls / slowCount;
+        double other = restCount ? (double)(total.frameCalls - total.slowCalls) / restCount : 0.0;
+        snprintf(line, sizeof(line), "GLTRACE:: %12llu %10.1f %10.1f %10.1f %14llu  %s",
+                 (unsigned long long)total.calls, (double)total.frameCalls / frames.size(), slow, other,
+                 (unsigned long long)total.value, names[entries[i]].c_str());
+        std::cout << line << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Offline texture baker: writes "<image>.ktx" next to each source image with
+// a gamma-correct mip chain compressed to BC1, BC3 or BC7. TextureCache picks
+// the baked file up on the next run instead of decoding the image.
+//
+//   texbake [--bc1 | --bc3 | --bc7] [--no-flip] [--threads N] image...
+
+#include "texture_bake.h"
+#include "thread_pool.h"
+#include "stb_image.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+int main(int argc, char **argv)
+{
+    BakeFormat format = BAKE_AUTO;
+    bool flip = true;
+    unsigned threads = ThreadPool::defaultThreadCount();
+    std::vector<std::string> images;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--bc1")
+            format = BAKE_BC1;
+        else if(arg == "--bc3")
+            format = BAKE_BC3;
+        else if(arg == "--bc7")
+            format = BAKE_BC7;
+        else if(arg == "--no-flip")
+            flip = false;
+        else if(arg == "--threads" && i + 1 < argc)
+            threads = (unsigned)std::atoi(argv[++i]);
+        else
+            images.push_back(arg);
+    }
+    if(images.empty())
+    {
+        std::cout << "usage: texbake [--bc1 | --bc3 | --bc7] [--no-flip] [--threads N] image..." << std::endl;
+        return 1;
+    }
+
+    // the application loads with a vertical flip, the baked data has to match
+    stbi_set_flip_vertically_on_load(flip);
+    ThreadPool pool(threads);
+
+    int failures = 0;
+    for(GLuint i = 0; i < images.size(); i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int width, height, nrChannels;
+        unsigned char *data = stbi_load(images[i].c_str(), &width, &height, &nrChannels, 4);
+        if(!data)
+        {
+            std::cout << "ERROR::TEXBAKE::Failed to load " << images[i] << std::endl;
+            failures++;
+            continue;
+        }
+
+        BakedTexture baked;
+        bakeTexture(data, width, height, format, &pool, baked);
+        stbi_image_free(data);
+
+        std::string output = bakedTexturePath(images[i]);
+        if(!writeKTX(output, baked, flip))
+        {
+            std::cout << "ERROR::TEXBAKE::Failed to write " << output << std::endl;
+            failures++;
+            continue;
+        }
+
+        size_t compressedSize = 0;
+        for(GLuint level = 0; level < baked.levels.size(); level++)
+            compressedSize += baked.levels[level].data.size();
+        size_t uncompressedSize = (size_t)width * height * nrChannels * 4 / 3;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << output << ": " << width << "x" << height << ", " << baked.levels.size() << " levels, "
+                  << uncompressedSize / 1024 << " KiB -> " << compressedSize / 1024 << " KiB in " << ms << " ms" << std::endl;
+    }
+    return failures ? 1 : 0;
+}